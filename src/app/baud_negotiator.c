@@ -0,0 +1,91 @@
+#include "baud_negotiator.h"
+
+#include <stdio.h>  // snprintf
+
+static void send_status(baud_negotiator_t* n, const char* what, uint32_t baud)
+{
+    char line[32];
+    snprintf(line, sizeof(line), "BAUD %s %lu\n", what, (unsigned long)baud);
+    n->ops.send(n->ops.ctx, line);
+}
+
+// deadline 以 32-bit ms 計時，使用差值比較以容忍溢位
+static inline bool time_reached(uint32_t now_ms, uint32_t deadline_ms)
+{
+    return (int32_t)(now_ms - deadline_ms) >= 0;
+}
+
+void BaudNeg_Init(baud_negotiator_t* n, const baud_link_ops_t* ops, uint32_t baud,
+                  uint32_t timeout_ms)
+{
+    n->ops = *ops;
+    n->state = BAUD_NEG_IDLE;
+    n->baud = baud;
+    n->pending_baud = 0;
+    n->prev_baud = baud;
+    n->deadline_ms = 0;
+    n->timeout_ms = timeout_ms;
+}
+
+bool BaudNeg_Request(baud_negotiator_t* n, uint32_t baud, uint32_t now_ms)
+{
+    // 協商中不接受新的請求；速率合法性由 set_baud 在切換時再確認一次
+    if (n->state != BAUD_NEG_IDLE || baud == 0)
+    {
+        n->ops.send(n->ops.ctx, "BAUD NAK\n");
+        return false;
+    }
+
+    // ACK 在舊速率送出，等它完全離開 TX 才能切換
+    send_status(n, "ACK", baud);
+    n->pending_baud = baud;
+    n->prev_baud = n->baud;
+    n->state = BAUD_NEG_DRAINING;
+    n->deadline_ms = now_ms + n->timeout_ms;
+    return true;
+}
+
+void BaudNeg_Confirm(baud_negotiator_t* n, uint32_t now_ms)
+{
+    (void)now_ms;
+    if (n->state != BAUD_NEG_AWAIT_CONFIRM) return;
+
+    n->state = BAUD_NEG_IDLE;
+    send_status(n, "LOCKED", n->baud);
+}
+
+void BaudNeg_Poll(baud_negotiator_t* n, uint32_t now_ms)
+{
+    if (n->state == BAUD_NEG_DRAINING)
+    {
+        if (n->ops.tx_idle(n->ops.ctx))
+        {
+            uint32_t actual = n->ops.set_baud(n->ops.ctx, n->pending_baud);
+            if (actual == 0)
+            {
+                // 硬體不支援：速率沒變，直接在舊速率回報
+                n->state = BAUD_NEG_IDLE;
+                n->ops.send(n->ops.ctx, "BAUD NAK\n");
+                return;
+            }
+            n->baud = actual;
+            n->state = BAUD_NEG_AWAIT_CONFIRM;
+            n->deadline_ms = now_ms + n->timeout_ms;
+        }
+        else if (time_reached(now_ms, n->deadline_ms))
+        {
+            // TX 一直送不完 (例如流量控制卡住)：放棄切換，仍在舊速率
+            n->state = BAUD_NEG_IDLE;
+            n->ops.send(n->ops.ctx, "BAUD NAK\n");
+        }
+        return;
+    }
+
+    if (n->state == BAUD_NEG_AWAIT_CONFIRM && time_reached(now_ms, n->deadline_ms))
+    {
+        // 對端沒有跟上：退回舊速率，讓雙方回到可溝通的狀態
+        n->baud = n->ops.set_baud(n->ops.ctx, n->prev_baud);
+        n->state = BAUD_NEG_IDLE;
+        send_status(n, "REVERT", n->baud);
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef BAUD_NEGOTIATOR_H
+#define BAUD_NEGOTIATOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ==========================================
+// Baud 協商 (BAUD <rate> 指令)
+// ==========================================
+// 1. 對端在舊速率送 "BAUD <rate>"
+// 2. 本端回 "BAUD ACK <rate>"，等 TX 送完後切換到新速率
+// 3. 對端收到 ACK 後也切換，並在新速率送 "BAUD OK"
+// 4. 本端回 "BAUD LOCKED <rate>" 完成；逾時沒收到確認則退回舊速率並送 "BAUD REVERT <rate>"
+
+// 預設確認逾時 (ms)
+#define BAUD_NEG_TIMEOUT_MS 1000
+
+// 硬體介面 (由 main 綁定到實際的 UART driver，測試時綁定到模擬 link)
+typedef struct
+{
+    uint32_t (*set_baud)(void* ctx, uint32_t baud);  // 回傳實際 baud，0 = 不支援
+    bool (*tx_idle)(void* ctx);                      // TX 是否已完全送出
+    void (*send)(void* ctx, const char* line);       // 送出一行回應 (含換行)
+    void* ctx;
+} baud_link_ops_t;
+
+typedef enum
+{
+    BAUD_NEG_IDLE = 0,       // 正常運作
+    BAUD_NEG_DRAINING,       // 已回 ACK，等 TX 送完再切換
+    BAUD_NEG_AWAIT_CONFIRM   // 已切到新速率，等對端 "BAUD OK"
+} baud_neg_state_t;
+
+typedef struct
+{
+    baud_link_ops_t ops;
+    baud_neg_state_t state;
+    uint32_t baud;          // 目前生效的 baud
+    uint32_t pending_baud;  // 協商中的新 baud
+    uint32_t prev_baud;     // 逾時時退回的 baud
+    uint32_t deadline_ms;   // 目前階段的逾時時間點
+    uint32_t timeout_ms;
+} baud_negotiator_t;
+
+/**
+ * @brief 初始化協商器
+ * @param baud 目前 link 的 baud
+ * @param timeout_ms 等待 TX 清空與等待確認各自的逾時
+ */
+void BaudNeg_Init(baud_negotiator_t* n, const baud_link_ops_t* ops, uint32_t baud,
+                  uint32_t timeout_ms);
+
+/**
+ * @brief 處理 CMD_SET_BAUD：回 ACK 並開始協商 (協商中或速率不支援則回 NAK)
+ * @return true 已接受
+ */
+bool BaudNeg_Request(baud_negotiator_t* n, uint32_t baud, uint32_t now_ms);
+
+/**
+ * @brief 處理 CMD_BAUD_CONFIRM：在新速率下收到確認 → 鎖定
+ */
+void BaudNeg_Confirm(baud_negotiator_t* n, uint32_t now_ms);
+
+/**
+ * @brief 主迴圈定期呼叫：TX 清空後切換速率、處理逾時
+ */
+void BaudNeg_Poll(baud_negotiator_t* n, uint32_t now_ms);
+
+#endif  // BAUD_NEGOTIATOR_H
@@ -1,6 +1,6 @@
 #include "sentinel_core.h"
 
-#include <string.h>  // ✨ 新增：為了支援 strcmp
+#include <string.h>  // ✨ 新增：為了支援 memcmp / memchr
 
 // ==========================================
 // 模組 A：系統電壓監控 (原本的設定)
@@ -27,43 +27,231 @@ void sentinel_init(void)
 // ==========================================
 // 模組 B：指令解析狀態機 (新增)
 // ==========================================
-// 將 Buffer 定義為 static，確保狀態在多次呼叫間得以保留，且不被外部檔案直接存取
-static char cmd_buffer[16];
-static uint8_t cmd_idx = 0;
+// 解析狀態都放在呼叫端的 sentinel_parser_t；這裡只剩唯讀的指令表與 hash index
+// 指令表：由 SENTINEL_CMD_TABLE 在編譯期展開 (index = SystemCmd_t)
+#define SENTINEL_CMD_INFO(id, name, schema, handler, help) \
+    [id] = {name, schema, help, (uint8_t)(sizeof(name) - 1)},
+static const sentinel_cmd_info_t k_cmds[CMD_COUNT] = {SENTINEL_CMD_TABLE(SENTINEL_CMD_INFO)};
+#undef SENTINEL_CMD_INFO
 
-SystemCmd_t Sentinel_ParseChar(char c)
+// 編譯期檢查：名稱放得進 line buffer、參數個數不超過 SENTINEL_MAX_ARGS
+#define SENTINEL_CMD_CHECK(id, name, schema, handler, help)                       \
+    _Static_assert(sizeof(name) < SENTINEL_LINE_MAX, #id ": name too long");      \
+    _Static_assert(sizeof(schema) - 1 <= SENTINEL_MAX_ARGS, #id ": too many args");
+SENTINEL_CMD_TABLE(SENTINEL_CMD_CHECK)
+#undef SENTINEL_CMD_CHECK
+
+// 名稱 → 指令的 hash index (open addressing, linear probing)，裝載率保持在 1/2 以下
+#define CMD_HASH_SLOTS 64u
+_Static_assert(CMD_COUNT <= CMD_HASH_SLOTS / 2, "grow CMD_HASH_SLOTS");
+_Static_assert((CMD_HASH_SLOTS & (CMD_HASH_SLOTS - 1u)) == 0, "CMD_HASH_SLOTS: power of 2");
+_Static_assert(CMD_COUNT <= UINT8_MAX, "index stores SystemCmd_t as uint8_t");
+
+static uint8_t cmd_index[CMD_HASH_SLOTS];  // 0 (CMD_NONE) = 空 slot
+static bool cmd_index_ready = false;
+
+// FNV-1a
+static uint32_t cmd_hash(const char* s, size_t n)
 {
-    // 遇到換行符號 (\n 或 \r)，代表指令輸入完畢，開始解析
-    if (c == '\n' || c == '\r')
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < n; i++)
+    {
+        h = (h ^ (uint8_t)s[i]) * 16777619u;
+    }
+    return h;
+}
+
+// C 的常數運算式無法取字串常值的內容，因此 index 由 const 指令表建好
+// (Sentinel_ParserInit 時建立；lookup 的檢查只是保險)
+static void build_index(void)
+{
+    for (uint32_t cmd = CMD_NONE + 1; cmd < CMD_COUNT; cmd++)
     {
-        cmd_buffer[cmd_idx] = '\0';  // 補上 C 語言字串結尾
-        SystemCmd_t result = CMD_NONE;
+        uint32_t slot = cmd_hash(k_cmds[cmd].name, k_cmds[cmd].name_len);
+        while (cmd_index[slot & (CMD_HASH_SLOTS - 1u)] != CMD_NONE) slot++;
+        cmd_index[slot & (CMD_HASH_SLOTS - 1u)] = (uint8_t)cmd;
+    }
+    cmd_index_ready = true;
+}
 
-        // 核心邏輯：字串比對
-        if (strcmp(cmd_buffer, "INV") == 0)
+static SystemCmd_t lookup(const char* name, size_t n)
+{
+    if (!cmd_index_ready) build_index();
+
+    for (uint32_t slot = cmd_hash(name, n);; slot++)
+    {
+        uint8_t cmd = cmd_index[slot & (CMD_HASH_SLOTS - 1u)];
+        if (cmd == CMD_NONE) return CMD_NONE;
+        if (k_cmds[cmd].name_len == n && memcmp(k_cmds[cmd].name, name, n) == 0)
         {
-            result = CMD_OLED_INVERT;
+            return (SystemCmd_t)cmd;
         }
-        else if (strcmp(cmd_buffer, "NORM") == 0)
+    }
+}
+
+// 解析十進位參數：必須全為數字、非空且不溢位
+static bool parse_u32(const char* s, uint32_t* out)
+{
+    uint32_t v = 0;
+    if (*s == '\0') return false;
+    for (; *s; s++)
+    {
+        if (*s < '0' || *s > '9') return false;
+        uint32_t d = (uint32_t)(*s - '0');
+        if (v > (UINT32_MAX - d) / 10) return false;
+        v = v * 10 + d;
+    }
+    *out = v;
+    return true;
+}
+
+// 依 schema 切出參數 (就地把空白改成 '\0')；個數必須剛好符合
+static bool parse_args(char* s, const char* schema, sentinel_args_t* out)
+{
+    out->argc = 0;
+    for (;;)
+    {
+        while (*s == ' ') s++;
+        if (*s == '\0') break;
+
+        char* tok = s;
+        while (*s != ' ' && *s != '\0') s++;
+        if (*s == ' ') *s++ = '\0';
+
+        char kind = schema[out->argc];
+        if (kind == 'u')
         {
-            result = CMD_OLED_NORMAL;
+            if (!parse_u32(tok, &out->num[out->argc])) return false;
         }
-        else if (strcmp(cmd_buffer, "PING") == 0)
+        else if (kind == 't')
         {
-            result = CMD_SYSTEM_PING;
+            out->tok[out->argc] = tok;
         }
+        else
+        {
+            return false;  // 參數比 schema 多
+        }
+        out->argc++;
+    }
+    return schema[out->argc] == '\0';
+}
+
+// 一行結束：查指令表並解析參數，並重置 index 準備接收下一道指令
+static SystemCmd_t finish_line(sentinel_parser_t* p)
+{
+    size_t len = p->idx;
+    p->buf[len] = '\0';  // 補上 C 語言字串結尾
+    p->idx = 0;
 
-        // 解析完畢後重置 index，準備接收下一道指令
-        cmd_idx = 0;
-        return result;
+    // 超長的行：截斷後的參數 (ECHO 文字、BAUD 數字) 已不是原意，整行拒絕
+    if (p->overflowed)
+    {
+        p->overflowed = false;
+        return CMD_NONE;
     }
 
-    // 如果還不是換行符號，就把字元存起來 (並防止 Buffer Overflow)
-    if (cmd_idx < sizeof(cmd_buffer) - 1)
+    // 1. 整行就是指令名稱 (不帶參數，名稱可含空白)
+    SystemCmd_t cmd = lookup(p->buf, len);
+    if (cmd != CMD_NONE)
     {
-        cmd_buffer[cmd_idx++] = c;
+        if (k_cmds[cmd].schema[0] != '\0') return CMD_NONE;  // 缺參數
+        p->last.id = cmd;
+        p->last.args.argc = 0;
+        return cmd;
     }
 
+    // 2. 第一個字是指令名稱，其餘依 schema 解析
+    const char* sp = memchr(p->buf, ' ', len);
+    if (sp == NULL) return CMD_NONE;
+    cmd = lookup(p->buf, (size_t)(sp - p->buf));
+    if (cmd == CMD_NONE) return CMD_NONE;
+
+    sentinel_args_t args;
+    if (!parse_args(&p->buf[sp - p->buf + 1], k_cmds[cmd].schema, &args)) return CMD_NONE;
+    p->last.id = cmd;
+    p->last.args = args;
+    return cmd;
+}
+
+// 把一段不含換行的字元接到 line buffer (超出長度時標記整行無效，與逐字元版本相同)
+static void append_chars(sentinel_parser_t* p, const char* s, size_t n)
+{
+    size_t room = sizeof(p->buf) - 1 - p->idx;
+    if (n > room)
+    {
+        p->overflowed = true;
+        n = room;
+    }
+    memcpy(&p->buf[p->idx], s, n);
+    p->idx = (uint8_t)(p->idx + n);
+}
+
+void Sentinel_ParserInit(sentinel_parser_t* p, uint8_t channel)
+{
+    if (!cmd_index_ready) build_index();
+
+    memset(p, 0, sizeof(*p));
+    p->last.channel = channel;
+}
+
+SystemCmd_t Sentinel_ParseChar(sentinel_parser_t* p, char c)
+{
+    // 遇到換行符號 (\n 或 \r)，代表指令輸入完畢，開始解析
+    if (c == '\n' || c == '\r')
+    {
+        return finish_line(p);
+    }
+
+    // 如果還不是換行符號，就把字元存起來 (並防止 Buffer Overflow)
+    append_chars(p, &c, 1);
+
     // 指令還沒湊齊，回傳 CMD_NONE 告訴主程式繼續等
     return CMD_NONE;
-}
\ No newline at end of file
+}
+
+size_t Sentinel_ParseBuffer(sentinel_parser_t* p, const char* data, size_t len,
+                            sentinel_cmd_cb_t on_cmd, void* ctx)
+{
+    size_t count = 0;
+    const char* end = data + len;
+
+    while (data < end)
+    {
+        // 下一個換行：先找 \n，再只在它之前找 \r (每個 byte 最多被掃兩次)
+        size_t n = (size_t)(end - data);
+        const char* eol = memchr(data, '\n', n);
+        const char* cr = memchr(data, '\r', eol ? (size_t)(eol - data) : n);
+        if (cr) eol = cr;
+
+        if (eol == NULL)
+        {
+            append_chars(p, data, n);  // 沒有換行：留到下一段資料
+            break;
+        }
+
+        append_chars(p, data, (size_t)(eol - data));
+        if (finish_line(p) != CMD_NONE)
+        {
+            count++;
+            if (on_cmd) on_cmd(ctx, &p->last);
+        }
+        data = eol + 1;
+    }
+    return count;
+}
+
+void Sentinel_ParserDiscardLine(sentinel_parser_t* p)
+{
+    p->overflowed = true;
+}
+
+const sentinel_cmd_info_t* Sentinel_CmdInfo(SystemCmd_t cmd)
+{
+    if (cmd <= CMD_NONE || cmd >= CMD_COUNT) return NULL;
+    return &k_cmds[cmd];
+}
+
+const sentinel_cmd_t* Sentinel_LastCmd(const sentinel_parser_t* p)
+{
+    return &p->last;
+}
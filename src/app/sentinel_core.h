@@ -2,6 +2,7 @@
 #define SENTINEL_CORE_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 // ==========================================
@@ -20,19 +21,134 @@ void sentinel_init(void);
 // ==========================================
 // 模組 B：系統指令解析器 (Day 6~9 整合新增)
 // ==========================================
+#define SENTINEL_LINE_MAX 32  // 一行指令 (含參數) 的最大長度，超過的行整行丟棄
+#define SENTINEL_MAX_ARGS 4   // 每個指令最多幾個參數
+
+/**
+ * @brief 指令表 (X-macro)：新增指令只要在這裡加一行
+ * @details X(id, 名稱, 參數格式, handler, 說明)
+ *          - 名稱：不帶參數的指令可以含空白 (例如 "BAUD OK")；帶參數的指令名稱必須是單一個字
+ *          - 參數格式：每個字元一個參數，'u' = 十進位 uint32、't' = 不含空白的 token
+ *          - handler：只有應用層 (main.c) 展開這一欄，核心層不會引用到這個符號
+ */
+#define SENTINEL_CMD_TABLE(X)                                                          \
+    X(CMD_OLED_NORMAL, "NORM", "", Cmd_OledNormal, "OLED normal video")                \
+    X(CMD_OLED_INVERT, "INV", "", Cmd_OledInvert, "OLED inverse video")                \
+    X(CMD_SYSTEM_PING, "PING", "", Cmd_Ping, "Uptime and UART error counters")         \
+    X(CMD_SET_BAUD, "BAUD", "u", Cmd_SetBaud, "Negotiate a new UART baud rate")        \
+    X(CMD_BAUD_CONFIRM, "BAUD OK", "", Cmd_BaudConfirm, "Peer confirms the new rate")  \
+    X(CMD_ECHO, "ECHO", "t", Cmd_Echo, "Echo a token back (link check)")               \
+    X(CMD_BULK, "BULK", "u", Cmd_Bulk, "Stream n test bytes as DATA frames (framed)")  \
+    X(CMD_HELP, "HELP", "", Cmd_Help, "List all commands")
+
+#define SENTINEL_CMD_ENUM(id, name, schema, handler, help) id,
 typedef enum
 {
     CMD_NONE = 0,
-    CMD_OLED_NORMAL,
-    CMD_OLED_INVERT,
-    CMD_SYSTEM_PING
+    SENTINEL_CMD_TABLE(SENTINEL_CMD_ENUM)  // CMD_OLED_NORMAL, CMD_OLED_INVERT, ...
+    CMD_COUNT
 } SystemCmd_t;
+#undef SENTINEL_CMD_ENUM
+
+/**
+ * @brief 解析出的參數：第 i 個參數依指令表的 schema[i] 放在 num[i] 或 tok[i]
+ * @note tok 指向解析器內部的 line buffer，只在 callback 內 (或下一個字元送進來之前) 有效
+ */
+typedef struct
+{
+    uint8_t argc;
+    uint32_t num[SENTINEL_MAX_ARGS];     // 'u'
+    const char* tok[SENTINEL_MAX_ARGS];  // 't'
+} sentinel_args_t;
+
+/**
+ * @brief 指令表中的一筆 (名稱 / 參數格式 / 說明)，給 HELP 之類的功能列舉
+ */
+typedef struct
+{
+    const char* name;
+    const char* schema;
+    const char* help;
+    uint8_t name_len;
+} sentinel_cmd_info_t;
+
+/**
+ * @brief 一個解析完成的指令：帶著產生它的 channel，回應才能送回同一條 link
+ */
+typedef struct
+{
+    SystemCmd_t id;
+    uint8_t channel;  // Sentinel_ParserInit 時指定 (由應用層定義編號)
+    bool framed;      // 來自二進位 frame (sentinel_frame.h)：回應也要包成 frame
+    uint8_t seq;      // framed 時為請求 frame 的序號，回應帶回同一個序號
+    sentinel_args_t args;
+} sentinel_cmd_t;
+
+/**
+ * @brief 解析器 context：每個輸入來源 (USB / UART / ...) 各一個，彼此狀態獨立
+ * @note 內容視為 private，只透過 Sentinel_Parse* 操作
+ */
+typedef struct
+{
+    char buf[SENTINEL_LINE_MAX];
+    uint8_t idx;
+    bool overflowed;      // 這一行超過 SENTINEL_LINE_MAX (或被丟棄)：換行時整行丟棄
+    sentinel_cmd_t last;  // 上一個解析成功的指令 (args.tok 指向 buf)
+} sentinel_parser_t;
+
+/**
+ * @brief 應用層的指令 handler：由 SENTINEL_CMD_TABLE 的 handler 欄展開成分派表
+ * @return false = 指令被拒絕 (frame 請求會回報錯誤狀態)
+ */
+typedef bool (*sentinel_cmd_handler_t)(void* ctx, const sentinel_cmd_t* cmd);
+
+/**
+ * @brief 查詢指令表
+ * @return cmd 對應的那一筆；CMD_NONE 或超出範圍回傳 NULL
+ */
+const sentinel_cmd_info_t* Sentinel_CmdInfo(SystemCmd_t cmd);
+
+/**
+ * @brief 初始化一個解析器 context
+ * @param channel 寫進每個解析結果的 sentinel_cmd_t.channel
+ */
+void Sentinel_ParserInit(sentinel_parser_t* p, uint8_t channel);
 
 /**
  * @brief 狀態機：逐字元解析系統指令
+ * @details 一行結束時以 hash 查指令表 (與指令數量無關)，再依參數格式解析參數；
+ *          參數個數或格式不符的行視為無效。
  * @param c 傳入單一字元
- * @return SystemCmd_t 解析完成的指令 (若尚未湊齊換行符號則回傳 CMD_NONE)
+ * @return SystemCmd_t 解析完成的指令 (若尚未湊齊換行符號則回傳 CMD_NONE)，
+ *         完整結果由 Sentinel_LastCmd() 取得
+ */
+SystemCmd_t Sentinel_ParseChar(sentinel_parser_t* p, char c);
+
+/**
+ * @brief Sentinel_ParseBuffer 每解析出一個指令就呼叫一次
+ * @param cmd 只在 callback 內有效 (同 Sentinel_LastCmd())
+ */
+typedef void (*sentinel_cmd_cb_t)(void* ctx, const sentinel_cmd_t* cmd);
+
+/**
+ * @brief 一次解析一整段資料 (例如 DMA / ring buffer 讀出的 span)
+ * @details 以 memchr 找換行，行與行之間整段複製，不逐字元呼叫；
+ *          與 Sentinel_ParseChar 共用同一個 context，未完成的行留到下一次呼叫。
+ * @param ctx 原封不動傳給 on_cmd
+ * @return 這段資料中解析出的指令數 (不含 CMD_NONE)
+ */
+size_t Sentinel_ParseBuffer(sentinel_parser_t* p, const char* data, size_t len,
+                            sentinel_cmd_cb_t on_cmd, void* ctx);
+
+/**
+ * @brief 丟棄目前這一行：到下一個換行為止收到的字元都不會被執行
+ * @note  Link 的 frame 中途失敗而回到文字模式時使用 (接下來是半個 frame，不是指令)
+ */
+void Sentinel_ParserDiscardLine(sentinel_parser_t* p);
+
+/**
+ * @brief 取得這個 context 上一個解析成功的指令 (例如 BAUD 921600 → args.num[0] = 921600)
  */
-SystemCmd_t Sentinel_ParseChar(char c);
+const sentinel_cmd_t* Sentinel_LastCmd(const sentinel_parser_t* p);
 
 #endif  // SENTINEL_CORE_H
\ No newline at end of file
@@ -0,0 +1,216 @@
+#include "sentinel_frame.h"
+
+#include <string.h>
+
+// ==========================================
+// 1. CRC-16/CCITT-FALSE
+// ==========================================
+static const uint16_t k_crc16_table[256] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+    0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+    0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+    0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+    0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+    0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+    0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+    0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+    0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+    0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+    0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+    0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+    0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+    0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+    0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+    0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+    0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+    0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+    0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+    0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+    0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+    0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+    0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+    0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+    0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+    0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+    0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+    0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+    0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+    0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0,
+};
+
+uint16_t SentinelFrame_Crc16(const uint8_t* data, size_t len)
+{
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++)
+    {
+        crc = (uint16_t)((crc << 8) ^ k_crc16_table[(uint8_t)((crc >> 8) ^ data[i])]);
+    }
+    return crc;
+}
+
+// ==========================================
+// 2. Encoder (TX)
+// ==========================================
+size_t SentinelFrame_Encode(uint8_t type, uint8_t seq, const void* payload, size_t len,
+                            uint8_t* out, size_t cap)
+{
+    if (len > SENTINEL_FRAME_PAYLOAD_MAX) return 0;
+
+    uint8_t raw[SENTINEL_FRAME_RAW_MAX];
+    raw[0] = type;
+    raw[1] = seq;
+    if (len > 0) memcpy(&raw[SENTINEL_FRAME_HEADER], payload, len);
+    size_t n = SENTINEL_FRAME_HEADER + len;
+    uint16_t crc = SentinelFrame_Crc16(raw, n);
+    raw[n++] = (uint8_t)(crc & 0xFF);
+    raw[n++] = (uint8_t)(crc >> 8);
+
+    if (cap < 2) return 0;
+    size_t enc = cobs_encode(raw, n, &out[1], cap - 2);
+    if (enc == 0) return 0;
+    out[0] = COBS_DELIM;
+    out[1 + enc] = COBS_DELIM;
+    return enc + 2;
+}
+
+// ==========================================
+// 3. CMD payload → sentinel_cmd_t
+// ==========================================
+bool SentinelFrame_ToCmd(const sentinel_frame_t* frame, sentinel_cmd_t* out)
+{
+    if (frame->type != FRAME_TYPE_CMD || frame->len < 1) return false;
+
+    const sentinel_cmd_info_t* info = Sentinel_CmdInfo((SystemCmd_t)frame->payload[0]);
+    if (info == NULL) return false;
+
+    const uint8_t* p = &frame->payload[1];
+    const uint8_t* end = frame->payload + frame->len;
+    sentinel_args_t args = {0};
+
+    for (const char* kind = info->schema; *kind; kind++, args.argc++)
+    {
+        if (*kind == 'u')
+        {
+            if (end - p < 4) return false;
+            args.num[args.argc] = (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+                                  ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+            p += 4;
+        }
+        else
+        {
+            const uint8_t* nul = memchr(p, '\0', (size_t)(end - p));
+            if (nul == NULL) return false;
+            args.tok[args.argc] = (const char*)p;
+            p = nul + 1;
+        }
+    }
+    if (p != end) return false;  // 多餘的 bytes
+
+    out->id = (SystemCmd_t)frame->payload[0];
+    out->channel = frame->channel;
+    out->framed = true;
+    out->seq = frame->seq;
+    out->args = args;
+    return true;
+}
+
+// ==========================================
+// 4. Link 輸入端 (文字 / frame 自動切換)
+// ==========================================
+void Sentinel_LinkInit(sentinel_link_t* l, uint8_t channel)
+{
+    memset(l, 0, sizeof(*l));
+    l->channel = channel;
+    Sentinel_ParserInit(&l->text, channel);
+    cobs_decoder_init(&l->cobs, l->raw, sizeof(l->raw));
+}
+
+// 一個 frame 解完：檢查長度與 CRC，再依 type 分派
+static size_t finish_frame(sentinel_link_t* l, sentinel_cmd_cb_t on_cmd,
+                           sentinel_frame_cb_t on_frame, void* ctx)
+{
+    size_t n = l->cobs.len;
+    if (n < SENTINEL_FRAME_HEADER + SENTINEL_FRAME_CRC)
+    {
+        l->frames_malformed++;
+        return 0;
+    }
+
+    n -= SENTINEL_FRAME_CRC;
+    uint16_t crc = (uint16_t)(l->raw[n] | (l->raw[n + 1] << 8));
+    if (SentinelFrame_Crc16(l->raw, n) != crc)
+    {
+        l->frames_bad_crc++;
+        return 0;
+    }
+
+    sentinel_frame_t frame = {.type = l->raw[0],
+                              .seq = l->raw[1],
+                              .channel = l->channel,
+                              .len = (uint16_t)(n - SENTINEL_FRAME_HEADER),
+                              .payload = &l->raw[SENTINEL_FRAME_HEADER]};
+
+    if (frame.type == FRAME_TYPE_CMD)
+    {
+        if (!SentinelFrame_ToCmd(&frame, &l->cmd))
+        {
+            // CRC 正確但不符 schema：仍交給 on_frame，讓上層對這個 seq 回錯誤
+            l->frames_malformed++;
+            if (on_frame) on_frame(ctx, &frame);
+            return 0;
+        }
+        l->frames_ok++;
+        if (on_cmd) on_cmd(ctx, &l->cmd);
+        return 1;
+    }
+
+    l->frames_ok++;
+    if (on_frame) on_frame(ctx, &frame);
+    return 0;
+}
+
+size_t Sentinel_LinkFeed(sentinel_link_t* l, const uint8_t* data, size_t len,
+                         sentinel_cmd_cb_t on_cmd, sentinel_frame_cb_t on_frame, void* ctx)
+{
+    size_t count = 0;
+    const uint8_t* end = data + len;
+
+    while (data < end)
+    {
+        size_t n = (size_t)(end - data);
+        if (!l->in_frame)
+        {
+            // 文字模式：同步字元之前的部分整段交給文字解析器
+            const uint8_t* sync = memchr(data, COBS_DELIM, n);
+            size_t text_len = sync ? (size_t)(sync - data) : n;
+            count += Sentinel_ParseBuffer(&l->text, (const char*)data, text_len, on_cmd, ctx);
+            if (sync == NULL) break;
+
+            l->in_frame = true;
+            cobs_decoder_reset(&l->cobs);
+            data = sync + 1;
+            continue;
+        }
+
+        size_t used;
+        cobs_dec_result_t r = cobs_decode_feed(&l->cobs, data, n, &used);
+        data += used;
+        if (r == COBS_DEC_MORE) break;
+
+        l->in_frame = false;
+        if (r == COBS_DEC_FRAME)
+        {
+            count += finish_frame(l, on_cmd, on_frame, ctx);
+        }
+        else
+        {
+            // 壞 frame 或一超過 buffer 就回到文字模式 (假同步不會吞掉之後所有的文字指令)；
+            // 後面到換行為止是 frame 的殘餘，不當作指令
+            l->frames_malformed++;
+            Sentinel_ParserDiscardLine(&l->text);
+        }
+    }
+    return count;
+}
@@ -0,0 +1,111 @@
+#ifndef SENTINEL_FRAME_H
+#define SENTINEL_FRAME_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cobs.h"
+#include "sentinel_core.h"
+
+// ==========================================
+// 二進位 Frame 格式 (與文字指令共用 UART / USB)
+// ==========================================
+// 線上：0x00 | COBS( type | seq | payload | crc16 ) | 0x00
+//   - 開頭的 0x00 是同步字元：文字指令不會出現 0x00，收到即切換到 frame 模式
+//   - crc16：CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) 涵蓋 type..payload，little-endian
+//   - 每個 frame 都要有自己的開頭 0x00 (不可與上一個 frame 共用分隔符號)
+//   - 解碼超過 SENTINEL_FRAME_RAW_MAX 就立即回到文字模式 (不等結尾的 0x00)：
+//     雜訊造成的假同步最多吞掉約 RAW_MAX bytes，該行剩下的部分丟棄到換行為止
+#define SENTINEL_FRAME_PAYLOAD_MAX 128u
+#define SENTINEL_FRAME_HEADER 2u  // type + seq
+#define SENTINEL_FRAME_CRC 2u
+#define SENTINEL_FRAME_RAW_MAX \
+    (SENTINEL_FRAME_HEADER + SENTINEL_FRAME_PAYLOAD_MAX + SENTINEL_FRAME_CRC)
+// 編碼後最長的 frame (含前後分隔符號)：TX buffer 以此配置
+#define SENTINEL_FRAME_WIRE_MAX (COBS_ENCODED_MAX(SENTINEL_FRAME_RAW_MAX) + 2u)
+
+typedef enum
+{
+    // payload = SystemCmd_t (1 byte) + 依指令表 schema 的參數：
+    //           'u' = uint32 little-endian (4 bytes)、't' = 以 '\0' 結尾的字串
+    FRAME_TYPE_CMD = 0x01,
+    FRAME_TYPE_TEXT = 0x02,  // payload = 文字 (例如指令的回應，seq 與請求相同)
+
+    // Request / Response Session (sentinel_session.h)
+    FRAME_TYPE_RESP = 0x03,  // payload = status (1 byte) + ack (1 byte，下一個期望的請求 seq)
+    FRAME_TYPE_ACK = 0x04,   // payload 空；seq = 累積確認 (下一個期望的 seq)
+    FRAME_TYPE_DATA = 0x05   // payload = offset (uint32 LE) + data
+} sentinel_frame_type_t;
+
+/**
+ * @brief 解碼完成且 CRC 正確的 frame
+ * @note payload 指向 link 內部的解碼 buffer，只在 callback 內有效
+ */
+typedef struct
+{
+    uint8_t type;
+    uint8_t seq;
+    uint8_t channel;
+    uint16_t len;
+    const uint8_t* payload;
+} sentinel_frame_t;
+
+typedef void (*sentinel_frame_cb_t)(void* ctx, const sentinel_frame_t* frame);
+
+/**
+ * @brief 一條 link 的輸入端：文字解析器 + frame 解碼器，依同步字元自動切換
+ */
+typedef struct
+{
+    sentinel_parser_t text;
+    cobs_decoder_t cobs;
+    uint8_t raw[SENTINEL_FRAME_RAW_MAX];  // COBS 直接解碼到這裡
+    sentinel_cmd_t cmd;                   // FRAME_TYPE_CMD 轉出的指令
+    uint8_t channel;
+    bool in_frame;
+
+    // 統計：frame 被丟棄的原因分開計數
+    uint32_t frames_ok;
+    uint32_t frames_bad_crc;
+    uint32_t frames_malformed;  // COBS 錯誤、過長、過短或 CMD payload 不符 schema
+} sentinel_link_t;
+
+/**
+ * @brief CRC-16/CCITT-FALSE (table-driven)
+ */
+uint16_t SentinelFrame_Crc16(const uint8_t* data, size_t len);
+
+/**
+ * @brief 把一個 frame 編碼成線上格式 (含前後 0x00)
+ * @param out 至少 SENTINEL_FRAME_WIRE_MAX bytes 才能容納最長的 payload
+ * @return 寫入 out 的長度；payload 過長或 out 放不下回傳 0
+ */
+size_t SentinelFrame_Encode(uint8_t type, uint8_t seq, const void* payload, size_t len,
+                            uint8_t* out, size_t cap);
+
+/**
+ * @brief 把 FRAME_TYPE_CMD 的 payload 依指令表 schema 轉成 sentinel_cmd_t
+ * @note out->args.tok 指向 frame->payload，生命週期與 frame 相同
+ * @return payload 與 schema 不符時回傳 false
+ */
+bool SentinelFrame_ToCmd(const sentinel_frame_t* frame, sentinel_cmd_t* out);
+
+/**
+ * @brief 初始化 link (文字解析器的 channel 也會寫進每個 frame)
+ */
+void Sentinel_LinkInit(sentinel_link_t* l, uint8_t channel);
+
+/**
+ * @brief 餵入一段 UART / USB 資料 (例如 DMA span)
+ * @details 文字部分交給 Sentinel_ParseBuffer；0x00 之後的 bytes 直接串流進 COBS 解碼器，
+ *          CRC 通過的 FRAME_TYPE_CMD 轉成指令走 on_cmd (與文字指令相同的 handler)，
+ *          其他 type 以及不符 schema 的 FRAME_TYPE_CMD 交給 on_frame。
+ *          frame 中斷前後的文字行不受影響。
+ * @param on_frame 可為 NULL
+ * @return 這段資料中的指令數 (文字 + frame)
+ */
+size_t Sentinel_LinkFeed(sentinel_link_t* l, const uint8_t* data, size_t len,
+                         sentinel_cmd_cb_t on_cmd, sentinel_frame_cb_t on_frame, void* ctx);
+
+#endif  // SENTINEL_FRAME_H
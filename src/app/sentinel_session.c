@@ -0,0 +1,139 @@
+#include "sentinel_session.h"
+
+#include <string.h>
+
+// ==========================================
+// 1. 內部工具
+// ==========================================
+static void send_frame(session_t* s, uint8_t type, uint8_t seq, const uint8_t* payload,
+                       size_t len, bool* sent)
+{
+    uint8_t wire[SENTINEL_FRAME_WIRE_MAX];
+    size_t n = SentinelFrame_Encode(type, seq, payload, len, wire, sizeof(wire));
+    bool ok = (n > 0) && s->ops.send(s->ops.ctx, wire, n);
+    if (sent) *sent = ok;
+}
+
+// seq 之間的距離 (mod 256)
+static inline uint8_t seq_dist(uint8_t from, uint8_t to)
+{
+    return (uint8_t)(to - from);
+}
+
+void Session_Init(session_t* s, const session_ops_t* ops, uint8_t window, uint32_t rto_ms)
+{
+    memset(s, 0, sizeof(*s));
+    s->ops = *ops;
+    if (window < 1) window = 1;
+    if (window > SESSION_WINDOW_MAX) window = SESSION_WINDOW_MAX;
+    s->window = window;
+    s->rto_ms = rto_ms;
+}
+
+// ==========================================
+// 2. 請求端 (host → device)
+// ==========================================
+bool Session_OnRequest(session_t* s, uint8_t seq)
+{
+    if (seq == s->rx_expected)
+    {
+        s->rx_expected++;
+        return true;
+    }
+
+    // 已執行過：host 沒收到 RESP 而重送，只補回應
+    uint8_t behind = seq_dist(seq, s->rx_expected);
+    if (behind >= 1 && behind <= s->window)
+    {
+        s->dup_requests++;
+        Session_Respond(s, seq, SESSION_DUP);
+        return false;
+    }
+
+    // 跳號 (或 host 重新開始編號)：告訴 host 從哪裡重送
+    s->gap_requests++;
+    send_frame(s, FRAME_TYPE_ACK, s->rx_expected, NULL, 0, NULL);
+    return false;
+}
+
+void Session_Respond(session_t* s, uint8_t seq, session_status_t status)
+{
+    const uint8_t payload[2] = {(uint8_t)status, s->rx_expected};
+    send_frame(s, FRAME_TYPE_RESP, seq, payload, sizeof(payload), NULL);
+}
+
+// ==========================================
+// 3. Bulk 傳送端 (device → host, Go-Back-N)
+// ==========================================
+bool Session_BulkStart(session_t* s, uint32_t total, uint32_t chunk, uint32_t now_ms)
+{
+    if (s->tx_active) return false;
+    if (chunk < 1) chunk = 1;
+    if (chunk > SESSION_CHUNK_MAX) chunk = SESSION_CHUNK_MAX;
+
+    // seq 延續上一次 bulk，避免遲到的舊 ACK 被誤認
+    s->tx_total = total;
+    s->tx_chunk = chunk;
+    s->tx_base_off = 0;
+    s->tx_base = s->tx_next;
+    s->tx_timer_ms = now_ms;
+    s->tx_active = (total > 0);
+    return true;
+}
+
+void Session_OnAck(session_t* s, uint8_t ack, uint32_t now_ms)
+{
+    if (!s->tx_active) return;
+
+    // 只接受落在 (base, next] 的累積 ACK
+    uint8_t acked = seq_dist(s->tx_base, ack);
+    if (acked == 0 || acked > seq_dist(s->tx_base, s->tx_next)) return;
+
+    s->tx_base = ack;
+    s->tx_base_off += acked * s->tx_chunk;
+    s->tx_timer_ms = now_ms;  // 還有未確認的 frame：從現在重新計時
+    if (s->tx_base_off >= s->tx_total) s->tx_active = false;
+}
+
+void Session_Poll(session_t* s, uint32_t now_ms)
+{
+    if (!s->tx_active) return;
+
+    // 逾時：從最舊的未確認 frame 起全部重送
+    uint8_t in_flight = seq_dist(s->tx_base, s->tx_next);
+    if (in_flight > 0 && now_ms - s->tx_timer_ms >= s->rto_ms)
+    {
+        s->retransmits += in_flight;
+        s->tx_next = s->tx_base;
+        in_flight = 0;
+    }
+
+    while (in_flight < s->window)
+    {
+        uint32_t off = s->tx_base_off + in_flight * s->tx_chunk;
+        if (off >= s->tx_total) break;
+
+        uint8_t payload[SESSION_DATA_HEADER + SESSION_CHUNK_MAX];
+        uint32_t want = s->tx_total - off;
+        if (want > s->tx_chunk) want = s->tx_chunk;
+        payload[0] = (uint8_t)(off & 0xFF);
+        payload[1] = (uint8_t)(off >> 8);
+        payload[2] = (uint8_t)(off >> 16);
+        payload[3] = (uint8_t)(off >> 24);
+        size_t len = s->ops.read(s->ops.ctx, off, &payload[SESSION_DATA_HEADER], want);
+
+        bool sent;
+        send_frame(s, FRAME_TYPE_DATA, s->tx_next, payload, SESSION_DATA_HEADER + len, &sent);
+        if (!sent) break;  // TX 沒空間：下一輪再送
+
+        if (in_flight == 0) s->tx_timer_ms = now_ms;
+        s->tx_next++;
+        s->data_sent++;
+        in_flight++;
+    }
+}
+
+bool Session_BulkBusy(const session_t* s)
+{
+    return s->tx_active;
+}
@@ -0,0 +1,106 @@
+#ifndef SENTINEL_SESSION_H
+#define SENTINEL_SESSION_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sentinel_frame.h"
+
+// ==========================================
+// Request / Response Session (建立在 sentinel_frame 之上)
+// ==========================================
+// 請求 (host → device)：FRAME_TYPE_CMD，seq 依序遞增 (mod 256)，host 可連續送出最多 window 個
+//   - 依序到達的請求執行後回 RESP(seq, status, ack)；執行期間的輸出是同 seq 的 TEXT frame
+//   - 重送的舊請求 (落在 window 內) 不再執行，直接回 RESP_DUP
+//   - 跳號 (前面的請求遺失) 丟棄並回 ACK(expected)，host 從 expected 起重送 (Go-Back-N)
+// Bulk (device → host)：DATA(seq, offset, data)，最多 window 個未確認；
+//   host 回累積 ACK(下一個期望的 seq)，逾時未確認則從最舊的一個起全部重送
+// (frame type 定義在 sentinel_frame.h)
+#define SESSION_WINDOW_MAX 8u
+#define SESSION_DATA_HEADER 4u  // DATA payload = offset (uint32 LE) + data
+#define SESSION_CHUNK_MAX (SENTINEL_FRAME_PAYLOAD_MAX - SESSION_DATA_HEADER)
+
+typedef enum
+{
+    SESSION_OK = 0,
+    SESSION_ERR_MALFORMED,  // CRC 正確但 payload 不符指令表 schema
+    SESSION_ERR_REJECTED,   // 指令本身失敗 (例如 bulk 傳送中又要求 bulk)
+    SESSION_DUP             // 已執行過 (重送的請求)
+} session_status_t;
+
+// 硬體介面 (由 main 綁定到實際的 link，測試時綁定到模擬 link)
+typedef struct
+{
+    bool (*send)(void* ctx, const uint8_t* wire, size_t len);  // 送出一個編碼好的 frame；false = TX 滿
+    size_t (*read)(void* ctx, uint32_t offset, uint8_t* buf, size_t cap);  // bulk 資料 (可重讀)
+    void* ctx;
+} session_ops_t;
+
+typedef struct
+{
+    session_ops_t ops;
+    uint8_t window;
+    uint32_t rto_ms;
+
+    // --- 請求端 ---
+    uint8_t rx_expected;  // 下一個要執行的請求 seq
+
+    // --- Bulk 傳送端 ---
+    bool tx_active;
+    uint32_t tx_total;   // bulk 總長
+    uint32_t tx_chunk;   // 每個 DATA frame 的資料長度
+    uint32_t tx_base_off;  // tx_base 對應的 offset
+    uint8_t tx_base;     // 最舊的未確認 seq
+    uint8_t tx_next;     // 下一個要送的 seq
+    uint32_t tx_timer_ms;  // 最舊的未確認 frame 送出的時間
+
+    // 統計
+    uint32_t dup_requests;
+    uint32_t gap_requests;
+    uint32_t data_sent;
+    uint32_t retransmits;
+} session_t;
+
+/**
+ * @brief 初始化 session
+ * @param window 請求與 bulk 的最大 in-flight 數 (1..SESSION_WINDOW_MAX)
+ * @param rto_ms Bulk 重送逾時
+ */
+void Session_Init(session_t* s, const session_ops_t* ops, uint8_t window, uint32_t rto_ms);
+
+/**
+ * @brief 收到一個請求 frame (FRAME_TYPE_CMD)
+ * @return true = 新的請求，呼叫端執行後以 Session_Respond 回報結果；
+ *         false = 重送或跳號，已自動回覆 (RESP_DUP / ACK)，不要執行
+ */
+bool Session_OnRequest(session_t* s, uint8_t seq);
+
+/**
+ * @brief 送出請求的完成回應 (RESP)
+ */
+void Session_Respond(session_t* s, uint8_t seq, session_status_t status);
+
+/**
+ * @brief 開始一次 bulk 傳送 (資料由 ops.read 提供)
+ * @param chunk 每個 DATA frame 的資料長度 (上限 SESSION_CHUNK_MAX)
+ * @return false = 上一次 bulk 尚未完成
+ */
+bool Session_BulkStart(session_t* s, uint32_t total, uint32_t chunk, uint32_t now_ms);
+
+/**
+ * @brief 收到 host 的累積 ACK (FRAME_TYPE_ACK)
+ */
+void Session_OnAck(session_t* s, uint8_t ack, uint32_t now_ms);
+
+/**
+ * @brief 主迴圈定期呼叫：在 window 內送出新的 DATA frame、處理重送逾時
+ */
+void Session_Poll(session_t* s, uint32_t now_ms);
+
+/**
+ * @brief 是否有 bulk 正在傳送 (含等待確認)
+ */
+bool Session_BulkBusy(const session_t* s);
+
+#endif  // SENTINEL_SESSION_H
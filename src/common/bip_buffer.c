@@ -0,0 +1,150 @@
+#include "bip_buffer.h"
+
+#include <string.h>  // for memcpy
+
+// 長度欄位為此值代表「這裡之後到 buffer 尾端都是空的，跳回開頭」
+#define BIP_WRAP_MARKER 0xFFFFFFFFu
+
+// 檢查是否為 2 的冪次方 (Power of 2 check)
+static bool is_power_of_two(uint32_t n)
+{
+    return (n > 0) && ((n & (n - 1)) == 0);
+}
+
+// Header + payload 向上對齊到 4 bytes，讓下一筆 Header 永遠對齊
+static inline uint32_t record_span(uint32_t len)
+{
+    return (BIP_HEADER_SIZE + len + 3u) & ~3u;
+}
+
+static inline void put_header(uint8_t* p, uint32_t value)
+{
+    memcpy(p, &value, sizeof(value));
+}
+
+static inline uint32_t get_header(const uint8_t* p)
+{
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+bool bip_init(bip_buffer_t* b, uint8_t* buffer, uint32_t size)
+{
+    if (!b || !buffer || !is_power_of_two(size) || size < 16 || ((uintptr_t)buffer & 3u))
+    {
+        return false;
+    }
+
+    b->buffer = buffer;
+    b->mask = size - 1;
+    atomic_init(&b->write, 0);
+    atomic_init(&b->read, 0);
+    b->pending_skip = 0;
+    b->pending_len = UINT32_MAX;  // 無 reservation
+
+    return true;
+}
+
+// ==========================================
+// Producer 端
+// ==========================================
+uint8_t* bip_reserve(bip_buffer_t* b, uint32_t len)
+{
+    uint32_t size = b->mask + 1;
+    if (len > size / 2 - BIP_HEADER_SIZE)
+    {
+        return NULL;  // 單筆過大，永遠放不下
+    }
+
+    uint32_t write = atomic_load_explicit(&b->write, memory_order_relaxed);
+    uint32_t read = atomic_load_explicit(&b->read, memory_order_acquire);
+    uint32_t free_space = size - (write - read);
+    uint32_t offset = write & b->mask;
+    uint32_t tail_room = size - offset;
+    uint32_t need = record_span(len);
+    uint32_t skip = 0;
+
+    if (need > tail_room)
+    {
+        // 尾端放不下：整段尾巴都讓給 wrap marker，Record 從 offset 0 開始
+        skip = tail_room;
+    }
+    if (skip + need > free_space)
+    {
+        return NULL;  // Buffer Full
+    }
+
+    if (skip > 0)
+    {
+        // marker 在 commit 更新 write 之前 Consumer 看不到，所以可以先寫
+        put_header(&b->buffer[offset], BIP_WRAP_MARKER);
+        offset = 0;
+    }
+
+    b->pending_skip = skip;
+    b->pending_len = len;
+    return &b->buffer[offset + BIP_HEADER_SIZE];
+}
+
+bool bip_commit(bip_buffer_t* b, uint32_t len)
+{
+    if (b->pending_len == UINT32_MAX || len > b->pending_len)
+    {
+        return false;
+    }
+
+    uint32_t write = atomic_load_explicit(&b->write, memory_order_relaxed);
+    uint32_t start = write + b->pending_skip;
+    put_header(&b->buffer[start & b->mask], len);
+
+    // release：Header 與 payload 寫完才讓 Consumer 看見
+    atomic_store_explicit(&b->write, start + record_span(len), memory_order_release);
+
+    b->pending_skip = 0;
+    b->pending_len = UINT32_MAX;
+    return true;
+}
+
+// ==========================================
+// Consumer 端
+// ==========================================
+const uint8_t* bip_peek(bip_buffer_t* b, uint32_t* len)
+{
+    uint32_t read = atomic_load_explicit(&b->read, memory_order_relaxed);
+    uint32_t write = atomic_load_explicit(&b->write, memory_order_acquire);
+
+    if (read == write)
+    {
+        return NULL;  // Buffer Empty
+    }
+
+    uint32_t offset = read & b->mask;
+    uint32_t header = get_header(&b->buffer[offset]);
+    if (header == BIP_WRAP_MARKER)
+    {
+        // 跳過尾端空白：Producer 保證後面一定接著一筆完整 Record
+        read += (b->mask + 1) - offset;
+        atomic_store_explicit(&b->read, read, memory_order_release);
+        offset = 0;
+        header = get_header(&b->buffer[0]);
+    }
+
+    *len = header;
+    return &b->buffer[offset + BIP_HEADER_SIZE];
+}
+
+void bip_release(bip_buffer_t* b)
+{
+    uint32_t read = atomic_load_explicit(&b->read, memory_order_relaxed);
+    uint32_t len = get_header(&b->buffer[read & b->mask]);
+
+    // release：Consumer 處理完 payload 後 Producer 才能覆寫
+    atomic_store_explicit(&b->read, read + record_span(len), memory_order_release);
+}
+
+bool bip_is_empty(bip_buffer_t* b)
+{
+    return atomic_load_explicit(&b->read, memory_order_acquire) ==
+           atomic_load_explicit(&b->write, memory_order_acquire);
+}
@@ -0,0 +1,71 @@
+#ifndef BIP_BUFFER_H
+#define BIP_BUFFER_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// 每筆 Record 前面的長度欄位 (4 bytes，確保 payload 4-byte 對齊可直接轉型成 struct)
+#define BIP_HEADER_SIZE 4u
+
+/**
+ * @brief Variable-length Record Ring (Bip-buffer style, SPSC)
+ * @note  Producer 拿到一段「連續」的寫入空間 (reserve)，寫好後 commit 整筆 Record；
+ *        Consumer 拿到整筆 Record 的連續指標 (peek)，就地處理後 release。
+ *        Record 不會跨越 buffer 尾端：放不下時寫入 wrap marker 跳回開頭。
+ *        Size must be a power of 2. 單筆 payload 上限為 size / 2 - BIP_HEADER_SIZE。
+ */
+typedef struct
+{
+    uint8_t* buffer;  // 資料存儲區 (需 4-byte 對齊)
+    uint32_t mask;    // size - 1
+
+    _Atomic uint32_t write;  // free-running：已發佈的寫入位置 (Producer 修改)
+    _Atomic uint32_t read;   // free-running：已釋放的讀取位置 (Consumer 修改)
+
+    // --- Producer 專用：尚未 commit 的 reservation ---
+    uint32_t pending_skip;  // 為了回繞而跳過的 byte 數 (含 wrap marker)
+    uint32_t pending_len;   // reserve 時要求的 payload 長度
+} bip_buffer_t;
+
+/**
+ * @brief Initialize the record ring
+ * @param buffer 4-byte aligned storage
+ * @param size Size of the buffer (MUST be power of 2, >= 16)
+ * @return true if successful
+ */
+bool bip_init(bip_buffer_t* b, uint8_t* buffer, uint32_t size);
+
+/**
+ * @brief Reserve a contiguous region for one record (Producer only)
+ * @param len Payload length to reserve
+ * @return Pointer to the payload area, or NULL if there is not enough free space
+ */
+uint8_t* bip_reserve(bip_buffer_t* b, uint32_t len);
+
+/**
+ * @brief Publish the reserved record (Producer only)
+ * @param len Actual payload length (<= reserved length, e.g. DMA received fewer bytes)
+ * @return false if no reservation is pending or len exceeds it
+ */
+bool bip_commit(bip_buffer_t* b, uint32_t len);
+
+/**
+ * @brief Get the oldest record in place (Consumer only)
+ * @param len Receives the payload length
+ * @return Pointer to the payload (valid until bip_release), or NULL if empty
+ */
+const uint8_t* bip_peek(bip_buffer_t* b, uint32_t* len);
+
+/**
+ * @brief Release the record returned by bip_peek (Consumer only)
+ */
+void bip_release(bip_buffer_t* b);
+
+/**
+ * @brief Check if there is no committed record
+ */
+bool bip_is_empty(bip_buffer_t* b);
+
+#endif  // BIP_BUFFER_H
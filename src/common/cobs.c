@@ -0,0 +1,122 @@
+#include "cobs.h"
+
+#include <string.h>  // for memchr / memcpy
+
+// ==========================================
+// Encoder
+// ==========================================
+size_t cobs_encode(const uint8_t* src, size_t len, uint8_t* dst, size_t dst_cap)
+{
+    if (dst_cap < COBS_ENCODED_MAX(len)) return 0;
+
+    size_t out = 1;       // dst[0] 保留給第一個 code
+    size_t code_pos = 0;  // 目前 block 的 code 位置
+    uint8_t code = 1;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        if (src[i] != 0)
+        {
+            dst[out++] = src[i];
+            code++;
+        }
+        if (src[i] == 0 || code == 0xFF)
+        {
+            // 結束目前 block：0 由 code 隱含，滿 254 bytes 的 block 不隱含 0
+            dst[code_pos] = code;
+            code_pos = out++;
+            code = 1;
+        }
+    }
+    dst[code_pos] = code;
+    return out;
+}
+
+// ==========================================
+// Streaming Decoder
+// ==========================================
+void cobs_decoder_init(cobs_decoder_t* d, uint8_t* buf, size_t cap)
+{
+    d->buf = buf;
+    d->cap = cap;
+    cobs_decoder_reset(d);
+}
+
+void cobs_decoder_reset(cobs_decoder_t* d)
+{
+    d->len = 0;
+    d->remaining = 0;
+    d->pending_zero = false;
+    d->done = false;
+}
+
+// 放不下就回傳 false：呼叫端立即回報錯誤，不等分隔符號
+static bool put(cobs_decoder_t* d, const uint8_t* src, size_t n)
+{
+    if (n > d->cap - d->len) return false;
+    memcpy(&d->buf[d->len], src, n);
+    d->len += n;
+    return true;
+}
+
+cobs_dec_result_t cobs_decode_feed(cobs_decoder_t* d, const uint8_t* data, size_t len,
+                                   size_t* consumed)
+{
+    static const uint8_t zero = 0;
+    if (d->done) cobs_decoder_reset(d);
+
+    const uint8_t* p = data;
+    const uint8_t* end = data + len;
+    cobs_dec_result_t result = COBS_DEC_MORE;
+
+    while (p < end)
+    {
+        if (d->remaining == 0)
+        {
+            uint8_t code = *p++;
+            if (code == COBS_DELIM)
+            {
+                // 空 frame (連續分隔符號)：略過，繼續等下一個 frame
+                if (d->len == 0 && !d->pending_zero) continue;
+
+                // 結尾隱含的 0 不屬於資料
+                result = COBS_DEC_FRAME;
+                break;
+            }
+            if (d->pending_zero && !put(d, &zero, 1))
+            {
+                result = COBS_DEC_ERROR;
+                break;
+            }
+            d->remaining = (uint8_t)(code - 1);
+            d->pending_zero = (code != 0xFF);
+            continue;
+        }
+
+        // 資料 run：整段複製；run 中間出現 0 代表 frame 被截斷
+        size_t n = (size_t)(end - p);
+        if (n > d->remaining) n = d->remaining;
+        const uint8_t* z = memchr(p, COBS_DELIM, n);
+        if (z) n = (size_t)(z - p);
+
+        if (!put(d, p, n))
+        {
+            // 超過 buffer：不再等分隔符號 (可能永遠不會來，例如線路雜訊造成的假同步)
+            result = COBS_DEC_ERROR;
+            break;
+        }
+        p += n;
+        d->remaining = (uint8_t)(d->remaining - n);
+
+        if (z)
+        {
+            p++;
+            result = COBS_DEC_ERROR;
+            break;
+        }
+    }
+
+    *consumed = (size_t)(p - data);
+    if (result != COBS_DEC_MORE) d->done = true;
+    return result;
+}
@@ -0,0 +1,62 @@
+#ifndef COBS_H
+#define COBS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Frame 分隔符號：編碼後的資料保證不含 0x00
+#define COBS_DELIM 0x00u
+
+// 編碼後的最大長度 (不含分隔符號)：每 254 bytes 多 1 byte overhead
+#define COBS_ENCODED_MAX(n) ((n) + (n) / 254u + 1u)
+
+/**
+ * @brief Consistent Overhead Byte Stuffing encoder
+ * @param dst Output buffer (may not overlap src)
+ * @return Encoded length (without delimiter), or 0 if dst_cap is too small
+ */
+size_t cobs_encode(const uint8_t* src, size_t len, uint8_t* dst, size_t dst_cap);
+
+typedef enum
+{
+    COBS_DEC_MORE = 0,  // data 全部吃完，frame 尚未結束
+    COBS_DEC_FRAME,     // 收到完整 frame：buf[0..len) 有效，直到下一次 feed
+    COBS_DEC_ERROR      // frame 被截斷，或一超過 buffer 就回報 (整個 frame 丟棄)
+} cobs_dec_result_t;
+
+/**
+ * @brief Streaming COBS decoder
+ * @note  直接吃 DMA / ring buffer 的 span：資料 run 以 memcpy 整段解到 buf，不逐 byte 處理。
+ *        Frame 之間連續的分隔符號 (空 frame) 會被略過，可當作重新同步使用。
+ */
+typedef struct
+{
+    uint8_t* buf;
+    size_t cap;
+    size_t len;         // 已解碼的 bytes
+    uint8_t remaining;  // 目前 block 還剩幾個資料 byte (0 = 下一個 byte 是 code)
+    bool pending_zero;  // 下一個 block 開始前要補 0 (上一個 code < 0xFF)
+    bool done;          // 上一次 feed 已回傳 frame 結果，下一次 feed 先重置
+} cobs_decoder_t;
+
+/**
+ * @brief Initialize the decoder with its output buffer
+ */
+void cobs_decoder_init(cobs_decoder_t* d, uint8_t* buf, size_t cap);
+
+/**
+ * @brief Drop any partial frame
+ */
+void cobs_decoder_reset(cobs_decoder_t* d);
+
+/**
+ * @brief Feed encoded bytes; stops right after the delimiter that ends a frame
+ * @note  解碼結果放不下 buf 時立即回傳 COBS_DEC_ERROR，停在放不下的那段資料之前
+ * @param consumed Receives the number of bytes used from data (including that delimiter)
+ * @return COBS_DEC_FRAME / COBS_DEC_ERROR when a frame ended, otherwise COBS_DEC_MORE
+ */
+cobs_dec_result_t cobs_decode_feed(cobs_decoder_t* d, const uint8_t* data, size_t len,
+                                   size_t* consumed);
+
+#endif  // COBS_H
@@ -0,0 +1,142 @@
+#include "event_queue.h"
+
+#include <string.h>  // for memcpy
+
+// 檢查是否為 2 的冪次方 (Power of 2 check)
+static bool is_power_of_two(uint32_t n)
+{
+    return (n > 0) && ((n & (n - 1)) == 0);
+}
+
+bool evq_init(event_queue_t* q, evq_slot_t* slots, uint32_t count)
+{
+    if (!q || !slots || !is_power_of_two(count))
+    {
+        return false;
+    }
+
+    q->slots = slots;
+    q->mask = count - 1;
+
+    // slot i 的初始序號為 i：代表「第 i 次 enqueue 可以使用」
+    for (uint32_t i = 0; i < count; i++)
+    {
+        atomic_init(&slots[i].seq, i);
+    }
+    atomic_init(&q->enqueue_pos, 0);
+    atomic_init(&q->dropped, 0);
+    q->dequeue_pos = 0;
+
+    return true;
+}
+
+// ==========================================
+// Producer 端 (多個)
+// ==========================================
+// slot.seq == pos      → slot 空著，可以搶
+// slot.seq == pos + 1  → 已寫入，等 Consumer 讀取
+// slot.seq <  pos      → Consumer 還沒讀完上一輪 → Full
+bool evq_push(event_queue_t* q, uint8_t source, const uint8_t* data, uint8_t len,
+              uint32_t timestamp_us)
+{
+    if (len > EVQ_PAYLOAD_MAX)
+    {
+        return false;
+    }
+
+    evq_slot_t* slot;
+    uint32_t pos = atomic_load_explicit(&q->enqueue_pos, memory_order_relaxed);
+
+    for (;;)
+    {
+        slot = &q->slots[pos & q->mask];
+        uint32_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        int32_t diff = (int32_t)(seq - pos);
+
+        if (diff == 0)
+        {
+            // 搶 slot：失敗時 pos 會被更新為最新值，直接重試
+            if (atomic_compare_exchange_weak_explicit(&q->enqueue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            atomic_fetch_add_explicit(&q->dropped, 1, memory_order_relaxed);
+            return false;  // Queue Full
+        }
+        else
+        {
+            // 其他 Producer 已經搶走這個 slot，重新讀取 enqueue_pos
+            pos = atomic_load_explicit(&q->enqueue_pos, memory_order_relaxed);
+        }
+    }
+
+    slot->ev.source = source;
+    slot->ev.len = len;
+    slot->ev.timestamp_us = timestamp_us;
+    if (len > 0)
+    {
+        memcpy(slot->ev.data, data, len);
+    }
+
+    // release：事件內容寫完才讓 Consumer 看見
+    atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+    return true;
+}
+
+size_t evq_push_span(event_queue_t* q, uint8_t source, const uint8_t* data, size_t len,
+                     uint32_t timestamp_us)
+{
+    size_t done = 0;
+    while (done < len)
+    {
+        size_t chunk = len - done;
+        if (chunk > EVQ_PAYLOAD_MAX)
+        {
+            chunk = EVQ_PAYLOAD_MAX;
+        }
+        if (!evq_push(q, source, data + done, (uint8_t)chunk, timestamp_us))
+        {
+            break;
+        }
+        done += chunk;
+    }
+    return done;
+}
+
+// ==========================================
+// Consumer 端 (單一)
+// ==========================================
+bool evq_pop(event_queue_t* q, input_event_t* out)
+{
+    uint32_t pos = q->dequeue_pos;
+    evq_slot_t* slot = &q->slots[pos & q->mask];
+    uint32_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+
+    // 尚未發佈 (空的，或 Producer 搶到 slot 但還沒寫完)
+    if ((int32_t)(seq - (pos + 1)) < 0)
+    {
+        return false;
+    }
+
+    *out = slot->ev;
+
+    // 把 slot 交還給下一輪 (pos + size) 的 Producer
+    atomic_store_explicit(&slot->seq, pos + q->mask + 1, memory_order_release);
+    q->dequeue_pos = pos + 1;
+    return true;
+}
+
+uint32_t evq_count(event_queue_t* q)
+{
+    // enqueue_pos 包含已搶到但尚未發佈的 slot，因此是上限估計
+    return atomic_load_explicit(&q->enqueue_pos, memory_order_relaxed) - q->dequeue_pos;
+}
+
+uint32_t evq_dropped(event_queue_t* q)
+{
+    return atomic_load_explicit(&q->dropped, memory_order_relaxed);
+}
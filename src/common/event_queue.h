@@ -0,0 +1,97 @@
+#ifndef EVENT_QUEUE_H
+#define EVENT_QUEUE_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// 單一事件可攜帶的資料量；較長的 span 由 evq_push_span 自動切段
+#define EVQ_PAYLOAD_MAX 16
+
+/**
+ * @brief 輸入來源 (新增來源只需在此加一個 id，主迴圈不必多一個 busy-poll)
+ */
+typedef enum
+{
+    EVQ_SRC_UART = 0,  // 硬體 UART ISR
+    EVQ_SRC_USB,       // USB CDC 收到資料 (通知事件，len 可為 0)
+    EVQ_SRC_TIMER,     // 軟體/硬體計時器
+    EVQ_SRC_COUNT
+} evq_source_t;
+
+/**
+ * @brief Tagged input event
+ */
+typedef struct
+{
+    uint8_t source;        // evq_source_t
+    uint8_t len;           // data 中的有效長度 (0..EVQ_PAYLOAD_MAX)
+    uint32_t timestamp_us; // Producer 端提供的時間戳記
+    uint8_t data[EVQ_PAYLOAD_MAX];
+} input_event_t;
+
+/**
+ * @brief 每個 slot 自帶序號，Producer 以 CAS 搶 slot，寫完後再以 release 發佈
+ */
+typedef struct
+{
+    _Atomic uint32_t seq;
+    input_event_t ev;
+} evq_slot_t;
+
+/**
+ * @brief Lock-free Multi-Producer / Single-Consumer Event Queue
+ * @note  Producer 可以是任何 ISR、另一顆核心或主程式；Consumer 只能有一個 (主迴圈)。
+ *        需要 CAS 指令 (Cortex-M33 LDREX/STREX)，slot 數量必須是 2 的冪次方。
+ */
+typedef struct
+{
+    evq_slot_t* slots;
+    uint32_t mask;
+    _Atomic uint32_t enqueue_pos;  // 所有 Producer 共用
+    uint32_t dequeue_pos;          // 只有 Consumer 修改
+    _Atomic uint32_t dropped;      // 因佇列滿而丟棄的事件數
+} event_queue_t;
+
+/**
+ * @brief Initialize the queue
+ * @param slots Storage for count slots
+ * @param count Number of slots (MUST be power of 2)
+ * @return true if successful, false if count is not power of 2
+ */
+bool evq_init(event_queue_t* q, evq_slot_t* slots, uint32_t count);
+
+/**
+ * @brief Push one event (any Producer, ISR safe)
+ * @param len Must be <= EVQ_PAYLOAD_MAX
+ * @return false if the queue is full (the dropped counter is incremented)
+ */
+bool evq_push(event_queue_t* q, uint8_t source, const uint8_t* data, uint8_t len,
+              uint32_t timestamp_us);
+
+/**
+ * @brief Push a span of any length, split into EVQ_PAYLOAD_MAX sized events
+ * @return Number of bytes queued (stops at the first full condition)
+ */
+size_t evq_push_span(event_queue_t* q, uint8_t source, const uint8_t* data, size_t len,
+                     uint32_t timestamp_us);
+
+/**
+ * @brief Pop the oldest event (single Consumer only)
+ * @return false if the queue is empty
+ */
+bool evq_pop(event_queue_t* q, input_event_t* out);
+
+/**
+ * @brief Number of events currently queued (approximate while Producers are mid-push)
+ * @note  Producers may call this from ISR to apply back-pressure (e.g. RTS) before drops occur
+ */
+uint32_t evq_count(event_queue_t* q);
+
+/**
+ * @brief Number of events dropped because the queue was full
+ */
+uint32_t evq_dropped(event_queue_t* q);
+
+#endif  // EVENT_QUEUE_H
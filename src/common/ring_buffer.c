@@ -1,11 +1,71 @@
 #include "ring_buffer.h"
 
+#include <string.h>  // for memcpy
+
 // 檢查是否為 2 的冪次方 (Power of 2 check)
 static bool is_power_of_two(uint32_t n)
 {
     return (n > 0) && ((n & (n - 1)) == 0);
 }
 
+// ==========================================
+// Instrumentation Helpers
+// ==========================================
+#if RB_ENABLE_STATS
+#define RB_STAT_ADD(rb, field, n) ((rb)->stats.field += (n))
+
+// 只在 Producer 端呼叫：記錄寫入後的佔用量 (位移取代除法)
+static inline void rb_stat_sample(ring_buffer_t* rb, uint32_t occupancy)
+{
+    if (occupancy > rb->stats.high_watermark)
+    {
+        rb->stats.high_watermark = occupancy;
+    }
+    rb->stats.histogram[occupancy >> rb->stats.hist_shift]++;
+}
+
+static void rb_stats_init(ring_buffer_t* rb, uint32_t size)
+{
+    memset(&rb->stats, 0, sizeof(rb->stats));
+
+    // shift = log2(size) - log2(BINS)，讓 0..size-1 剛好映射到 0..BINS-1
+    uint8_t shift = 0;
+    while ((size >> shift) > RB_HIST_BINS)
+    {
+        shift++;
+    }
+    rb->stats.hist_shift = shift;
+}
+#else
+#define RB_STAT_ADD(rb, field, n) ((void)0)
+#define rb_stat_sample(rb, occupancy) ((void)0)
+#endif
+
+#if RB_ENABLE_WATERMARKS
+// Producer 端：寫入後檢查是否越過 high
+static inline void rb_wm_check_high(ring_buffer_t* rb, uint32_t occupancy)
+{
+    if (rb->wm_cb && !rb->wm_above && occupancy >= rb->wm_high)
+    {
+        rb->wm_above = true;
+        rb->wm_cb(rb->wm_ctx, true);
+    }
+}
+
+// Consumer 端：讀出後檢查是否回落到 low
+static inline void rb_wm_check_low(ring_buffer_t* rb)
+{
+    if (rb->wm_cb && rb->wm_above && ((rb->head - rb->tail) & rb->mask) <= rb->wm_low)
+    {
+        rb->wm_above = false;
+        rb->wm_cb(rb->wm_ctx, false);
+    }
+}
+#else
+#define rb_wm_check_high(rb, occupancy) ((void)0)
+#define rb_wm_check_low(rb) ((void)0)
+#endif
+
 bool rb_init(ring_buffer_t* rb, uint8_t* buffer, uint32_t size)
 {
     if (!rb || !buffer || !is_power_of_two(size))
@@ -17,6 +77,17 @@ bool rb_init(ring_buffer_t* rb, uint8_t* buffer, uint32_t size)
     rb->mask = size - 1;  // Example: Size 16 (10000), Mask 15 (01111)
     rb->head = 0;
     rb->tail = 0;
+    rb->policy = RB_POLICY_DROP_NEWEST;
+#if RB_ENABLE_STATS
+    rb_stats_init(rb, size);
+#endif
+#if RB_ENABLE_WATERMARKS
+    rb->wm_cb = NULL;
+    rb->wm_ctx = NULL;
+    rb->wm_high = 0;
+    rb->wm_low = 0;
+    rb->wm_above = false;
+#endif
 
     return true;
 }
@@ -42,7 +113,15 @@ bool rb_push(ring_buffer_t* rb, uint8_t data)
     // No lock needed if only one writer exists.
     if (next_head == rb->tail)
     {
-        return false;  // Buffer Full
+        if (rb->policy != RB_POLICY_OVERWRITE_OLDEST)
+        {
+            RB_STAT_ADD(rb, dropped, 1);
+            return false;  // Buffer Full
+        }
+
+        // 覆蓋模式：丟掉最舊的一個 byte 騰出空間
+        rb->tail = (rb->tail + 1) & rb->mask;
+        RB_STAT_ADD(rb, overwritten, 1);
     }
 
     rb->buffer[rb->head] = data;
@@ -51,6 +130,9 @@ bool rb_push(ring_buffer_t* rb, uint8_t data)
     // __sync_synchronize(); // Uncomment for strict OOO (Out of Order) architectures
 
     rb->head = next_head;
+    RB_STAT_ADD(rb, pushed, 1);
+    rb_stat_sample(rb, (next_head - rb->tail) & rb->mask);
+    rb_wm_check_high(rb, (next_head - rb->tail) & rb->mask);
     return true;
 }
 
@@ -68,5 +150,183 @@ bool rb_pop(ring_buffer_t* rb, uint8_t* data)
     // __sync_synchronize();
 
     rb->tail = (rb->tail + 1) & rb->mask;
+    RB_STAT_ADD(rb, popped, 1);
+    rb_wm_check_low(rb);
     return true;
-}
\ No newline at end of file
+}
+
+// ==========================================
+// Bulk API
+// ==========================================
+// 與 rb_push/rb_pop 相同的 SPSC 規則：
+// 只有 Producer 寫 head，只有 Consumer 寫 tail，
+// 所以一次快照對方的 index 後即可安全地批次搬運。
+
+uint32_t rb_count(ring_buffer_t* rb)
+{
+    return (rb->head - rb->tail) & rb->mask;
+}
+
+uint32_t rb_free(ring_buffer_t* rb)
+{
+    return (rb->tail - rb->head - 1) & rb->mask;
+}
+
+// 覆蓋模式的批次寫入：只保留最新的 capacity 個 byte，並把 tail 往前推
+static uint32_t rb_write_overwrite(ring_buffer_t* rb, const uint8_t* data, uint32_t len,
+                                   uint32_t space)
+{
+    uint32_t capacity = rb->mask;
+    uint32_t skipped = 0;
+
+    if (len > capacity)
+    {
+        // 比整個 buffer 還長：前段直接視為被覆蓋
+        skipped = len - capacity;
+        data += skipped;
+        len = capacity;
+    }
+
+    uint32_t evict = (len > space) ? (len - space) : 0;
+    rb->tail = (rb->tail + evict) & rb->mask;
+    // skipped 視為「寫入後立即被覆蓋」，維持 pushed - popped - overwritten == count
+    RB_STAT_ADD(rb, pushed, skipped);
+    RB_STAT_ADD(rb, overwritten, evict + skipped);
+
+    // 騰出空間後走一般路徑 (不會再觸發覆蓋)
+    return skipped + rb_write(rb, data, len);
+}
+
+uint32_t rb_write(ring_buffer_t* rb, const uint8_t* data, uint32_t len)
+{
+    uint32_t head = rb->head;
+    uint32_t space = (rb->tail - head - 1) & rb->mask;
+    if (len > space)
+    {
+        if (rb->policy == RB_POLICY_OVERWRITE_OLDEST)
+        {
+            return rb_write_overwrite(rb, data, len, space);
+        }
+        RB_STAT_ADD(rb, dropped, len - space);
+        len = space;
+    }
+
+    // 第一段：head 到 buffer 尾端；第二段：回繞到 buffer 開頭
+    uint32_t first = (rb->mask + 1) - head;
+    if (first > len)
+    {
+        first = len;
+    }
+    memcpy(&rb->buffer[head], data, first);
+    memcpy(rb->buffer, data + first, len - first);
+
+    rb->head = (head + len) & rb->mask;
+    RB_STAT_ADD(rb, pushed, len);
+    rb_stat_sample(rb, (rb->head - rb->tail) & rb->mask);
+    rb_wm_check_high(rb, (rb->head - rb->tail) & rb->mask);
+    return len;
+}
+
+uint32_t rb_read(ring_buffer_t* rb, uint8_t* data, uint32_t len)
+{
+    uint32_t tail = rb->tail;
+    uint32_t avail = (rb->head - tail) & rb->mask;
+    if (len > avail)
+    {
+        len = avail;
+    }
+
+    uint32_t first = (rb->mask + 1) - tail;
+    if (first > len)
+    {
+        first = len;
+    }
+    memcpy(data, &rb->buffer[tail], first);
+    memcpy(data + first, rb->buffer, len - first);
+
+    rb->tail = (tail + len) & rb->mask;
+    RB_STAT_ADD(rb, popped, len);
+    rb_wm_check_low(rb);
+    return len;
+}
+
+uint32_t rb_peek_contiguous(ring_buffer_t* rb, const uint8_t** span)
+{
+    uint32_t head = rb->head;
+    uint32_t tail = rb->tail;
+
+    *span = &rb->buffer[tail];
+
+    // 資料沒有跨越回繞點時直接到 head，否則只到 buffer 尾端
+    return (head >= tail) ? (head - tail) : ((rb->mask + 1) - tail);
+}
+
+void rb_consume(ring_buffer_t* rb, uint32_t n)
+{
+    rb->tail = (rb->tail + n) & rb->mask;
+    RB_STAT_ADD(rb, popped, n);
+    rb_wm_check_low(rb);
+}
+
+uint32_t rb_reserve_contiguous(ring_buffer_t* rb, uint8_t** span)
+{
+    uint32_t head = rb->head;
+    uint32_t tail = rb->tail;
+
+    *span = &rb->buffer[head];
+
+    if (head >= tail)
+    {
+        // 可寫到 buffer 尾端；若 tail 在 0，必須保留最後一格以區分 Full/Empty
+        return (rb->mask + 1) - head - (tail == 0 ? 1 : 0);
+    }
+    return tail - head - 1;
+}
+
+void rb_commit(ring_buffer_t* rb, uint32_t n)
+{
+    rb->head = (rb->head + n) & rb->mask;
+    RB_STAT_ADD(rb, pushed, n);
+    rb_stat_sample(rb, (rb->head - rb->tail) & rb->mask);
+    rb_wm_check_high(rb, (rb->head - rb->tail) & rb->mask);
+}
+
+// ==========================================
+// Policy & Instrumentation
+// ==========================================
+void rb_set_policy(ring_buffer_t* rb, rb_policy_t policy)
+{
+    rb->policy = policy;
+}
+
+#if RB_ENABLE_WATERMARKS
+bool rb_set_watermarks(ring_buffer_t* rb, uint32_t high, uint32_t low, rb_watermark_cb_t cb,
+                       void* ctx)
+{
+    if (low >= high || high > rb->mask) return false;
+
+    rb->wm_cb = NULL;  // 設定期間先停用，避免 ISR 看到一半的設定
+    rb->wm_high = high;
+    rb->wm_low = low;
+    rb->wm_ctx = ctx;
+    rb->wm_above = false;
+    rb->wm_cb = cb;
+
+    rb_wm_check_high(rb, rb_count(rb));
+    return true;
+}
+#endif
+
+#if RB_ENABLE_STATS
+void rb_get_stats(ring_buffer_t* rb, rb_stats_t* out)
+{
+    *out = rb->stats;
+}
+
+void rb_reset_stats(ring_buffer_t* rb)
+{
+    uint8_t shift = rb->stats.hist_shift;
+    memset(&rb->stats, 0, sizeof(rb->stats));
+    rb->stats.hist_shift = shift;
+}
+#endif
@@ -5,6 +5,61 @@
 #include <stddef.h>
 #include <stdint.h>
 
+// ==========================================
+// 編譯期設定 (Compile-time Options)
+// ==========================================
+// 統計計數器只用加法與位移 (無除法、無鎖)，預設在 Release 也保持開啟；
+// 需要省下 RAM 時可用 -DRB_ENABLE_STATS=0 關閉。
+#ifndef RB_ENABLE_STATS
+#define RB_ENABLE_STATS 1
+#endif
+
+// 佔用率直方圖的格數 (必須是 2 的冪次方)
+#ifndef RB_HIST_BINS
+#define RB_HIST_BINS 8
+#endif
+
+// High/Low watermark 通知 (例如驅動 UART RTS 流量控制)；未註冊 Callback 時只多一個指標判斷
+#ifndef RB_ENABLE_WATERMARKS
+#define RB_ENABLE_WATERMARKS 1
+#endif
+
+/**
+ * @brief 滿載時的處理策略
+ */
+typedef enum
+{
+    RB_POLICY_DROP_NEWEST = 0,  // 預設：滿了就拒收新資料 (保留完整性)
+    RB_POLICY_OVERWRITE_OLDEST  // 滿了就覆蓋最舊資料 (保留新鮮度，適合 Telemetry)
+} rb_policy_t;
+
+#if RB_ENABLE_STATS
+/**
+ * @brief Occupancy instrumentation
+ * @note  Producer 端只寫 pushed/dropped/overwritten/high_watermark/histogram，
+ *        Consumer 端只寫 popped，維持 SPSC 單一寫入者規則。
+ */
+typedef struct
+{
+    uint32_t pushed;          // 成功寫入的 byte 總數
+    uint32_t popped;          // 讀出的 byte 總數
+    uint32_t dropped;         // 因滿載被拒收的 byte 數 (DROP_NEWEST)
+    uint32_t overwritten;     // 被覆蓋掉的舊 byte 數 (OVERWRITE_OLDEST)
+    uint32_t high_watermark;  // 歷史最高佔用量
+    uint32_t histogram[RB_HIST_BINS];  // 每次寫入後的佔用率分佈
+    uint8_t hist_shift;                // occupancy >> hist_shift = bin index
+} rb_stats_t;
+#endif
+
+#if RB_ENABLE_WATERMARKS
+/**
+ * @brief Watermark Callback
+ * @param above_high true = 佔用量達到 high (Producer 端呼叫)；
+ *                   false = 佔用量回落到 low 以下 (Consumer 端呼叫)
+ */
+typedef void (*rb_watermark_cb_t)(void* ctx, bool above_high);
+#endif
+
 /**
  * @brief Ring Buffer Structure
  * @note  Size must be a power of 2 for efficient masking.
@@ -15,6 +70,17 @@ typedef struct
     uint32_t mask;           // 用於快速計算索引 (size - 1)
     volatile uint32_t head;  // 寫入位置 (由 ISR 修改)
     volatile uint32_t tail;  // 讀取位置 (由 Application 修改)
+    rb_policy_t policy;      // 滿載策略 (預設 DROP_NEWEST)
+#if RB_ENABLE_STATS
+    rb_stats_t stats;
+#endif
+#if RB_ENABLE_WATERMARKS
+    rb_watermark_cb_t wm_cb;  // NULL = 未啟用
+    void* wm_ctx;
+    uint32_t wm_high;
+    uint32_t wm_low;
+    volatile bool wm_above;  // 目前是否處於 high 之上 (hysteresis 狀態)
+#endif
 } ring_buffer_t;
 
 /**
@@ -46,4 +112,88 @@ bool rb_is_empty(ring_buffer_t* rb);
  */
 bool rb_is_full(ring_buffer_t* rb);
 
-#endif  // RING_BUFFER_H
\ No newline at end of file
+// ==========================================
+// Bulk API (最多兩段 memcpy 跨越回繞點)
+// ==========================================
+
+/**
+ * @brief Number of bytes currently stored
+ */
+uint32_t rb_count(ring_buffer_t* rb);
+
+/**
+ * @brief Number of bytes that can still be written (capacity is size - 1)
+ */
+uint32_t rb_free(ring_buffer_t* rb);
+
+/**
+ * @brief Copy up to len bytes into the buffer (Producer side)
+ * @return Number of bytes actually written (may be less than len when nearly full)
+ */
+uint32_t rb_write(ring_buffer_t* rb, const uint8_t* data, uint32_t len);
+
+/**
+ * @brief Copy up to len bytes out of the buffer (Consumer side)
+ * @return Number of bytes actually read
+ */
+uint32_t rb_read(ring_buffer_t* rb, uint8_t* data, uint32_t len);
+
+/**
+ * @brief Zero-copy read: expose the contiguous readable region starting at tail
+ * @param span Receives a pointer into the storage (valid until rb_consume)
+ * @return Length of the region; call again after rb_consume to get the wrapped part
+ */
+uint32_t rb_peek_contiguous(ring_buffer_t* rb, const uint8_t** span);
+
+/**
+ * @brief Release n bytes previously exposed by rb_peek_contiguous
+ */
+void rb_consume(ring_buffer_t* rb, uint32_t n);
+
+/**
+ * @brief Zero-copy write: expose the contiguous writable region starting at head
+ * @param span Receives a pointer into the storage
+ * @return Length of the region (0 when full)
+ */
+uint32_t rb_reserve_contiguous(ring_buffer_t* rb, uint8_t** span);
+
+/**
+ * @brief Publish n bytes written into the region from rb_reserve_contiguous
+ */
+void rb_commit(ring_buffer_t* rb, uint32_t n);
+
+// ==========================================
+// Policy & Instrumentation
+// ==========================================
+
+/**
+ * @brief Select what happens when the buffer is full
+ * @note  OVERWRITE_OLDEST 會讓 Producer 也移動 tail，打破 SPSC 單一寫入者規則；
+ *        Consumer 必須與 Producer 在同一個 context，或在關中斷的情況下讀取。
+ */
+void rb_set_policy(ring_buffer_t* rb, rb_policy_t policy);
+
+#if RB_ENABLE_WATERMARKS
+/**
+ * @brief Register high/low watermark notifications (hysteresis)
+ * @details 佔用量升到 >= high 時呼叫 cb(ctx, true) 一次，之後降到 <= low 才呼叫 cb(ctx, false)。
+ *          兩者之間的來回不會重複通知。若目前已 >= high 會立即通知。cb = NULL 停用。
+ * @return false if low >= high or high exceeds the capacity (size - 1)
+ */
+bool rb_set_watermarks(ring_buffer_t* rb, uint32_t high, uint32_t low, rb_watermark_cb_t cb,
+                       void* ctx);
+#endif
+
+#if RB_ENABLE_STATS
+/**
+ * @brief Snapshot the counters (copy; safe to call from the application)
+ */
+void rb_get_stats(ring_buffer_t* rb, rb_stats_t* out);
+
+/**
+ * @brief Clear all counters (keeps the histogram bin mapping)
+ */
+void rb_reset_stats(ring_buffer_t* rb);
+#endif
+
+#endif  // RING_BUFFER_H
@@ -0,0 +1,189 @@
+#include "scheduler.h"
+
+#include <string.h>
+
+#define WHEEL_MASK (SCHED_WHEEL_SLOTS - 1u)
+
+_Static_assert((SCHED_WHEEL_SLOTS & WHEEL_MASK) == 0, "SCHED_WHEEL_SLOTS must be power of 2");
+
+// a 是否已經到了 (或超過) b：以差值判斷，uint32 ms 計數器 wrap 後仍然正確
+static inline bool time_reached(uint32_t a, uint32_t b)
+{
+    return (int32_t)(a - b) >= 0;
+}
+
+void sched_init(sched_t* s, uint32_t now_ms, uint32_t (*clock_us)(void* ctx), void* clock_ctx)
+{
+    memset(s, 0, sizeof(*s));
+    s->tick_ms = now_ms;
+    s->clock_us = clock_us;
+    s->clock_ctx = clock_ctx;
+}
+
+void sched_task_init(sched_task_t* t, const char* name, sched_task_fn_t fn, void* ctx,
+                     uint32_t budget_us)
+{
+    memset(t, 0, sizeof(*t));
+    t->name = name;
+    t->fn = fn;
+    t->ctx = ctx;
+    t->budget_us = budget_us;
+    atomic_init(&t->pending, false);
+}
+
+// ==========================================
+// 1. Timer wheel
+// ==========================================
+static void wheel_insert(sched_t* s, sched_task_t* t)
+{
+    sched_task_t** head = &s->wheel[t->deadline_ms & WHEEL_MASK];
+    t->prev = NULL;
+    t->next = *head;
+    if (*head) (*head)->prev = t;
+    *head = t;
+    t->armed = true;
+}
+
+static void wheel_remove(sched_t* s, sched_task_t* t)
+{
+    if (t->prev)
+    {
+        t->prev->next = t->next;
+    }
+    else
+    {
+        s->wheel[t->deadline_ms & WHEEL_MASK] = t->next;
+    }
+    if (t->next) t->next->prev = t->prev;
+    t->prev = NULL;
+    t->next = NULL;
+    t->armed = false;
+}
+
+void sched_start(sched_t* s, sched_task_t* t, uint32_t delay_ms, uint32_t period_ms)
+{
+    if (t->armed) wheel_remove(s, t);
+    if (delay_ms == 0) delay_ms = 1;  // 目前這個 tick 的 slot 已經處理過了
+
+    // 以最近一次 sched_run 的時間為基準 (在 task 內呼叫時就是本輪的 now)
+    t->deadline_ms = s->tick_ms + delay_ms;
+    t->period_ms = period_ms;
+    wheel_insert(s, t);
+}
+
+void sched_stop(sched_t* s, sched_task_t* t)
+{
+    if (t->armed) wheel_remove(s, t);
+}
+
+// ==========================================
+// 2. Event tasks
+// ==========================================
+void sched_add_event(sched_t* s, sched_task_t* t, sched_ready_fn_t ready)
+{
+    t->ready = ready;
+    t->next_event = NULL;
+    if (s->events_tail)
+    {
+        s->events_tail->next_event = t;
+    }
+    else
+    {
+        s->events = t;
+    }
+    s->events_tail = t;
+}
+
+void sched_notify(sched_task_t* t)
+{
+    atomic_store_explicit(&t->pending, true, memory_order_release);
+}
+
+// ==========================================
+// 3. 執行
+// ==========================================
+static void run_task(sched_t* s, sched_task_t* t, uint32_t now_ms)
+{
+    uint32_t start = s->clock_us ? s->clock_us(s->clock_ctx) : 0;
+    s->current = t;
+    s->current_start_us = start;
+
+    t->fn(t->ctx, now_ms);
+
+    s->current = NULL;
+    t->runs++;
+    if (!s->clock_us) return;
+
+    uint32_t elapsed = s->clock_us(s->clock_ctx) - start;
+    if (elapsed > t->max_us) t->max_us = elapsed;
+    if (t->budget_us && elapsed > t->budget_us) t->overruns++;
+}
+
+// 執行一個 slot 中所有到期的 task (還沒到期的是之後幾圈的 deadline，留在原處)
+// 每執行一個 task 就從 slot 頭重新找：task 內可能 stop / start 同一個 slot 的其他 task
+static uint32_t run_slot(sched_t* s, uint32_t slot, uint32_t now_ms)
+{
+    uint32_t ran = 0;
+    for (;;)
+    {
+        sched_task_t* t = s->wheel[slot];
+        while (t && !time_reached(now_ms, t->deadline_ms)) t = t->next;
+        if (!t) return ran;
+
+        uint32_t due = t->deadline_ms;
+        uint32_t late = now_ms - due;
+        if (late > t->max_late_ms) t->max_late_ms = late;
+        wheel_remove(s, t);
+
+        // 先排好下一次再執行：task 內可以 stop 自己或改週期
+        if (t->period_ms)
+        {
+            t->deadline_ms = due + t->period_ms;
+            if (time_reached(now_ms, t->deadline_ms))
+            {
+                // 落後超過一個週期 (例如被長時間阻塞)：不補跑，從現在重新對齊
+                t->skipped += late / t->period_ms;
+                t->deadline_ms = now_ms + t->period_ms;
+            }
+            wheel_insert(s, t);
+        }
+
+        run_task(s, t, now_ms);
+        ran++;
+    }
+}
+
+uint32_t sched_run(sched_t* s, uint32_t now_ms)
+{
+    uint32_t ran = 0;
+
+    // 只處理上次之後經過的 slot；經過超過一圈時每個 slot 掃一次即可
+    uint32_t elapsed = now_ms - s->tick_ms;
+    if ((int32_t)elapsed > 0)
+    {
+        uint32_t steps = (elapsed < SCHED_WHEEL_SLOTS) ? elapsed : SCHED_WHEEL_SLOTS;
+        uint32_t first = now_ms - steps + 1;
+        s->tick_ms = now_ms;  // task 內的 sched_start 從 now 起算，不會落進已掃過的 slot
+        for (uint32_t i = 0; i < steps; i++)
+        {
+            ran += run_slot(s, (first + i) & WHEEL_MASK, now_ms);
+        }
+    }
+
+    for (sched_task_t* t = s->events; t; t = t->next_event)
+    {
+        bool notified = atomic_exchange_explicit(&t->pending, false, memory_order_acquire);
+        if (notified || (t->ready && t->ready(t->ctx)))
+        {
+            run_task(s, t, now_ms);
+            ran++;
+        }
+    }
+    return ran;
+}
+
+bool sched_should_yield(const sched_t* s)
+{
+    if (!s->current || !s->current->budget_us || !s->clock_us) return false;
+    return s->clock_us(s->clock_ctx) - s->current_start_us >= s->current->budget_us;
+}
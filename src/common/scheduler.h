@@ -0,0 +1,114 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// ==========================================
+// Cooperative Scheduler (單一執行緒，task 跑完才換下一個)
+// ==========================================
+// Timer task：放進 hashed timer wheel，slot = deadline % SCHED_WHEEL_SLOTS (1 tick = 1 ms)
+//   - 啟動 / 停止都是 O(1) (intrusive 雙向串列)；超過一圈的 deadline 留在 slot 裡等之後幾圈
+//   - 每次 sched_run 只掃過上次之後經過的 slot (最多一圈)，不必走訪所有 task
+// Event task：有 ready() 條件 (例如 ring 非空) 或被 sched_notify (ISR 可呼叫) 時執行
+// 時間一律由呼叫端傳入 (ms)，測試時可以用虛擬時鐘驅動
+#define SCHED_WHEEL_SLOTS 64u  // 必須是 2 的冪次方
+
+typedef void (*sched_task_fn_t)(void* ctx, uint32_t now_ms);
+typedef bool (*sched_ready_fn_t)(void* ctx);
+
+/**
+ * @brief Task 控制區塊 (由呼叫端配置，scheduler 不做動態配置)
+ */
+typedef struct sched_task
+{
+    const char* name;
+    sched_task_fn_t fn;
+    void* ctx;
+    uint32_t budget_us;  // 單次執行的預算 (0 = 不檢查)；超過只計數，cooperative 無法搶斷
+
+    // --- Timer ---
+    uint32_t deadline_ms;
+    uint32_t period_ms;  // 0 = one-shot
+    bool armed;          // 是否在 wheel 中
+    struct sched_task* prev;
+    struct sched_task* next;
+
+    // --- Event ---
+    sched_ready_fn_t ready;
+    _Atomic bool pending;  // sched_notify 設定，執行前清除
+    struct sched_task* next_event;
+
+    // 統計
+    uint32_t runs;
+    uint32_t overruns;     // 執行時間超過 budget_us 的次數
+    uint32_t max_us;       // 最長的單次執行時間
+    uint32_t max_late_ms;  // Timer 實際執行時間比 deadline 晚最多多少
+    uint32_t skipped;      // 週期 task 落後超過一個週期時略過的次數 (不補跑)
+} sched_task_t;
+
+typedef struct
+{
+    sched_task_t* wheel[SCHED_WHEEL_SLOTS];
+    sched_task_t* events;       // Event task 依註冊順序
+    sched_task_t* events_tail;
+    uint32_t tick_ms;           // wheel 已處理到的時間
+
+    uint32_t (*clock_us)(void* ctx);  // 量測 task 執行時間用 (NULL = 不量測)
+    void* clock_ctx;
+    const sched_task_t* current;      // 正在執行的 task
+    uint32_t current_start_us;
+} sched_t;
+
+/**
+ * @brief Initialize the scheduler
+ * @param now_ms 目前時間 (之後 sched_run 傳入的時間從這裡開始累加)
+ * @param clock_us Microsecond clock for budgets (NULL to disable run-time accounting)
+ */
+void sched_init(sched_t* s, uint32_t now_ms, uint32_t (*clock_us)(void* ctx), void* clock_ctx);
+
+/**
+ * @brief Initialize a task (does not schedule it)
+ * @param budget_us Per-run budget, 0 = unlimited
+ */
+void sched_task_init(sched_task_t* t, const char* name, sched_task_fn_t fn, void* ctx,
+                     uint32_t budget_us);
+
+/**
+ * @brief Arm a timer task (re-arms if already armed)
+ * @param delay_ms First run after this many ms (0 is treated as 1: the next tick)
+ * @param period_ms 0 = one-shot, otherwise periodic
+ */
+void sched_start(sched_t* s, sched_task_t* t, uint32_t delay_ms, uint32_t period_ms);
+
+/**
+ * @brief Disarm a timer task (no-op if not armed; safe from inside any task)
+ */
+void sched_stop(sched_t* s, sched_task_t* t);
+
+/**
+ * @brief Register an event task
+ * @param ready Polled once per sched_run (NULL = runs only when notified)
+ */
+void sched_add_event(sched_t* s, sched_task_t* t, sched_ready_fn_t ready);
+
+/**
+ * @brief Mark an event task as pending (ISR safe)
+ */
+void sched_notify(sched_task_t* t);
+
+/**
+ * @brief Run everything that is due: expired timers (in tick order), then ready event tasks
+ * @note  不可在 task 內遞迴呼叫
+ * @return Number of task runs (0 = idle, caller may sleep until the next interrupt / tick)
+ */
+uint32_t sched_run(sched_t* s, uint32_t now_ms);
+
+/**
+ * @brief 批次處理的 task 在迴圈中呼叫：已用完自己的 budget 就該 return，剩下的下一輪再做
+ */
+bool sched_should_yield(const sched_t* s);
+
+#endif  // SCHEDULER_H
@@ -0,0 +1,141 @@
+#include "spsc_ring.h"
+
+#include <string.h>  // for memcpy
+
+// 檢查是否為 2 的冪次方 (Power of 2 check)
+static bool is_power_of_two(uint32_t n)
+{
+    return (n > 0) && ((n & (n - 1)) == 0);
+}
+
+bool spsc_init(spsc_ring_t* r, uint8_t* buffer, uint32_t size)
+{
+    if (!r || !buffer || !is_power_of_two(size))
+    {
+        return false;
+    }
+
+    r->buffer = buffer;
+    r->mask = size - 1;
+    atomic_init(&r->head, 0);
+    atomic_init(&r->tail, 0);
+    r->cached_tail = 0;
+    r->cached_head = 0;
+
+    return true;
+}
+
+// ==========================================
+// Producer 端
+// ==========================================
+// head 只有 Producer 會寫，relaxed 讀取自己的值即可；
+// 讀對方的 tail 用 acquire，確保 Consumer 已經讀完該 slot 才覆寫。
+// 先看 cached_tail，只有看起來快滿時才真正去讀共享的 tail。
+
+static uint32_t producer_space(spsc_ring_t* r, uint32_t head, uint32_t want)
+{
+    uint32_t size = r->mask + 1;
+    uint32_t space = size - (head - r->cached_tail);
+    if (space < want)
+    {
+        r->cached_tail = atomic_load_explicit(&r->tail, memory_order_acquire);
+        space = size - (head - r->cached_tail);
+    }
+    return space;
+}
+
+bool spsc_push(spsc_ring_t* r, uint8_t data)
+{
+    uint32_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+    if (producer_space(r, head, 1) == 0)
+    {
+        return false;  // Buffer Full
+    }
+
+    r->buffer[head & r->mask] = data;
+
+    // release：資料寫入必須在 head 更新之前對 Consumer 可見
+    atomic_store_explicit(&r->head, head + 1, memory_order_release);
+    return true;
+}
+
+uint32_t spsc_write(spsc_ring_t* r, const uint8_t* data, uint32_t len)
+{
+    uint32_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+    uint32_t space = producer_space(r, head, len);
+    if (len > space)
+    {
+        len = space;
+    }
+
+    uint32_t idx = head & r->mask;
+    uint32_t first = (r->mask + 1) - idx;
+    if (first > len)
+    {
+        first = len;
+    }
+    memcpy(&r->buffer[idx], data, first);
+    memcpy(r->buffer, data + first, len - first);
+
+    atomic_store_explicit(&r->head, head + len, memory_order_release);
+    return len;
+}
+
+// ==========================================
+// Consumer 端
+// ==========================================
+
+static uint32_t consumer_avail(spsc_ring_t* r, uint32_t tail, uint32_t want)
+{
+    uint32_t avail = r->cached_head - tail;
+    if (avail < want)
+    {
+        r->cached_head = atomic_load_explicit(&r->head, memory_order_acquire);
+        avail = r->cached_head - tail;
+    }
+    return avail;
+}
+
+bool spsc_pop(spsc_ring_t* r, uint8_t* data)
+{
+    uint32_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    if (consumer_avail(r, tail, 1) == 0)
+    {
+        return false;  // Buffer Empty
+    }
+
+    *data = r->buffer[tail & r->mask];
+
+    // release：資料讀出必須在 tail 更新之前完成，Producer 才能覆寫
+    atomic_store_explicit(&r->tail, tail + 1, memory_order_release);
+    return true;
+}
+
+uint32_t spsc_read(spsc_ring_t* r, uint8_t* data, uint32_t len)
+{
+    uint32_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    uint32_t avail = consumer_avail(r, tail, len);
+    if (len > avail)
+    {
+        len = avail;
+    }
+
+    uint32_t idx = tail & r->mask;
+    uint32_t first = (r->mask + 1) - idx;
+    if (first > len)
+    {
+        first = len;
+    }
+    memcpy(data, &r->buffer[idx], first);
+    memcpy(data + first, r->buffer, len - first);
+
+    atomic_store_explicit(&r->tail, tail + len, memory_order_release);
+    return len;
+}
+
+uint32_t spsc_count(spsc_ring_t* r)
+{
+    uint32_t tail = atomic_load_explicit(&r->tail, memory_order_acquire);
+    uint32_t head = atomic_load_explicit(&r->head, memory_order_acquire);
+    return head - tail;
+}
@@ -0,0 +1,70 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Producer / Consumer 欄位分開對齊，避免兩顆核心互相搶同一條 cache line
+// (RP2350 SRAM 沒有 data cache，可定義為 4 以節省 RAM)
+#ifndef SPSC_RING_ALIGN
+#define SPSC_RING_ALIGN 64
+#endif
+
+/**
+ * @brief Lock-free SPSC Ring Buffer (C11 atomics)
+ * @note  與 ring_buffer_t 不同，這裡使用 acquire/release 順序，
+ *        可安全用於 core1 (Producer) → core0 (Consumer)。
+ *        head/tail 為 free-running index，因此所有 slot 都能使用。
+ *        Size must be a power of 2.
+ */
+typedef struct
+{
+    uint8_t* buffer;  // 資料存儲區
+    uint32_t mask;    // size - 1
+
+    // --- Producer 專用 ---
+    _Alignas(SPSC_RING_ALIGN) _Atomic uint32_t head;  // 寫入位置 (Producer 修改)
+    uint32_t cached_tail;                             // Producer 看到的 tail 快照
+
+    // --- Consumer 專用 ---
+    _Alignas(SPSC_RING_ALIGN) _Atomic uint32_t tail;  // 讀取位置 (Consumer 修改)
+    uint32_t cached_head;                             // Consumer 看到的 head 快照
+} spsc_ring_t;
+
+/**
+ * @brief Initialize the ring (not thread safe, call before sharing)
+ * @param size Size of the buffer (MUST be power of 2)
+ * @return true if successful, false if size is not power of 2
+ */
+bool spsc_init(spsc_ring_t* r, uint8_t* buffer, uint32_t size);
+
+/**
+ * @brief Push one byte (Producer only)
+ */
+bool spsc_push(spsc_ring_t* r, uint8_t data);
+
+/**
+ * @brief Pop one byte (Consumer only)
+ */
+bool spsc_pop(spsc_ring_t* r, uint8_t* data);
+
+/**
+ * @brief Copy up to len bytes in (Producer only)
+ * @return Number of bytes actually written
+ */
+uint32_t spsc_write(spsc_ring_t* r, const uint8_t* data, uint32_t len);
+
+/**
+ * @brief Copy up to len bytes out (Consumer only)
+ * @return Number of bytes actually read
+ */
+uint32_t spsc_read(spsc_ring_t* r, uint8_t* data, uint32_t len);
+
+/**
+ * @brief Approximate number of stored bytes (exact when called from either side while idle)
+ */
+uint32_t spsc_count(spsc_ring_t* r);
+
+#endif  // SPSC_RING_H
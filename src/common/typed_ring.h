@@ -0,0 +1,106 @@
+#ifndef TYPED_RING_H
+#define TYPED_RING_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Typed fixed-element ring buffer generator
+ *
+ * 用法：
+ * @code
+ *   RING_DEFINE(sample_ring, sensor_sample_t, 32)
+ *
+ *   static sample_ring_t samples;
+ *   sample_ring_init(&samples);
+ *   sample_ring_push(&samples, s);            // ISR
+ *   while (sample_ring_pop(&samples, &s)) {}  // main loop
+ * @endcode
+ *
+ * @note 與 ring_buffer_t 的差異：
+ *       - capacity 是編譯期常數 (必須是 2 的冪次方)，masking 會被編譯器折成常數
+ *       - head/tail 為 free-running index，所有 slot 都能使用 (沒有浪費一格)
+ *       - 所有函式皆為 static inline
+ *       同步規則與 ring_buffer_t 相同 (單核 ISR → main)；跨核心請使用 spsc_ring_t。
+ */
+#define RING_DEFINE(name, type, capacity)                                                       \
+    _Static_assert((capacity) > 0 && ((capacity) & ((capacity)-1)) == 0,                        \
+                   #name ": capacity must be a power of 2");                                    \
+                                                                                                \
+    typedef struct                                                                              \
+    {                                                                                           \
+        type items[capacity];                                                                   \
+        volatile uint32_t head; /* 寫入計數 (由 Producer 修改) */                              \
+        volatile uint32_t tail; /* 讀取計數 (由 Consumer 修改) */                              \
+    } name##_t;                                                                                 \
+                                                                                                \
+    static inline void name##_init(name##_t* r)                                                 \
+    {                                                                                           \
+        r->head = 0;                                                                            \
+        r->tail = 0;                                                                            \
+    }                                                                                           \
+                                                                                                \
+    static inline uint32_t name##_count(const name##_t* r)                                      \
+    {                                                                                           \
+        return r->head - r->tail;                                                               \
+    }                                                                                           \
+                                                                                                \
+    static inline bool name##_is_empty(const name##_t* r)                                       \
+    {                                                                                           \
+        return r->head == r->tail;                                                              \
+    }                                                                                           \
+                                                                                                \
+    static inline bool name##_is_full(const name##_t* r)                                        \
+    {                                                                                           \
+        return (r->head - r->tail) == (capacity);                                               \
+    }                                                                                           \
+                                                                                                \
+    static inline bool name##_push(name##_t* r, type item)                                      \
+    {                                                                                           \
+        uint32_t head = r->head;                                                                \
+        if ((head - r->tail) == (capacity))                                                     \
+        {                                                                                       \
+            return false; /* Ring Full */                                                       \
+        }                                                                                       \
+        r->items[head & ((capacity)-1)] = item;                                                 \
+        /* Compiler barrier：元素寫入必須在 head 更新之前 */                                   \
+        atomic_signal_fence(memory_order_release);                                              \
+        r->head = head + 1;                                                                     \
+        return true;                                                                            \
+    }                                                                                           \
+                                                                                                \
+    static inline bool name##_pop(name##_t* r, type* out)                                       \
+    {                                                                                           \
+        uint32_t tail = r->tail;                                                                \
+        if (r->head == tail)                                                                    \
+        {                                                                                       \
+            return false; /* Ring Empty */                                                      \
+        }                                                                                       \
+        atomic_signal_fence(memory_order_acquire);                                              \
+        *out = r->items[tail & ((capacity)-1)];                                                 \
+        atomic_signal_fence(memory_order_release);                                              \
+        r->tail = tail + 1;                                                                     \
+        return true;                                                                            \
+    }                                                                                           \
+                                                                                                \
+    /* Zero-copy：取得最舊元素的指標 (不移除)，處理完呼叫 name##_drop */                        \
+    static inline type* name##_peek(name##_t* r)                                                \
+    {                                                                                           \
+        uint32_t tail = r->tail;                                                                \
+        if (r->head == tail)                                                                    \
+        {                                                                                       \
+            return NULL;                                                                        \
+        }                                                                                       \
+        atomic_signal_fence(memory_order_acquire);                                              \
+        return &r->items[tail & ((capacity)-1)];                                                \
+    }                                                                                           \
+                                                                                                \
+    static inline void name##_drop(name##_t* r)                                                 \
+    {                                                                                           \
+        atomic_signal_fence(memory_order_release);                                              \
+        r->tail = r->tail + 1;                                                                  \
+    }
+
+#endif  // TYPED_RING_H
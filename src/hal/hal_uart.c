@@ -1,12 +1,15 @@
 #include "hal_uart.h"
 
 #include <stddef.h>  // for NULL
+#include <string.h>  // for memcpy
 
 // ==========================================
 // 1. 硬體相依性隔離 (Include)
 // ==========================================
 #ifndef TEST_MODE
+#include "hardware/dma.h"
 #include "hardware/irq.h"
+#include "hardware/sync.h"
 #include "hardware/uart.h"
 #include "pico/stdlib.h"
 #else
@@ -18,47 +21,350 @@
 // ==========================================
 // 2. 變數與 ISR 定義
 // ==========================================
-static uart_handle_t* g_uart0_handle = NULL;
+// 每個 port 一個 handle：ISR 依 port 查表，不再只有單一全域 handle
+static uart_handle_t* s_uart_handles[HAL_UART_PORT_COUNT];
+
+#ifdef TEST_MODE
+static uint32_t s_sim_now_us = 0;
+#endif
+
+static inline uint32_t uart_timestamp_us(void)
+{
+#ifndef TEST_MODE
+    return time_us_32();
+#else
+    return s_sim_now_us;
+#endif
+}
+
+// 所有中斷接收路徑的共同出口：一段資料只呼叫一次 span Callback
+// 沒有 span Callback 時退回舊事件：BYTE 模式逐 byte (UART_EVENT_RX_COMPLETE)，FIFO 模式整批
+static void uart_deliver_rx(uart_handle_t* h, const uint8_t* data, uint16_t len)
+{
+    if (len == 0) return;
+
+    uart_rx_span_t span = {
+        .data = data, .len = len, .port = h->id, .timestamp_us = uart_timestamp_us()};
+    if (h->span_callback)
+    {
+        h->span_callback(h->span_ctx, &span);
+        return;
+    }
+    if (h->callback == NULL) return;
+
+    if (h->rx_mode == UART_RX_MODE_FIFO)
+    {
+        h->callback(h->user_ctx, UART_EVENT_RX_SPAN, &span);
+        return;
+    }
+    for (uint16_t i = 0; i < len; i++)
+    {
+        uint8_t ch = data[i];
+        h->callback(h->user_ctx, UART_EVENT_RX_COMPLETE, &ch);
+    }
+}
+
+// DR 讀值的 bit 8..11 為該字元的 FE / PE / BE / OE (與 uart_error_t 順序相同)
+#define UART_DR_ERROR_SHIFT 8
+
+// 累計錯誤並送出 UART_EVENT_ERROR
+static void uart_record_errors(uart_handle_t* h, uint8_t flags)
+{
+    uart_error_stats_add(&h->rx_errors, flags);
+
+    if (h->callback)
+    {
+        uart_error_event_t err = {.port = h->id, .flags = flags};
+        h->callback(h->user_ctx, UART_EVENT_ERROR, &err);
+    }
+}
+
+// 檢查一次 DR 讀值的錯誤旗標；回傳 true 表示資料 byte 可以交給上層
+static bool uart_rx_accept(uart_handle_t* h, uint32_t dr)
+{
+    uint8_t flags = (uint8_t)((dr >> UART_DR_ERROR_SHIFT) & UART_ERR_ALL);
+    if (flags == 0) return true;
+
+    uart_record_errors(h, flags);
+    // overrun 代表「之後」的 byte 遺失，這個 byte 本身仍正確；其他錯誤的 byte 不可信，丟棄
+    return (flags & ~UART_ERR_OVERRUN) == 0;
+}
+
+// DMA 區塊完成通知：回報剛填滿的緩衝區，並切換到另一個
+static void uart_deliver_dma_block(uart_handle_t* h, uint8_t index, uint16_t len)
+{
+    h->dma_rx_active = index ^ 1;
+
+    if (h->span_callback)
+    {
+        if (len == 0) return;
+        uart_rx_span_t span = {.data = h->dma_rx_buffer[index],
+                               .len = len,
+                               .port = h->id,
+                               .timestamp_us = uart_timestamp_us()};
+        h->span_callback(h->span_ctx, &span);
+        return;
+    }
+
+    uart_dma_block_t block = {.len = len, .index = index, .data = h->dma_rx_buffer[index]};
+    if (h->callback)
+    {
+        h->callback(h->user_ctx, UART_EVENT_RX_DMA_COMPLETE, &block);
+    }
+}
 
 // ISR 只在非測試模式下編譯，或者在測試模式下作為空函式
 #ifndef TEST_MODE
-void on_uart_rx()
+static bool s_dma_irq_installed = false;
+
+// 錯誤中斷 (IMSC / MIS / ICR 的 bit 7..10，順序與 uart_error_t 相同)
+#define UART_ERROR_IRQ_BITS                                                          \
+    (UART_UARTIMSC_FEIM_BITS | UART_UARTIMSC_PEIM_BITS | UART_UARTIMSC_BEIM_BITS | \
+     UART_UARTIMSC_OEIM_BITS)
+
+// uart_set_irq_enables 會覆寫整個 IMSC：每次設定後再補上錯誤中斷
+static void uart_enable_irqs(uart_inst_t* uart, bool rx)
+{
+    uart_set_irq_enables(uart, rx, false);
+    hw_set_bits(&uart_get_hw(uart)->imsc, UART_ERROR_IRQ_BITS);
+}
+
+// DMA_IRQ_0 (shared)：某個 Ping-Pong channel 寫滿了
+// chain 已經自動啟動另一個 channel，這裡只需把寫滿的 channel 重新指回自己的緩衝區
+// (不觸發)，等下一次被 chain。TRANS_COUNT 會在觸發時自動重新載入。
+// 所有 port 共用同一個 handler：逐一檢查每個 handle 的兩個 channel
+static void on_uart_dma_rx(void)
 {
-    while (uart_is_readable(uart0))
+    for (uint8_t port = 0; port < HAL_UART_PORT_COUNT; port++)
     {
-        uint8_t ch = uart_getc(uart0);
-        if (g_uart0_handle && g_uart0_handle->callback)
+        uart_handle_t* h = s_uart_handles[port];
+        if (h == NULL || !h->dma_active) continue;
+
+        for (uint8_t i = 0; i < 2; i++)
         {
-            g_uart0_handle->callback(g_uart0_handle->user_ctx, UART_EVENT_RX_COMPLETE, &ch);
+            int chan = h->dma_rx_chan[i];
+            if (dma_channel_get_irq0_status(chan))
+            {
+                dma_channel_acknowledge_irq0(chan);
+                dma_channel_set_write_addr(chan, h->dma_rx_buffer[i], false);
+                uart_deliver_dma_block(h, i, h->dma_rx_len);
+            }
         }
     }
 }
+
+static void uart_dma_rx_configure(uart_handle_t* h, uint8_t index, bool trigger)
+{
+    int chan = h->dma_rx_chan[index];
+    uart_inst_t* uart = uart_get_instance(h->id);
+    dma_channel_config c = dma_channel_get_default_config(chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_read_increment(&c, false);                // 讀 UART FIFO (固定地址)
+    channel_config_set_write_increment(&c, true);                // 寫 RAM (遞增地址)
+    channel_config_set_dreq(&c, uart_get_dreq(uart, false));     // 當 UART 有資料時觸發
+    channel_config_set_chain_to(&c, h->dma_rx_chan[index ^ 1]);  // 寫滿後自動啟動另一個
+
+    dma_channel_configure(chan, &c, h->dma_rx_buffer[index], &uart_get_hw(uart)->dr,
+                          h->dma_rx_len, trigger);
+    dma_channel_set_irq0_enabled(chan, true);
+}
+
+static void uart_irq_dispatch(uint8_t port)
+{
+    uart_handle_t* h = s_uart_handles[port];
+    if (h == NULL) return;
+    uart_inst_t* uart = uart_get_instance(port);
+    uart_hw_t* hw = uart_get_hw(uart);
+
+    uint32_t mis = hw->mis;
+    if (mis & UART_ERROR_IRQ_BITS)
+    {
+        hw->icr = UART_ERROR_IRQ_BITS;
+        // DMA 模式下字元 (連同 DR 的錯誤旗標) 已被 DMA 讀走，只能依中斷狀態計數；
+        // RX 也由 DMA 負責，ISR 不能去讀 FIFO
+        if (h->dma_active)
+        {
+            uart_record_errors(h, (uint8_t)((mis >> UART_UARTMIS_FEMIS_LSB) & UART_ERR_ALL));
+            return;
+        }
+    }
+    h->rx_irq_count++;
+
+    // 直接讀 DR 清空 FIFO (BYTE 模式 FIFO 關閉，通常只有 1 byte)，整批交給 Callback
+    // 錯誤在 DR 中逐字元計數 (上面清掉的錯誤中斷不重複計算)
+    // 每次 uart_is_readable() 之後恰好讀一次 DR (host 模擬器的 FIFO pop 依賴這個順序)
+    uint8_t batch[HAL_UART_FIFO_DEPTH];
+    uint16_t n = 0;
+    while (uart_is_readable(uart))
+    {
+        uint32_t dr = hw->dr;
+        if (uart_rx_accept(h, dr)) batch[n++] = (uint8_t)dr;
+        if (n == HAL_UART_FIFO_DEPTH)
+        {
+            uart_deliver_rx(h, batch, n);
+            n = 0;
+        }
+    }
+    uart_deliver_rx(h, batch, n);
+}
+
+// 每個 port 一個 ISR 入口，只負責帶入自己的 port 編號
+static void on_uart0_irq(void)
+{
+    uart_irq_dispatch(0);
+}
+
+static void on_uart1_irq(void)
+{
+    uart_irq_dispatch(1);
+}
 #endif
 
 // ==========================================
 // 3. 函式實作 (Implementation)
 // ==========================================
 
-void HAL_UART_Init(uart_handle_t* h, uint8_t id)
+bool HAL_UART_Init(uart_handle_t* h, const uart_config_t* cfg)
 {
-    if (h == NULL) return;
-    h->id = id;
+    if (h == NULL || cfg == NULL || cfg->port >= HAL_UART_PORT_COUNT) return false;
+    if (cfg->baud < HAL_UART_BAUD_MIN || cfg->baud > HAL_UART_BAUD_MAX) return false;
+
+#ifndef TEST_MODE
+    // 這個 port 的 UART IRQ 已有別的 exclusive handler (hal_uart_dma_init)：SDK 會 panic，改回傳 false
+    uint irq_num = (cfg->port == 0) ? UART0_IRQ : UART1_IRQ;
+    irq_handler_t isr = (cfg->port == 0) ? on_uart0_irq : on_uart1_irq;
+    irq_handler_t owner = irq_get_exclusive_handler(irq_num);
+    if (owner != NULL && owner != isr) return false;
+#endif
+
+    h->id = cfg->port;
+    h->baud = cfg->baud;
     h->callback = NULL;
     h->user_ctx = NULL;
-    g_uart0_handle = h;
+    h->span_callback = NULL;
+    h->span_ctx = NULL;
+    h->rx_mode = UART_RX_MODE_BYTE;
+    h->rx_irq_count = 0;
+    h->flow = cfg->flow;
+    h->rts_pin = cfg->rts_pin;
+    h->rx_paused = false;
+    h->rx_pause_count = 0;
+    memset(&h->rx_errors, 0, sizeof(h->rx_errors));
+    h->dma_rx_buffer[0] = NULL;
+    h->dma_rx_buffer[1] = NULL;
+    h->dma_rx_len = 0;
+    h->dma_rx_active = 0;
+    h->dma_active = false;
+    h->dma_rx_chan[0] = -1;
+    h->dma_rx_chan[1] = -1;
+
+    // 登記到 handle table (同一個 handle 換 port 時先清掉舊的位置)
+    for (uint8_t port = 0; port < HAL_UART_PORT_COUNT; port++)
+    {
+        if (s_uart_handles[port] == h) s_uart_handles[port] = NULL;
+    }
+    s_uart_handles[cfg->port] = h;
 
     // 🟢 關鍵：只有在韌體模式下才呼叫硬體初始化
 #ifndef TEST_MODE
-    uart_init(uart0, 115200);
-    gpio_set_function(0, GPIO_FUNC_UART);
-    gpio_set_function(1, GPIO_FUNC_UART);
-    uart_set_hw_flow(uart0, false, false);
-    uart_set_format(uart0, 8, 1, UART_PARITY_NONE);
-    uart_set_fifo_enabled(uart0, false);
+    uart_inst_t* uart = uart_get_instance(cfg->port);
+    h->baud = uart_init(uart, cfg->baud);
+    gpio_set_function(cfg->tx_pin, GPIO_FUNC_UART);
+    gpio_set_function(cfg->rx_pin, GPIO_FUNC_UART);
+    uart_set_format(uart, 8, 1, UART_PARITY_NONE);
+    uart_set_fifo_enabled(uart, false);
+
+    // 流量控制：CTS 一律交給硬體 (對端要求暫停時 UART 自動停止送出)；
+    // RTS 在 RTS_CTS 模式由 RX FIFO 水位自動控制，在 SW_RTS 模式改為 GPIO 由軟體驅動
+    if (cfg->flow != UART_FLOW_NONE)
+    {
+        gpio_set_function(cfg->cts_pin, GPIO_FUNC_UART);
+    }
+    if (cfg->flow == UART_FLOW_RTS_CTS)
+    {
+        gpio_set_function(cfg->rts_pin, GPIO_FUNC_UART);
+    }
+    else if (cfg->flow == UART_FLOW_SW_RTS)
+    {
+        gpio_init(cfg->rts_pin);
+        gpio_set_dir(cfg->rts_pin, GPIO_OUT);
+        gpio_put(cfg->rts_pin, 0);  // active-low：一開始允許對端傳送
+    }
+    uart_set_hw_flow(uart, cfg->flow != UART_FLOW_NONE, cfg->flow == UART_FLOW_RTS_CTS);
+
+    irq_set_exclusive_handler(irq_num, isr);
+    irq_set_enabled(irq_num, true);
+    uart_enable_irqs(uart, true);
+#endif
+
+    // 接收模式：DMA 優先，否則依 rx_mode 使用中斷接收
+    if (cfg->dma_rx_buf != NULL)
+    {
+        HAL_UART_Receive_DMA(h, cfg->dma_rx_buf, cfg->dma_rx_size);
+    }
+    else if (cfg->rx_mode != UART_RX_MODE_BYTE)
+    {
+        HAL_UART_SetRxMode(h, cfg->rx_mode);
+    }
+    return true;
+}
+
+uart_handle_t* HAL_UART_GetHandle(uint8_t port)
+{
+    return (port < HAL_UART_PORT_COUNT) ? s_uart_handles[port] : NULL;
+}
+
+uint32_t HAL_UART_SetBaud(uart_handle_t* h, uint32_t baud)
+{
+    if (h == NULL || baud < HAL_UART_BAUD_MIN || baud > HAL_UART_BAUD_MAX) return 0;
+
+#ifndef TEST_MODE
+    h->baud = uart_set_baudrate(uart_get_instance(h->id), baud);
+#else
+    h->baud = baud;
+#endif
+    return h->baud;
+}
 
-    irq_set_exclusive_handler(UART0_IRQ, on_uart_rx);
-    irq_set_enabled(UART0_IRQ, true);
-    uart_set_irq_enables(uart0, true, false);
+void HAL_UART_SetRxReady(uart_handle_t* h, bool ready)
+{
+    if (h == NULL || h->flow != UART_FLOW_SW_RTS || h->rx_paused == !ready) return;
+
+    h->rx_paused = !ready;
+    if (!ready) h->rx_pause_count++;
+#ifndef TEST_MODE
+    gpio_put(h->rts_pin, !ready);
+#endif
+}
+
+void HAL_UART_RtsWatermark(void* ctx, bool above_high)
+{
+    HAL_UART_SetRxReady((uart_handle_t*)ctx, !above_high);
+}
+
+void HAL_UART_GetErrorStats(uart_handle_t* h, uart_error_stats_t* out, bool clear)
+{
+    if (h == NULL || out == NULL) return;
+
+    // 與 ISR 同時更新：複製期間關中斷，避免拿到一半新、一半舊的計數
+#ifndef TEST_MODE
+    uint32_t irq_state = save_and_disable_interrupts();
+#endif
+    *out = h->rx_errors;
+    if (clear) memset(&h->rx_errors, 0, sizeof(h->rx_errors));
+#ifndef TEST_MODE
+    restore_interrupts(irq_state);
+#endif
+}
+
+bool HAL_UART_IsTxIdle(uart_handle_t* h)
+{
+    if (h == NULL) return true;
+#ifndef TEST_MODE
+    // BUSY 在 TX FIFO 非空或 shift register 仍在送出時為 1
+    return (uart_get_hw(uart_get_instance(h->id))->fr & UART_UARTFR_BUSY_BITS) == 0;
+#else
+    return true;
 #endif
 }
 
@@ -71,44 +377,179 @@ void HAL_UART_RegisterCallback(uart_handle_t* h, uart_callback_t cb, void* ctx)
     }
 }
 
+void HAL_UART_RegisterSpanCallback(uart_handle_t* h, uart_span_callback_t cb, void* ctx)
+{
+    if (h)
+    {
+        h->span_callback = cb;
+        h->span_ctx = ctx;
+    }
+}
+
+void HAL_UART_SetRxMode(uart_handle_t* h, uart_rx_mode_t mode)
+{
+    if (h == NULL) return;
+    h->rx_mode = mode;
+
+#ifndef TEST_MODE
+    uart_inst_t* uart = uart_get_instance(h->id);
+    uart_set_fifo_enabled(uart, mode == UART_RX_MODE_FIFO);
+
+    // 同時啟用 RX (level) 與 RT (timeout) 中斷 (以及錯誤中斷)
+    uart_enable_irqs(uart, true);
+    if (mode == UART_RX_MODE_FIFO)
+    {
+        // uart_set_irq_enables 會把 RX 門檻設回 1/8；FIFO 模式改為 1/2 (16 bytes)
+        hw_write_masked(&uart_get_hw(uart)->ifls, 2u << UART_UARTIFLS_RXIFLSEL_LSB,
+                        UART_UARTIFLS_RXIFLSEL_BITS);
+    }
+#endif
+}
+
 void HAL_UART_Send(uart_handle_t* h, const uint8_t* data, uint16_t len)
 {
 #ifndef TEST_MODE
-    uart_write_blocking(uart0, data, len);
+    uart_write_blocking(uart_get_instance(h->id), data, len);
 #endif
 }
 
-void HAL_UART_Receive_DMA(uart_handle_t* h, uint8_t* pData, uint16_t Size)
+void HAL_UART_Receive_DMA_DoubleBuffer(uart_handle_t* h, uint8_t* buf0, uint8_t* buf1,
+                                       uint16_t Size)
 {
-#ifdef TEST_MODE
-    // 在測試模式下，我們只需要記錄「使用者想把資料搬到哪裡」
-    // 假設 uart_handle_t 結構裡有這些模擬欄位
-    // 如果沒有，您需要在 hal_uart.h 的 struct 裡補上：
-    // uint8_t* dma_rx_buffer;
-    // uint16_t dma_rx_len;
-
-    // 這裡為了讓 Linker 過關，如果您還沒加欄位，可以先留空，
-    // 但為了功能驗證，建議補上：
-    // h->dma_rx_buffer = pData;
-    // h->dma_rx_len = Size;
-#else
-    // 真實硬體實作 (呼叫 dma_channel_config 等等)
-    // 這裡可以先留空，或是呼叫 Pico SDK
+    if (h == NULL || buf0 == NULL || buf1 == NULL || Size == 0) return;
+
+    h->dma_rx_buffer[0] = buf0;
+    h->dma_rx_buffer[1] = buf1;
+    h->dma_rx_len = Size;
+    h->dma_rx_active = 0;
+    h->dma_active = true;
+
+#ifndef TEST_MODE
+    // 1. 申請兩個 channel (每個 handle 只在第一次)；DMA_IRQ_0 handler 所有 port 共用，只裝一次
+    if (h->dma_rx_chan[0] < 0)
+    {
+        h->dma_rx_chan[0] = dma_claim_unused_channel(true);
+        h->dma_rx_chan[1] = dma_claim_unused_channel(true);
+    }
+    if (!s_dma_irq_installed)
+    {
+        irq_add_shared_handler(DMA_IRQ_0, on_uart_dma_rx,
+                               PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(DMA_IRQ_0, true);
+        s_dma_irq_installed = true;
+    }
+
+    // 2. RX 改由 DMA 接手：關閉 RX 中斷 (否則 ISR 會搶走 FIFO 的資料)，只保留錯誤中斷；
+    //    開啟 FIFO 吸收延遲
+    uart_enable_irqs(uart_get_instance(h->id), false);
+    uart_set_fifo_enabled(uart_get_instance(h->id), true);
+
+    // 3. channel 1 先設定好等待 chain，再啟動 channel 0
+    uart_dma_rx_configure(h, 1, false);
+    uart_dma_rx_configure(h, 0, true);
 #endif
 }
 
+void HAL_UART_Receive_DMA(uart_handle_t* h, uint8_t* pData, uint16_t Size)
+{
+    if (pData == NULL) return;
+
+    // 與 STM32 Circular DMA 的 Half/Full Complete 相同：前半與後半交替
+    uint16_t half = Size / 2;
+    HAL_UART_Receive_DMA_DoubleBuffer(h, pData, pData + half, half);
+}
+
 // 模擬 DMA 完成中斷 (測試用)
 #ifdef TEST_MODE
 void HAL_UART_SimulateDMA_Complete(uart_handle_t* h, const uint8_t* mock_data, uint16_t len)
 {
-    // 1. 模擬硬體搬運 (memcpy)
-    // if (h->dma_rx_buffer) memcpy(h->dma_rx_buffer, mock_data, len);
+    if (h == NULL) return;
+
+    if (!h->dma_active)
+    {
+        // 尚未啟動 DMA：只觸發舊的事件 Callback (沒有緩衝區可寫)
+        uart_dma_block_t block = {.len = len, .index = 0, .data = NULL};
+        if (h->callback)
+        {
+            h->callback(h->user_ctx, UART_EVENT_RX_DMA_COMPLETE, &block);
+        }
+        return;
+    }
 
-    // 2. 觸發 Callback
-    if (h && h->callback)
+    // 1. 模擬硬體搬運：寫入目前的緩衝區，最多 dma_rx_len bytes
+    uint8_t index = h->dma_rx_active;
+    if (len > h->dma_rx_len)
     {
-        // 注意：這裡傳入 len 的地址，對應測試裡的 *(uint16_t*)data
-        h->callback(h->user_ctx, UART_EVENT_RX_DMA_COMPLETE, &len);
+        len = h->dma_rx_len;
     }
+    if (mock_data)
+    {
+        memcpy(h->dma_rx_buffer[index], mock_data, len);
+    }
+
+    // 2. 觸發 Callback 並切換到另一個緩衝區
+    uart_deliver_dma_block(h, index, len);
+}
+#endif
+
+// 模擬 RX 中斷 (測試用)
+#ifdef TEST_MODE
+void HAL_UART_SimulateISR(uart_handle_t* h, uint8_t rx_data)
+{
+    if (h == NULL) return;
+    h->rx_irq_count++;
+    uart_deliver_rx(h, &rx_data, 1);
+}
+
+void HAL_UART_SimulateSetTime(uint32_t now_us)
+{
+    s_sim_now_us = now_us;
 }
-#endif
\ No newline at end of file
+
+void HAL_UART_SimulateRxError(uart_handle_t* h, uint8_t rx_data, uint8_t flags)
+{
+    if (h == NULL) return;
+    h->rx_irq_count++;
+
+    // 與 uart_irq_dispatch 相同：組成 DR 讀值後經過同一個錯誤檢查
+    uint32_t dr = rx_data | ((uint32_t)(flags & UART_ERR_ALL) << UART_DR_ERROR_SHIFT);
+    if (uart_rx_accept(h, dr)) uart_deliver_rx(h, &rx_data, 1);
+}
+
+void HAL_UART_SimulateErrorIrq(uart_handle_t* h, uint8_t flags)
+{
+    if (h == NULL || !h->dma_active) return;
+    uart_record_errors(h, flags & UART_ERR_ALL);
+}
+
+void HAL_UART_SimulatePortRx(uint8_t port, const uint8_t* data, uint16_t len)
+{
+    // 與 uart_irq_dispatch 相同：由 port 查表，沒有登記的 port 直接忽略
+    HAL_UART_SimulateFifoRx(HAL_UART_GetHandle(port), data, len);
+}
+
+void HAL_UART_SimulateFifoRx(uart_handle_t* h, const uint8_t* data, uint16_t len)
+{
+    if (h == NULL) return;
+
+    if (h->rx_mode != UART_RX_MODE_FIFO)
+    {
+        // Byte 模式：每個 byte 都是一次中斷
+        for (uint16_t i = 0; i < len; i++)
+        {
+            HAL_UART_SimulateISR(h, data[i]);
+        }
+        return;
+    }
+
+    // FIFO 模式：最多 HAL_UART_FIFO_DEPTH bytes 合併成一次中斷
+    while (len > 0)
+    {
+        uint16_t n = (len > HAL_UART_FIFO_DEPTH) ? HAL_UART_FIFO_DEPTH : len;
+        h->rx_irq_count++;
+        uart_deliver_rx(h, data, n);
+        data += n;
+        len -= n;
+    }
+}
+#endif
@@ -2,42 +2,246 @@
 #define HAL_UART_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 // 1. 新增 DMA 事件
 typedef enum
 {
-    UART_EVENT_RX_COMPLETE,      // 單字節接收 (Byte IRQ)
+    UART_EVENT_RX_COMPLETE,      // 單字節接收 (Byte IRQ；相容用，新程式請改用 span Callback)
     UART_EVENT_RX_DMA_COMPLETE,  // DMA 區塊接收完成 (Block IRQ) <-- NEW
     UART_EVENT_TX_COMPLETE,
-    UART_EVENT_ERROR
+    UART_EVENT_ERROR,            // 接收錯誤 (data 為 uart_error_event_t*)
+    UART_EVENT_RX_SPAN  // FIFO 批次接收 (data 為 uart_rx_span_t*)
 } uart_event_t;
 
+// 2. RX 中斷模式
+typedef enum
+{
+    UART_RX_MODE_BYTE = 0,  // 關閉 FIFO，每個 byte 一次中斷 + 一次 Callback (預設，相容舊行為)
+    UART_RX_MODE_FIFO       // 開啟 FIFO，RX level / RX timeout 中斷，一次 ISR 清空 FIFO
+} uart_rx_mode_t;
+
+// 3. 流量控制
+typedef enum
+{
+    UART_FLOW_NONE = 0,  // 不做流量控制 (預設)
+    UART_FLOW_RTS_CTS,   // 硬體 RTS/CTS：RTS 依 UART RX FIFO 水位自動控制
+    UART_FLOW_SW_RTS     // 硬體 CTS + 軟體 RTS (GPIO)：由應用層 buffer 的水位決定何時暫停對端
+} uart_flow_t;
+
+// 4. 接收錯誤 (bitmask；順序與 PL011 DR[11:8] 的 FE / PE / BE / OE 相同)
+typedef enum
+{
+    UART_ERR_FRAMING = 1u << 0,  // 停止位不是 1 (baud 不符或雜訊)
+    UART_ERR_PARITY = 1u << 1,
+    UART_ERR_BREAK = 1u << 2,    // 線路維持低電位超過一個字元時間
+    UART_ERR_OVERRUN = 1u << 3   // 硬體 FIFO 已滿又收到新 byte (ISR / DMA 來不及取走)
+} uart_error_t;
+
+#define UART_ERR_ALL (UART_ERR_FRAMING | UART_ERR_PARITY | UART_ERR_BREAK | UART_ERR_OVERRUN)
+
+// UART_EVENT_ERROR 的資料
+typedef struct
+{
+    uint8_t port;
+    uint8_t flags;  // uart_error_t bitmask
+} uart_error_event_t;
+
+// 各類接收錯誤的累計次數 (硬體層；應用層 buffer 滿了丟資料另外計算)
+typedef struct
+{
+    uint32_t framing;
+    uint32_t parity;
+    uint32_t breaks;
+    uint32_t overrun;
+} uart_error_stats_t;
+
+// 依 uart_error_t bitmask 累加統計 (hal_uart / hal_uart_dma 共用)
+static inline void uart_error_stats_add(uart_error_stats_t* s, uint8_t flags)
+{
+    if (flags & UART_ERR_FRAMING) s->framing++;
+    if (flags & UART_ERR_PARITY) s->parity++;
+    if (flags & UART_ERR_BREAK) s->breaks++;
+    if (flags & UART_ERR_OVERRUN) s->overrun++;
+}
+
+// RP2350 UART 硬體 FIFO 深度
+#define HAL_UART_FIFO_DEPTH 32
+
+// 支援的 UART 埠數 (RP2350: uart0 / uart1)
+#define HAL_UART_PORT_COUNT 2
+
+// 可設定的 baud 範圍：PL011 每個 bit 取樣 16 次，上限 = clk_peri (150 MHz) / 16
+#define HAL_UART_BAUD_MIN 300u
+#define HAL_UART_BAUD_MAX 9375000u
+
+// 5. 初始化設定 (每個 port 一份)
+typedef struct
+{
+    uint8_t port;            // 0 = uart0, 1 = uart1
+    uint8_t tx_pin;
+    uint8_t rx_pin;
+    uint32_t baud;
+    uart_rx_mode_t rx_mode;  // 中斷接收模式 (BYTE / FIFO)
+    uint8_t* dma_rx_buf;     // 非 NULL 時改用 Ping-Pong DMA 接收 (同 HAL_UART_Receive_DMA)
+    uint16_t dma_rx_size;
+    uart_flow_t flow;        // 流量控制模式
+    uint8_t cts_pin;         // UART_FLOW_RTS_CTS / UART_FLOW_SW_RTS 使用
+    uint8_t rts_pin;
+} uart_config_t;
+
+// 與舊版 HAL_UART_Init(h, 0) 相同的設定：uart0, GP0/GP1, 115200, 逐 byte 中斷
+#define HAL_UART_CONFIG_DEFAULT                                                         \
+    {.port = 0, .tx_pin = 0, .rx_pin = 1, .baud = 115200, .rx_mode = UART_RX_MODE_BYTE, \
+     .dma_rx_buf = NULL, .dma_rx_size = 0, .flow = UART_FLOW_NONE}
+
+// 一段連續的 RX 資料：span Callback 與 UART_EVENT_RX_SPAN 共用 (僅在 Callback 期間有效)
+typedef struct
+{
+    const uint8_t* data;
+    uint16_t len;
+    uint8_t port;           // 來源 port (0 / 1)
+    uint32_t timestamp_us;  // ISR / DMA 交出這段資料的時間 (time_us_32)
+} uart_rx_span_t;
+
+// UART_EVENT_RX_DMA_COMPLETE 的資料：剛填滿的 Ping-Pong 緩衝區
+// len 必須是第一個欄位，舊的 Callback 以 *(uint16_t*)data 讀取長度仍然相容
+typedef struct
+{
+    uint16_t len;         // 收到的 byte 數
+    uint8_t index;        // 0 / 1：哪一個緩衝區
+    const uint8_t* data;  // 緩衝區位址 (在另一個緩衝區填滿前可安全讀取)
+} uart_dma_block_t;
+
 typedef void (*uart_callback_t)(void* ctx, uart_event_t event, void* data);
 
+/**
+ * @brief RX span Callback：不分 BYTE / FIFO / DMA 模式，每次交出一整段資料
+ * @details 呼叫端不必再依 event 判斷 data 的型別，可以直接 rb_write / evq_push_span 一次寫入。
+ */
+typedef void (*uart_span_callback_t)(void* ctx, const uart_rx_span_t* span);
+
 typedef struct
 {
-    uint8_t id;
+    uint8_t id;     // port 編號 (0 / 1)
+    uint32_t baud;  // 實際設定的 baud rate (硬體分頻後)
     uart_callback_t callback;
     void* user_ctx;
+    uart_span_callback_t span_callback;  // 有註冊時 RX 資料改走這裡
+    void* span_ctx;
+    uart_rx_mode_t rx_mode;
+    uint32_t rx_irq_count;  // RX 中斷次數 (用來驗證批次模式減少的中斷量)
+
+    // --- 流量控制 ---
+    uart_flow_t flow;
+    uint8_t rts_pin;
+    bool rx_paused;           // 軟體 RTS 目前是否要求對端暫停
+    uint32_t rx_pause_count;  // 暫停次數 (觀察應用層是否經常跟不上)
 
-    // --- DMA 模擬參數 (Internal State) ---
-    uint8_t* dma_rx_buffer;  // 目標記憶體地址
-    uint16_t dma_rx_len;     // 預期接收長度
-    bool dma_active;         // DMA 是否開啟中
+    uart_error_stats_t rx_errors;  // 接收錯誤統計 (在 ISR 中累加)
+
+    // --- DMA Ping-Pong 接收 (Internal State) ---
+    uint8_t* dma_rx_buffer[2];  // 兩個交替使用的目標緩衝區
+    uint16_t dma_rx_len;        // 每個緩衝區的長度
+    uint8_t dma_rx_active;      // DMA 目前正在寫入的緩衝區 index
+    bool dma_active;            // DMA 是否開啟中
+    int dma_rx_chan[2];         // 兩個互相 chain 的 DMA channel (-1 = 尚未申請)
 } uart_handle_t;
 
-void HAL_UART_Init(uart_handle_t* h, uint8_t id);
+/**
+ * @brief 依設定初始化一個 UART port，並把 handle 登記到該 port 的 handle table
+ * @details 每個 port 有自己的 ISR，中斷時依 port 查表找到對應的 handle，
+ *          所以 uart0 / uart1 可以同時以不同設定運作。同一個 port 重新 Init 會取代舊 handle。
+ *          h 必須在使用期間保持有效 (通常為 static)。
+ *          已交給 hal_uart_dma_init 的 port 不能再 Init (兩個驅動不能共用一個 port)。
+ * @return false 表示參數錯誤 (NULL、port 超出範圍或 baud 不在 HAL_UART_BAUD_MIN..MAX)，
+ *         或該 port 已被 hal_uart_dma 使用
+ */
+bool HAL_UART_Init(uart_handle_t* h, const uart_config_t* cfg);
+
+/**
+ * @brief 取得某個 port 目前登記的 handle (未初始化回傳 NULL)
+ */
+uart_handle_t* HAL_UART_GetHandle(uint8_t port);
+
+/**
+ * @brief 執行期間切換 baud rate (立即生效，呼叫前應先確認 HAL_UART_IsTxIdle)
+ * @return 實際設定的 baud (硬體分頻後)，超出範圍回傳 0 且不變更
+ */
+uint32_t HAL_UART_SetBaud(uart_handle_t* h, uint32_t baud);
+
+/**
+ * @brief 軟體 RTS：告訴對端是否可以繼續送 (只在 UART_FLOW_SW_RTS 下有作用)
+ * @details RTS 為 active-low：ready = true 拉低 (允許傳送)，false 拉高 (要求暫停)。
+ *          可在 ISR 中呼叫。
+ */
+void HAL_UART_SetRxReady(uart_handle_t* h, bool ready);
+
+/**
+ * @brief 可直接註冊為 ring buffer watermark Callback 的 RTS 控制 (ctx = uart_handle_t*)
+ * @details rb_set_watermarks(&rb, high, low, HAL_UART_RtsWatermark, &h_uart)：
+ *          佔用量達到 high 時暫停對端，回落到 low 時恢復，取代 buffer 滿時直接丟資料。
+ */
+void HAL_UART_RtsWatermark(void* ctx, bool above_high);
+
+/**
+ * @brief 取得接收錯誤統計 (framing / parity / break / overrun)
+ * @details 中斷接收模式以每個錯誤字元計數；DMA 模式下 DR 的錯誤旗標被 DMA 讀走，
+ *          改由 UART 錯誤中斷計數 (每次中斷一次)。
+ * @param clear true 則讀取後歸零
+ */
+void HAL_UART_GetErrorStats(uart_handle_t* h, uart_error_stats_t* out, bool clear);
+
+/**
+ * @brief TX FIFO 已清空且最後一個 bit 已送出 (切換 baud 前的安全點)
+ */
+bool HAL_UART_IsTxIdle(uart_handle_t* h);
 void HAL_UART_RegisterCallback(uart_handle_t* h, uart_callback_t cb, void* ctx);
 
+/**
+ * @brief 註冊 RX span Callback (BYTE / FIFO / DMA 三種接收路徑共用)
+ * @details 註冊後所有 RX 資料都以 uart_rx_span_t 交給 cb，不再送出 UART_EVENT_RX_COMPLETE /
+ *          RX_SPAN / RX_DMA_COMPLETE；其他事件 (TX / ERROR) 仍走 HAL_UART_RegisterCallback。
+ *          傳入 NULL 則回到舊的事件 Callback (BYTE 模式逐 byte 送出 UART_EVENT_RX_COMPLETE)。
+ */
+void HAL_UART_RegisterSpanCallback(uart_handle_t* h, uart_span_callback_t cb, void* ctx);
+
+/**
+ * @brief 切換 RX 中斷模式
+ * @details FIFO 模式下 RX level 設為 1/2 (16 bytes)，加上 RX timeout (32 bit 時間無新資料)
+ *          中斷處理尾端不足 16 bytes 的資料；每次 ISR 以一個 UART_EVENT_RX_SPAN 送出整批。
+ */
+void HAL_UART_SetRxMode(uart_handle_t* h, uart_rx_mode_t mode);
+
 // --- DMA API ---
-// 告訴硬體：「請把接下來收到的資料，自動搬到 pData，搬完 Size 個才叫我」
+/**
+ * @brief 啟動 Ping-Pong DMA 接收 (兩個 DMA channel 互相 chain，交替寫入 buf0 / buf1)
+ * @details 每填滿一個緩衝區就發出 UART_EVENT_RX_DMA_COMPLETE (data 為 uart_dma_block_t*)，
+ *          此時另一個緩衝區已經在接收，處理期間不會掉資料。
+ *          DMA 模式會關閉 UART RX 中斷並開啟 FIFO。
+ */
+void HAL_UART_Receive_DMA_DoubleBuffer(uart_handle_t* h, uint8_t* buf0, uint8_t* buf1,
+                                       uint16_t Size);
+
+// 告訴硬體：「請把接下來收到的資料，自動搬到 pData」
+// pData 切成前後兩半做 Ping-Pong，每填滿 Size / 2 bytes 通知一次
 void HAL_UART_Receive_DMA(uart_handle_t* h, uint8_t* pData, uint16_t Size);
 
 // --- 模擬器 ---
 void HAL_UART_SimulateISR(uart_handle_t* h, uint8_t rx_data);
-// 模擬 DMA 搬運完成
+// 模擬 FIFO 模式下硬體收到 len bytes (每 HAL_UART_FIFO_DEPTH bytes 觸發一次 ISR)
+void HAL_UART_SimulateFifoRx(uart_handle_t* h, const uint8_t* data, uint16_t len);
+// 模擬 DMA 搬運完成：mock_data 會複製到目前的緩衝區 (NULL 表示資料已由測試直接寫入)
 void HAL_UART_SimulateDMA_Complete(uart_handle_t* h, const uint8_t* mock_data, uint16_t len);
+// 模擬某個 port 的 UART 中斷：與硬體 ISR 相同，經由 handle table 找到 handle
+void HAL_UART_SimulatePortRx(uint8_t port, const uint8_t* data, uint16_t len);
+// 設定模擬時鐘 (span 的 timestamp_us)
+void HAL_UART_SimulateSetTime(uint32_t now_us);
+// 模擬 RX ISR 讀到一個帶有錯誤旗標 (uart_error_t) 的字元
+void HAL_UART_SimulateRxError(uart_handle_t* h, uint8_t rx_data, uint8_t flags);
+// 模擬 DMA 模式下的 UART 錯誤中斷 (沒有字元資料，只有錯誤旗標)
+void HAL_UART_SimulateErrorIrq(uart_handle_t* h, uint8_t flags);
 
 void HAL_UART_Send(uart_handle_t* h, const uint8_t* data, uint16_t len);
 #endif  // HAL_UART_H
\ No newline at end of file
@@ -1,106 +1,547 @@
 /* src/hal/hal_uart_dma.c */
 #include "hal_uart_dma.h"
 
+#include <string.h>
+
 #include "hardware/dma.h"
 #include "hardware/irq.h"
+#include "hardware/sync.h"
 #include "hardware/uart.h"
 #include "pico/stdlib.h"
-
-// --- 硬體參數設定 ---
-#define UART_ID uart0
-#define BAUD_RATE 115200
-#define UART_TX_PIN 0  // 請確認你的腳位
-#define UART_RX_PIN 1
+#include "ring_buffer.h"
 
 // --- 靜態變數 (內部狀態) ---
+static uart_inst_t* dma_uart = NULL;  // 由 hal_uart_dma_init 的設定決定 (uart0 / uart1)
+static uint8_t dma_port = 0;
 static int dma_tx_chan = -1;
 static int dma_rx_chan = -1;
 
-// RX 環形緩衝區：必須對齊其大小 (256 bytes)
-static uint8_t __attribute__((aligned(UART_DMA_BUFFER_SIZE))) rx_ring_buffer[UART_DMA_BUFFER_SIZE];
+static int dma_rx_ctrl_chan = -1;  // 負責在 RX 傳輸次數用完時重新啟動 dma_rx_chan
+static bool dma_initialised = false;  // 重新 init 前先釋放 channel 與 IRQ handler
+
+_Static_assert(UART_DMA_RING_BITS >= 1 && UART_DMA_RING_BITS <= 15,
+               "DMA ring wrap supports 2^1 .. 2^15 bytes");
+_Static_assert((UART_DMA_RX_REARM_BLOCK & (UART_DMA_RX_REARM_BLOCK - 1)) == 0 &&
+                   UART_DMA_RX_REARM_BLOCK >= UART_DMA_BUFFER_SIZE,
+               "UART_DMA_RX_REARM_BLOCK must be a power of 2 >= UART_DMA_BUFFER_SIZE");
+_Static_assert(UART_DMA_BUFFER_SIZE / 2u + UART_DMA_TICK_BYTES <=
+                   UART_DMA_BUFFER_SIZE - UART_DMA_OVERRUN_MARGIN,
+               "ring too small: half-full threshold plus one tick of data must fit");
+_Static_assert(UART_DMA_OVERRUN_MARGIN < UART_DMA_BUFFER_SIZE,
+               "UART_DMA_OVERRUN_MARGIN must leave part of the ring readable");
+
+// RX 環形緩衝區：DMA ring wrap 只看低位址 bits，所以必須對齊其大小
+static _Alignas(UART_DMA_BUFFER_SIZE) uint8_t rx_ring_buffer[UART_DMA_BUFFER_SIZE];
+_Static_assert(__alignof__(rx_ring_buffer) >= UART_DMA_BUFFER_SIZE,
+               "RX ring must be aligned to its size for DMA ring wrap");
+
+// 絕對計數 (free-running，自然溢位)：
+// rx_read_total = 已讀取的 byte 總數；DMA 已寫入的總數由 rx_hw_write_total() 推算
+static uint32_t rx_read_total = 0;
+static uint32_t rx_last_hw_total = 0;  // 上次觀察到的寫入總數 (只會前進)
+static uint32_t rx_lost = 0;
+static uart_error_stats_t rx_errors;  // UART 硬體錯誤 (在 UART 錯誤中斷中累加)
+
+// UART 錯誤中斷 (IMSC / MIS / ICR 的 bit 7..10，順序與 uart_error_t 相同)
+#define UART_DMA_ERROR_IRQ_BITS                                                      \
+    (UART_UARTIMSC_FEIM_BITS | UART_UARTIMSC_PEIM_BITS | UART_UARTIMSC_BEIM_BITS | \
+     UART_UARTIMSC_OEIM_BITS)
+
+// control channel 每重新裝填一次就 +1 (在 DMA_IRQ_1 中更新)
+static volatile uint32_t rx_rearm_epoch = 0;
+
+// control channel 讀取此值寫入 dma_rx_chan 的 transfer count (並觸發)
+static const uint32_t rx_rearm_count = UART_DMA_RX_REARM_BLOCK;
+
+// Idle-line 偵測狀態
+static hal_uart_dma_idle_cb_t rx_idle_cb = NULL;
+static uart_span_callback_t rx_span_cb = NULL;  // 與 rx_idle_cb 二擇一，共用 rx_idle_ctx
+static void* rx_idle_ctx = NULL;
+static uint32_t rx_idle_last_total = 0;  // 上一個 tick 看到的寫入總數
+static repeating_timer_t rx_idle_timer;
+static bool rx_idle_timer_running = false;
+static uint32_t rx_idle_tick_us = UART_DMA_IDLE_TICK_US;  // 依 baud 計算 (rx_tick_for_baud)
+
+// 流量控制狀態
+static uart_flow_t dma_flow = UART_FLOW_NONE;
+static uint8_t dma_rts_pin = 0;
+static volatile bool rx_rts_paused = false;
 
-// 軟體讀取指標 (追蹤我們讀到哪裡了)
-static uint32_t rx_read_index = 0;
+static void rx_timer_update(void);  // 定義於 Idle-line 偵測區段
+static void rx_timer_set_baud(uint32_t baud);
 
-bool hal_uart_dma_init(void)
+// RP2350 的 TRANS_COUNT 高 4 bits 為 MODE 欄位，計數只看低 28 bits
+#define RX_TRANS_COUNT_MASK 0x0FFFFFFFu
+
+// TX 佇列：Producer = hal_uart_dma_send (主程式)，Consumer = DMA 完成中斷
+static ring_buffer_t tx_queue;
+static uint8_t tx_storage[UART_DMA_TX_QUEUE_SIZE];
+static volatile uint32_t tx_inflight = 0;  // 目前 DMA 正在搬運的 byte 數 (0 = 閒置)
+
+// 從 TX 佇列取出下一段連續資料交給 DMA
+// 只能在 DMA 中斷內或關中斷的情況下呼叫
+static void tx_start_next(void)
 {
-    // 1. 初始化 UART
-    uart_init(UART_ID, BAUD_RATE);
-    gpio_set_function(UART_TX_PIN, GPIO_FUNC_UART);
-    gpio_set_function(UART_RX_PIN, GPIO_FUNC_UART);
+    const uint8_t* span;
+    uint32_t n = rb_peek_contiguous(&tx_queue, &span);
+
+    tx_inflight = n;
+    if (n > 0)
+    {
+        dma_channel_transfer_from_buffer_now(dma_tx_chan, span, n);
+    }
+}
+
+// DMA_IRQ_1 (shared)：RX control channel 已重新裝填 dma_rx_chan → 進入下一個 block
+static void on_dma_rx_rearm(void)
+{
+    if (!dma_channel_get_irq1_status(dma_rx_ctrl_chan)) return;
+    dma_channel_acknowledge_irq1(dma_rx_ctrl_chan);
+
+    rx_rearm_epoch++;
+}
+
+// DMA_IRQ_1 (shared)：TX 傳輸完成 → 釋放已送出的部分，接續下一段
+static void on_dma_tx_complete(void)
+{
+    if (!dma_channel_get_irq1_status(dma_tx_chan)) return;
+    dma_channel_acknowledge_irq1(dma_tx_chan);
+
+    rb_consume(&tx_queue, tx_inflight);
+    tx_start_next();
+}
+
+// UART 錯誤中斷：RX 資料由 DMA 讀走，這裡只計數，不能碰 FIFO
+static void on_dma_uart_error(void)
+{
+    uart_hw_t* hw = uart_get_hw(dma_uart);
+    uint32_t mis = hw->mis;
+    hw->icr = mis & UART_DMA_ERROR_IRQ_BITS;
+    uart_error_stats_add(&rx_errors, (uint8_t)((mis >> UART_UARTMIS_FEMIS_LSB) & UART_ERR_ALL));
+}
+
+// 歸還已申請的 DMA channel (申請到一半失敗時也會呼叫)
+static void release_channels(void)
+{
+    int* chans[] = {&dma_rx_ctrl_chan, &dma_rx_chan, &dma_tx_chan};
+    for (size_t i = 0; i < sizeof(chans) / sizeof(chans[0]); i++)
+    {
+        if (*chans[i] < 0) continue;
+        dma_channel_abort(*chans[i]);
+        dma_channel_unclaim(*chans[i]);
+        *chans[i] = -1;
+    }
+}
+
+void hal_uart_dma_deinit(void)
+{
+    if (!dma_initialised) return;
+    dma_initialised = false;
 
-    // 關鍵：關閉 Flow Control，開啟 FIFO (DMA 需要 FIFO DREQ 訊號)
-    uart_set_hw_flow(UART_ID, false, false);
-    uart_set_format(UART_ID, 8, 1, UART_PARITY_NONE);
-    uart_set_fifo_enabled(UART_ID, true);
+    // 停掉 idle / RTS timer
+    rx_idle_cb = NULL;
+    rx_span_cb = NULL;
+    dma_flow = UART_FLOW_NONE;
+    rx_timer_update();
+
+    uint irq_num = (dma_port == 0) ? UART0_IRQ : UART1_IRQ;
+    irq_set_enabled(irq_num, false);
+    hw_clear_bits(&uart_get_hw(dma_uart)->imsc, UART_DMA_ERROR_IRQ_BITS);
+    irq_remove_handler(irq_num, on_dma_uart_error);
+
+    // DMA_IRQ_1 是共用的 (其他驅動可能也在用)：只移除自己的 handler，不關閉 IRQ
+    dma_channel_set_irq1_enabled(dma_tx_chan, false);
+    dma_channel_set_irq1_enabled(dma_rx_ctrl_chan, false);
+    irq_remove_handler(DMA_IRQ_1, on_dma_tx_complete);
+    irq_remove_handler(DMA_IRQ_1, on_dma_rx_rearm);
+    release_channels();
+    dma_uart = NULL;
+}
+
+bool hal_uart_dma_init(const uart_config_t* cfg)
+{
+    static const uart_config_t default_cfg = HAL_UART_CONFIG_DEFAULT;
+    if (cfg == NULL) cfg = &default_cfg;
+    if (cfg->port >= HAL_UART_PORT_COUNT) return false;
+    if (cfg->baud < HAL_UART_BAUD_MIN || cfg->baud > UART_DMA_BAUD_MAX) return false;
 
-    // 2. 申請 DMA 通道
+    // 重新 init (例如換 port / 流量控制)：先釋放上一次的資源，不重複申請 channel 與註冊 handler
+    hal_uart_dma_deinit();
+
+    // 這個 port 的 UART IRQ 已被 HAL_UART_Init 佔用：兩個驅動不能共用 port (SDK 會 panic)
+    uint irq_num = (cfg->port == 0) ? UART0_IRQ : UART1_IRQ;
+    if (irq_get_exclusive_handler(irq_num) != NULL) return false;
+
+    // 申請 DMA 通道 (在動到任何硬體設定之前)；只申請到一部分就全部歸還
     dma_tx_chan = dma_claim_unused_channel(false);
     dma_rx_chan = dma_claim_unused_channel(false);
+    dma_rx_ctrl_chan = dma_claim_unused_channel(false);
+    if (dma_tx_chan < 0 || dma_rx_chan < 0 || dma_rx_ctrl_chan < 0)
+    {
+        release_channels();
+        return false;
+    }
+
+    // 1. 初始化 UART
+    dma_port = cfg->port;
+    dma_uart = uart_get_instance(cfg->port);
+    rx_timer_set_baud(uart_init(dma_uart, cfg->baud));
+    gpio_set_function(cfg->tx_pin, GPIO_FUNC_UART);
+    gpio_set_function(cfg->rx_pin, GPIO_FUNC_UART);
+
+    // 開啟 FIFO (DMA 需要 FIFO DREQ 訊號)
+    uart_set_format(dma_uart, 8, 1, UART_PARITY_NONE);
+    uart_set_fifo_enabled(dma_uart, true);
+
+    // 1.1 流量控制：CTS 交給硬體；SW_RTS 的 RTS 改為 GPIO，依 RX ring 水位控制
+    dma_flow = cfg->flow;
+    dma_rts_pin = cfg->rts_pin;
+    rx_rts_paused = false;
+    if (cfg->flow != UART_FLOW_NONE)
+    {
+        gpio_set_function(cfg->cts_pin, GPIO_FUNC_UART);
+    }
+    if (cfg->flow == UART_FLOW_RTS_CTS)
+    {
+        gpio_set_function(cfg->rts_pin, GPIO_FUNC_UART);
+    }
+    else if (cfg->flow == UART_FLOW_SW_RTS)
+    {
+        gpio_init(cfg->rts_pin);
+        gpio_set_dir(cfg->rts_pin, GPIO_OUT);
+        gpio_put(cfg->rts_pin, 0);  // active-low：允許對端傳送
+    }
+    uart_set_hw_flow(dma_uart, cfg->flow != UART_FLOW_NONE, cfg->flow == UART_FLOW_RTS_CTS);
+
+    // 1.2 錯誤中斷：RX / RT 中斷保持關閉 (資料給 DMA)，只開 FE / PE / BE / OE 計數
+    memset(&rx_errors, 0, sizeof(rx_errors));
+    irq_set_exclusive_handler(irq_num, on_dma_uart_error);
+    uart_set_irq_enables(dma_uart, false, false);
+    hw_set_bits(&uart_get_hw(dma_uart)->imsc, UART_DMA_ERROR_IRQ_BITS);
+    irq_set_enabled(irq_num, true);
 
-    if (dma_tx_chan < 0 || dma_rx_chan < 0) return false;
+    // 2. 設定 TX DMA：設定只做一次，之後每段只需更新來源位址與長度
+    rb_init(&tx_queue, tx_storage, UART_DMA_TX_QUEUE_SIZE);
+    tx_inflight = 0;
 
-    // 3. 設定 RX DMA (Circular Mode)
+    dma_channel_config c_tx = dma_channel_get_default_config(dma_tx_chan);
+    channel_config_set_transfer_data_size(&c_tx, DMA_SIZE_8);
+    channel_config_set_read_increment(&c_tx, true);                // 讀 RAM
+    channel_config_set_write_increment(&c_tx, false);              // 寫 UART FIFO
+    channel_config_set_dreq(&c_tx, uart_get_dreq(dma_uart, true));  // 當 UART 可寫時觸發
+    dma_channel_configure(dma_tx_chan, &c_tx,
+                          &uart_get_hw(dma_uart)->dr,  // 寫入目的地
+                          tx_storage,                  // 讀取來源 (每段再更新)
+                          0,                           // 長度 (每段再更新)
+                          false                        // 先不啟動
+    );
+
+    dma_channel_set_irq1_enabled(dma_tx_chan, true);
+    irq_add_shared_handler(DMA_IRQ_1, on_dma_tx_complete,
+                           PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_1, true);
+
+    // 3. 設定 RX control channel：把 rx_rearm_count 寫進 dma_rx_chan 的 TRANS_COUNT_TRIG
+    //    寫入位址維持在 ring 內原本的位置，UART FIFO 吸收重新裝填的幾個 cycle，不會漏 byte
+    rx_read_total = 0;
+    rx_last_hw_total = 0;
+    rx_lost = 0;
+    rx_rearm_epoch = 0;
+    rx_idle_last_total = 0;
+
+    dma_channel_config c_ctrl = dma_channel_get_default_config(dma_rx_ctrl_chan);
+    channel_config_set_transfer_data_size(&c_ctrl, DMA_SIZE_32);
+    channel_config_set_read_increment(&c_ctrl, false);
+    channel_config_set_write_increment(&c_ctrl, false);
+    dma_channel_configure(dma_rx_ctrl_chan, &c_ctrl,
+                          &dma_channel_hw_addr(dma_rx_chan)->al1_transfer_count_trig,
+                          &rx_rearm_count,
+                          1,     // 每次只寫一個 word
+                          false  // 由 dma_rx_chan 完成時 chain 觸發
+    );
+
+    dma_channel_set_irq1_enabled(dma_rx_ctrl_chan, true);
+    irq_add_shared_handler(DMA_IRQ_1, on_dma_rx_rearm,
+                           PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+
+    // 4. 設定 RX DMA (Circular Mode)
     dma_channel_config c_rx = dma_channel_get_default_config(dma_rx_chan);
     channel_config_set_transfer_data_size(&c_rx, DMA_SIZE_8);
     channel_config_set_read_increment(&c_rx, false);                // 讀 UART FIFO (固定地址)
     channel_config_set_write_increment(&c_rx, true);                // 寫 RAM (遞增地址)
-    channel_config_set_dreq(&c_rx, uart_get_dreq(UART_ID, false));  // 當 UART 有資料時觸發
+    channel_config_set_dreq(&c_rx, uart_get_dreq(dma_uart, false));  // 當 UART 有資料時觸發
 
-    // 設定 Ring Buffer: 大小為 2^8 = 256 bytes
-    channel_config_set_ring(&c_rx, true, 8);
+    // 設定 Ring Buffer: 大小為 2^UART_DMA_RING_BITS bytes
+    channel_config_set_ring(&c_rx, true, UART_DMA_RING_BITS);
+    channel_config_set_chain_to(&c_rx, dma_rx_ctrl_chan);  // 次數用完 → control channel 重新裝填
 
-    // 啟動 RX DMA (無限循環接收)
+    // 啟動 RX DMA (以 block 為單位持續循環接收)
     dma_channel_configure(dma_rx_chan, &c_rx,
-                          rx_ring_buffer,             // 寫入目的地
-                          &uart_get_hw(UART_ID)->dr,  // 讀取來源 (UART Data Register)
-                          UINT32_MAX,                 // 傳輸次數 (無限)
-                          true                        // 立即啟動
+                          rx_ring_buffer,              // 寫入目的地
+                          &uart_get_hw(dma_uart)->dr,  // 讀取來源 (UART Data Register)
+                          UART_DMA_RX_REARM_BLOCK,     // 傳輸次數 (用完由 control channel 重新裝填)
+                          true                         // 立即啟動
     );
 
+    // 5. SW_RTS 需要 timer 定期檢查水位 (即使沒有人讀取也能及時暫停對端)
+    rx_timer_update();
+    dma_initialised = true;
     return true;
 }
 
-void hal_uart_dma_send(const uint8_t* data, size_t len)
+hal_uart_dma_tx_status_t hal_uart_dma_send(const uint8_t* data, size_t len)
 {
-    // 簡單防護：如果上次還沒傳完，這裡可以選擇等待或捨棄
-    // 實務上我們會用另一個 Ring Buffer 做 Queue
-    dma_channel_wait_for_finish_blocking(dma_tx_chan);
+    if (data == NULL || len == 0) return HAL_UART_DMA_TX_ERROR;
 
-    dma_channel_config c_tx = dma_channel_get_default_config(dma_tx_chan);
-    channel_config_set_transfer_data_size(&c_tx, DMA_SIZE_8);
-    channel_config_set_read_increment(&c_tx, true);                // 讀 RAM
-    channel_config_set_write_increment(&c_tx, false);              // 寫 UART FIFO
-    channel_config_set_dreq(&c_tx, uart_get_dreq(UART_ID, true));  // 當 UART 可寫時觸發
+    // 1. 複製進佇列 (全有或全無，避免訊息被切斷)
+    if (len > rb_free(&tx_queue)) return HAL_UART_DMA_TX_FULL;
+    rb_write(&tx_queue, data, (uint32_t)len);
 
-    dma_channel_configure(dma_tx_chan, &c_tx,
-                          &uart_get_hw(UART_ID)->dr,  // 寫入目的地
-                          data,                       // 讀取來源
-                          len,                        // 長度
-                          true                        // 啟動
-    );
+    // 2. DMA 閒置時由這裡啟動；傳輸中則由完成中斷自動接續
+    //    關中斷避免與 on_dma_tx_complete 同時判斷 tx_inflight
+    uint32_t irq_state = save_and_disable_interrupts();
+    if (tx_inflight == 0)
+    {
+        tx_start_next();
+    }
+    restore_interrupts(irq_state);
+
+    return HAL_UART_DMA_TX_QUEUED;
+}
+
+size_t hal_uart_dma_tx_pending(void)
+{
+    return rb_count(&tx_queue);
+}
+
+uint32_t hal_uart_dma_set_baud(uint32_t baud)
+{
+    if (dma_uart == NULL || baud < HAL_UART_BAUD_MIN || baud > UART_DMA_BAUD_MAX) return 0;
+    uint32_t actual = uart_set_baudrate(dma_uart, baud);
+    rx_timer_set_baud(actual);
+    return actual;
+}
+
+bool hal_uart_dma_tx_idle(void)
+{
+    if (tx_inflight != 0 || rb_count(&tx_queue) != 0) return false;
+    // DMA 已搬完，但 UART FIFO / shift register 可能還在送最後幾個 byte
+    return dma_uart == NULL || (uart_get_hw(dma_uart)->fr & UART_UARTFR_BUSY_BITS) == 0;
+}
+
+// DMA 已寫入的 byte 總數 = 已完成的 block 數 * BLOCK + 目前 block 已傳輸的量
+static uint32_t rx_hw_write_total(void)
+{
+    uint32_t epoch;
+    uint32_t remaining;
+    do
+    {
+        epoch = rx_rearm_epoch;
+        remaining = dma_channel_hw_addr(dma_rx_chan)->transfer_count & RX_TRANS_COUNT_MASK;
+    } while (epoch != rx_rearm_epoch);
+
+    uint32_t total = epoch * UART_DMA_RX_REARM_BLOCK + (UART_DMA_RX_REARM_BLOCK - remaining);
+
+    // control channel 已重新裝填但 IRQ 還沒更新 epoch 的短暫窗口：計數看起來會倒退一個 block
+    if ((int32_t)(total - rx_last_hw_total) < 0)
+    {
+        total += UART_DMA_RX_REARM_BLOCK;
+    }
+    rx_last_hw_total = total;
+    return total;
+}
+
+// 軟體 RTS (active-low)：pending 為目前 RX ring 的未讀量
+static void rx_flow_update(uint32_t pending)
+{
+    if (dma_flow != UART_FLOW_SW_RTS) return;
+
+    if (!rx_rts_paused && pending >= UART_DMA_RTS_HIGH)
+    {
+        rx_rts_paused = true;
+        gpio_put(dma_rts_pin, 1);
+    }
+    else if (rx_rts_paused && pending <= UART_DMA_RTS_LOW)
+    {
+        rx_rts_paused = false;
+        gpio_put(dma_rts_pin, 0);
+    }
+}
+
+uint32_t hal_uart_dma_rx_lost(void)
+{
+    return rx_lost;
+}
+
+void hal_uart_dma_get_error_stats(uart_error_stats_t* out, bool clear)
+{
+    if (out == NULL) return;
+
+    uint32_t irq_state = save_and_disable_interrupts();
+    *out = rx_errors;
+    if (clear) memset(&rx_errors, 0, sizeof(rx_errors));
+    restore_interrupts(irq_state);
+}
+
+size_t hal_uart_dma_peek(uart_dma_span_t spans[2])
+{
+    // 寫入總數只取一次，之後的計算都以這個快照為準
+    uint32_t write_total = rx_hw_write_total();
+    uint32_t avail = write_total - rx_read_total;
+
+    // Overrun：DMA 已經繞圈蓋過尚未讀取的資料。最新的一圈 (扣掉 DMA 可能正在寫的 margin)
+    // 仍然有效，只跳過被覆蓋的部分並計數
+    if (avail > UART_DMA_BUFFER_SIZE)
+    {
+        uint32_t skip = avail - (UART_DMA_BUFFER_SIZE - UART_DMA_OVERRUN_MARGIN);
+        rx_lost += skip;
+        rx_read_total = write_total - UART_DMA_BUFFER_SIZE + UART_DMA_OVERRUN_MARGIN;
+        avail -= skip;
+    }
+
+    uint32_t read = rx_read_total & (UART_DMA_BUFFER_SIZE - 1);
+    uint32_t to_end = UART_DMA_BUFFER_SIZE - read;
+
+    // 沒有繞回：一段 [read, read + avail)；繞回：[read, end) + [0, rest)
+    spans[0].data = &rx_ring_buffer[read];
+    spans[0].len = avail < to_end ? avail : to_end;
+    spans[1].data = rx_ring_buffer;
+    spans[1].len = avail - spans[0].len;
+
+    return avail;
+}
+
+void hal_uart_dma_consume(size_t n)
+{
+    rx_read_total += (uint32_t)n;
+    rx_flow_update(rx_hw_write_total() - rx_read_total);
+}
+
+bool hal_uart_dma_rx_paused(void)
+{
+    return rx_rts_paused;
 }
 
 size_t hal_uart_dma_read(uint8_t* buffer, size_t max_len)
 {
-    // 取得 DMA 目前寫到哪裡了 (Hardware Write Pointer)
-    // hw_addr->write_addr 會回傳絕對位址，我們需要轉成相對 index
-    uintptr_t current_write_addr = (uintptr_t)dma_channel_hw_addr(dma_rx_chan)->write_addr;
-    uintptr_t start_addr = (uintptr_t)rx_ring_buffer;
+    uart_dma_span_t spans[2];
+    hal_uart_dma_peek(spans);
+
+    // 最多兩次 memcpy (ring 尾端 + ring 開頭)
+    size_t first = spans[0].len < max_len ? spans[0].len : max_len;
+    size_t second = spans[1].len < (max_len - first) ? spans[1].len : (max_len - first);
 
-    // 計算硬體目前的 index (Producer Index)
-    uint32_t rx_write_index = (current_write_addr - start_addr) % UART_DMA_BUFFER_SIZE;
+    memcpy(buffer, spans[0].data, first);
+    memcpy(buffer + first, spans[1].data, second);
+
+    hal_uart_dma_consume(first + second);
+    return first + second;
+}
+
+// ==========================================
+// Idle-line 偵測
+// ==========================================
+// DMA 會把 UART FIFO 即時搬空，RX timeout 中斷 (需要 FIFO 內有資料) 幾乎不會觸發，
+// 所以改用低頻 timer 比較 DMA 寫入總數：兩個 tick 之間沒有前進 = 線路閒置
+// 同一個 timer 也負責 SW_RTS 的水位檢查
+
+static bool on_rx_idle_tick(repeating_timer_t* t)
+{
+    (void)t;
+    hal_uart_dma_poll_idle();
+    return true;  // 持續重複
+}
 
-    size_t count = 0;
+// 有 idle Callback 或使用 SW_RTS 時才需要 timer
+static void rx_timer_update(void)
+{
+    bool needed = (rx_idle_cb != NULL) || (rx_span_cb != NULL) || (dma_flow == UART_FLOW_SW_RTS);
 
-    // 當 讀取指標 != 寫入指標，代表有新資料
-    while (rx_read_index != rx_write_index && count < max_len)
+    if (needed && !rx_idle_timer_running)
     {
-        buffer[count++] = rx_ring_buffer[rx_read_index];
+        // 負的週期 = 從上一次 callback 開始計時，固定間隔
+        rx_idle_timer_running = add_repeating_timer_us(-(int64_t)rx_idle_tick_us, on_rx_idle_tick,
+                                                       NULL, &rx_idle_timer);
+    }
+    else if (!needed && rx_idle_timer_running)
+    {
+        cancel_repeating_timer(&rx_idle_timer);
+        rx_idle_timer_running = false;
+    }
+}
+
+// 一個週期最多收到 UART_DMA_TICK_BYTES (8N1：每個字元 10 bits)；低速時維持 UART_DMA_IDLE_TICK_US
+// init / set_baud 已把 baud 限制在 UART_DMA_BAUD_MAX，週期不會低於 UART_DMA_IDLE_TICK_MIN_US
+static void rx_timer_set_baud(uint32_t baud)
+{
+    uint64_t tick = (uint64_t)UART_DMA_TICK_BYTES * 10u * 1000000u / (baud ? baud : 1u);
+    uint32_t tick_us = (tick < UART_DMA_IDLE_TICK_US) ? (uint32_t)tick : UART_DMA_IDLE_TICK_US;
+    if (tick_us == rx_idle_tick_us) return;
 
-        // 移動讀取指標 (Wrap around)
-        rx_read_index = (rx_read_index + 1) % UART_DMA_BUFFER_SIZE;
+    rx_idle_tick_us = tick_us;
+    if (rx_idle_timer_running)
+    {
+        // 以新週期重新啟動
+        cancel_repeating_timer(&rx_idle_timer);
+        rx_idle_timer_running = false;
+        rx_timer_update();
     }
+}
 
-    return count;
-}
\ No newline at end of file
+uint32_t hal_uart_dma_idle_tick_us(void)
+{
+    return rx_idle_tick_us;
+}
+
+void hal_uart_dma_poll_idle(void)
+{
+    uint32_t write_total = rx_hw_write_total();
+    uint32_t pending = write_total - rx_read_total;
+    rx_flow_update(pending);
+
+    if (rx_idle_cb == NULL && rx_span_cb == NULL) return;
+    bool idle = (write_total == rx_idle_last_total);
+    rx_idle_last_total = write_total;
+
+    // 還在收 burst 時不通知；但未讀資料超過 ring 一半就先交出去，避免長 burst 造成 overrun
+    if (pending == 0 || (!idle && pending < UART_DMA_BUFFER_SIZE / 2)) return;
+
+    uart_dma_span_t spans[2];
+    size_t n = hal_uart_dma_peek(spans);
+    if (n == 0) return;  // overrun 已被 peek 丟棄並計數
+
+    if (rx_span_cb != NULL)
+    {
+        // 同一次 tick 的兩段共用時間戳記；ring 最大 32 KiB，len 放得進 uint16_t
+        uint32_t now = time_us_32();
+        for (int i = 0; i < 2 && spans[i].len > 0; i++)
+        {
+            uart_rx_span_t span = {.data = spans[i].data,
+                                   .len = (uint16_t)spans[i].len,
+                                   .port = dma_port,
+                                   .timestamp_us = now};
+            rx_span_cb(rx_idle_ctx, &span);
+        }
+    }
+    else
+    {
+        rx_idle_cb(spans, n, rx_idle_ctx);
+    }
+    hal_uart_dma_consume(n);
+}
+
+void hal_uart_dma_set_idle_callback(hal_uart_dma_idle_cb_t cb, void* user_ctx)
+{
+    rx_idle_cb = cb;
+    rx_span_cb = NULL;
+    rx_idle_ctx = user_ctx;
+    rx_timer_update();
+}
+
+void hal_uart_dma_set_span_callback(uart_span_callback_t cb, void* user_ctx)
+{
+    rx_span_cb = cb;
+    rx_idle_cb = NULL;
+    rx_idle_ctx = user_ctx;
+    rx_timer_update();
+}
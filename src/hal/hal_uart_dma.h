@@ -6,22 +6,134 @@
 #include <stddef.h>
 #include <stdint.h>
 
-// 定義緩衝區大小 (必須是 2 的次方，例如 256, 512，配合 DMA Ring 機制)
-#define UART_DMA_BUFFER_SIZE 256
+#include "hal_uart.h"  // uart_config_t
+
+// RX 環形緩衝區大小 = 2^UART_DMA_RING_BITS (配合 DMA Ring 機制)
+// DMA 的 ring 欄位最多支援 15 bits (32 KiB)；可在編譯時以 -DUART_DMA_RING_BITS=n 覆寫
+#ifndef UART_DMA_RING_BITS
+#define UART_DMA_RING_BITS 8
+#endif
+#define UART_DMA_BUFFER_SIZE (1u << UART_DMA_RING_BITS)
+
+// RX DMA 每跑完這麼多 bytes 就由 control channel 重新裝填 transfer count (必須是 2 的次方)
+#define UART_DMA_RX_REARM_BLOCK (1u << 16)
+
+// TX 佇列大小 (必須是 2 的次方；實際可用 size - 1 bytes)
+#define UART_DMA_TX_QUEUE_SIZE 1024
+
+// Idle-line 偵測的檢查週期 (µs) 上限：連續一個週期沒有新 byte 即視為線路閒置
+// 實際週期依 baud 縮短 (hal_uart_dma_idle_tick_us)，讓一個週期最多收到 UART_DMA_TICK_BYTES：
+// span / idle Callback 在未讀量未達 ring 一半時不交付，所以「一半 + 一個週期」必須放得進 ring
+// 例：256-byte ring → 64 bytes/tick；115200 baud 維持 500 µs，3 Mbaud 213 µs，9.375 Mbaud 68 µs
+#ifndef UART_DMA_IDLE_TICK_US
+#define UART_DMA_IDLE_TICK_US 500
+#endif
+#define UART_DMA_TICK_BYTES (UART_DMA_BUFFER_SIZE / 4u)
+
+// 週期下限 (timer 中斷頻率上限)：需要更短週期的 baud 會被 init / set_baud 拒絕，
+// 要跑更高的 baud 請加大 UART_DMA_RING_BITS
+#ifndef UART_DMA_IDLE_TICK_MIN_US
+#define UART_DMA_IDLE_TICK_MIN_US 50
+#endif
+
+// 目前 ring / 週期下限能承受的最高 baud (8N1，一個字元 10 bits)，不超過 HAL_UART_BAUD_MAX
+#define UART_DMA_BAUD_LIMIT                                                             \
+    ((uint64_t)UART_DMA_TICK_BYTES * 10u * 1000000u / UART_DMA_IDLE_TICK_MIN_US)
+#define UART_DMA_BAUD_MAX                                                               \
+    ((uint32_t)(UART_DMA_BAUD_LIMIT < HAL_UART_BAUD_MAX ? UART_DMA_BAUD_LIMIT : HAL_UART_BAUD_MAX))
+
+// UART_FLOW_SW_RTS：RX ring 未讀量達 HIGH 時拉高 RTS 暫停對端，降到 LOW 以下才恢復
+// 對端收到 RTS 後最多還會再送完 FIFO 裡的幾個 byte，所以 HIGH 需保留餘裕
+#ifndef UART_DMA_RTS_HIGH
+#define UART_DMA_RTS_HIGH (UART_DMA_BUFFER_SIZE * 3u / 4u)
+#endif
+#ifndef UART_DMA_RTS_LOW
+#define UART_DMA_RTS_LOW (UART_DMA_BUFFER_SIZE / 4u)
+#endif
+
+// Ring 溢位時保留最新的 BUFFER_SIZE - MARGIN bytes：讀取當下 DMA 可能還在寫入最舊的那幾個位置
+// (UART FIFO 深度 32)，這段不保證完整，連同被覆蓋的部分一起丟棄
+#ifndef UART_DMA_OVERRUN_MARGIN
+#define UART_DMA_OVERRUN_MARGIN 32u
+#endif
+
+// hal_uart_dma_peek 回傳的一段連續資料 (直接指向 DMA RX ring，不複製)
+typedef struct
+{
+    const uint8_t* data;
+    size_t len;
+} uart_dma_span_t;
+
+/**
+ * @brief Idle-line Callback：一段 burst 結束 (或未讀資料達 ring 一半) 時呼叫
+ * @param spans 新收到的資料 (同 hal_uart_dma_peek，直接指向 DMA ring)
+ * @param len 兩段合計的 byte 數；Callback 返回後驅動程式會自動 consume
+ * @param user_ctx 註冊時傳入的使用者指標
+ */
+typedef void (*hal_uart_dma_idle_cb_t)(const uart_dma_span_t spans[2], size_t len, void* user_ctx);
+
+/**
+ * @brief hal_uart_dma_send 的回傳狀態
+ */
+typedef enum
+{
+    HAL_UART_DMA_TX_QUEUED = 0,  // 已複製進 TX 佇列，DMA 會在背景送出
+    HAL_UART_DMA_TX_FULL,        // 佇列空間不足，整筆未送出 (呼叫端可稍後重試)
+    HAL_UART_DMA_TX_ERROR        // 參數錯誤
+} hal_uart_dma_tx_status_t;
 
 /**
  * @brief 初始化 UART 與 DMA 通道
- * @return true 初始化成功, false 資源不足
+ * @details 使用與 HAL_UART_Init 相同的 uart_config_t (只看 port / 腳位 / baud / 流量控制)；
+ *          此驅動為單一實例 (一個 DMA ring)；再次呼叫會先 hal_uart_dma_deinit 再重新設定。
+ *          所選的 port 不能同時交給 HAL_UART_Init (任一方先 init，另一方都會回傳 false)。
+ *          UART_FLOW_SW_RTS 時 RTS 依 RX ring 的未讀量控制 (UART_DMA_RTS_HIGH / LOW)，
+ *          由讀取端 consume 與 idle timer 更新；UART_FLOW_RTS_CTS 只看 UART FIFO，
+ *          DMA 會持續搬空 FIFO，因此無法防止 ring 本身 overrun。
+ *          Idle timer 的週期依 baud 計算 (見 UART_DMA_TICK_BYTES)。
+ * @param cfg UART 設定，NULL = HAL_UART_CONFIG_DEFAULT
+ * @return true 初始化成功, false 參數錯誤 (port / baud 超出 HAL_UART_BAUD_MIN..UART_DMA_BAUD_MAX)、
+ *         port 已被 HAL_UART_Init 使用，或 DMA 資源不足 (已申請到的 channel 會歸還)
+ */
+bool hal_uart_dma_init(const uart_config_t* cfg);
+
+/**
+ * @brief 停止 DMA、歸還 channel、移除 IRQ handler 並關閉 idle timer (未初始化時不做事)
  */
-bool hal_uart_dma_init(void);
+void hal_uart_dma_deinit(void);
 
 /**
  * @brief 使用 DMA 發送數據 (非阻塞 / Non-blocking)
- * @details 這函式會立即返回，DMA 會在背景搬運數據
+ * @details 數據會先複製進 TX 佇列後立即返回 (呼叫端的 buffer 可馬上重用)；
+ *          DMA 完成中斷會自動接續送出佇列中的下一段，不需要等待上一筆。
  * @param data 指向要發送的數據
  * @param len 數據長度
+ * @return HAL_UART_DMA_TX_QUEUED 或 HAL_UART_DMA_TX_FULL (整筆放不下時不會部分寫入)
+ */
+hal_uart_dma_tx_status_t hal_uart_dma_send(const uint8_t* data, size_t len);
+
+/**
+ * @brief 尚未送出 (含正在傳輸中) 的 byte 數
+ */
+size_t hal_uart_dma_tx_pending(void);
+
+/**
+ * @brief 執行期間切換 baud rate
+ * @details 呼叫前應確認 hal_uart_dma_tx_idle()，否則佇列中的資料會以新速率送出。
+ *          Idle timer 的週期會依新的 baud 重新計算。
+ * @return 實際設定的 baud，超出 HAL_UART_BAUD_MIN..UART_DMA_BAUD_MAX 回傳 0 且不變更
+ */
+uint32_t hal_uart_dma_set_baud(uint32_t baud);
+
+/**
+ * @brief 目前 idle timer 的週期 (µs)：UART_DMA_IDLE_TICK_US，或依 baud 縮短後的值
  */
-void hal_uart_dma_send(const uint8_t* data, size_t len);
+uint32_t hal_uart_dma_idle_tick_us(void);
+
+/**
+ * @brief TX 佇列已清空且 UART 最後一個 bit 已送出
+ */
+bool hal_uart_dma_tx_idle(void);
 
 /**
  * @brief 檢查並讀取接收到的數據
@@ -31,4 +143,60 @@ void hal_uart_dma_send(const uint8_t* data, size_t len);
  */
 size_t hal_uart_dma_read(uint8_t* buffer, size_t max_len);
 
+/**
+ * @brief 因讀取太慢 (落後超過 UART_DMA_BUFFER_SIZE) 被 DMA 覆蓋而丟棄的累計 byte 數
+ * @note  含 UART_DMA_OVERRUN_MARGIN：溢位時只保留最新的 BUFFER_SIZE - MARGIN bytes
+ */
+uint32_t hal_uart_dma_rx_lost(void);
+
+/**
+ * @brief 取得 UART 硬體接收錯誤統計 (framing / parity / break / overrun)
+ * @details RX 資料由 DMA 讀走，錯誤以 UART 錯誤中斷計數 (每次中斷一次)。
+ *          overrun = 硬體 FIFO 溢位 (DMA 來不及搬)；hal_uart_dma_rx_lost = 讀取端太慢造成的 ring 溢位。
+ * @param clear true 則讀取後歸零
+ */
+void hal_uart_dma_get_error_stats(uart_error_stats_t* out, bool clear);
+
+/**
+ * @brief Zero-copy 讀取：取得 RX ring 中尚未讀取的資料 (不移動讀取指標)
+ * @details 資料在 ring 尾端繞回時分成兩段：spans[0] 為較舊的一段，
+ *          spans[1] 為從 ring 開頭繼續的部分 (沒有繞回時 len = 0)。
+ *          指標直接指向 DMA buffer，處理完後必須呼叫 hal_uart_dma_consume。
+ * @param spans 輸出兩段 span
+ * @return 兩段合計的 byte 數
+ */
+size_t hal_uart_dma_peek(uart_dma_span_t spans[2]);
+
+/**
+ * @brief 釋放 n 個已處理的 bytes (n 不可超過 hal_uart_dma_peek 回傳的總數)
+ */
+void hal_uart_dma_consume(size_t n);
+
+/**
+ * @brief 目前是否以軟體 RTS 要求對端暫停 (只在 UART_FLOW_SW_RTS 下可能為 true)
+ */
+bool hal_uart_dma_rx_paused(void);
+
+/**
+ * @brief 註冊 Idle-line Callback 並啟動檢查用的 repeating timer (會取消 span Callback)
+ * @details 不需輪詢：線路安靜下來後最慢一個 hal_uart_dma_idle_tick_us() 週期內收到通知。
+ *          註冊後 Callback 即為 RX 的讀取端 (在 timer 中斷內執行)，
+ *          主程式不要再同時呼叫 hal_uart_dma_read / peek / consume。
+ *          傳入 NULL 則停止 timer (UART_FLOW_SW_RTS 時 timer 仍保留給 RTS 使用)。
+ */
+void hal_uart_dma_set_idle_callback(hal_uart_dma_idle_cb_t cb, void* user_ctx);
+
+/**
+ * @brief 註冊與 hal_uart 相同型別的 RX span Callback (由 idle timer 觸發)
+ * @details 交出時機與 Idle Callback 相同；ring 繞回時依序呼叫兩次 (每段一個 uart_rx_span_t)，
+ *          Callback 返回後自動 consume。與 hal_uart_dma_set_idle_callback 二擇一，
+ *          註冊其中一個會取消另一個。傳入 NULL 則停止 timer (SW_RTS 除外)。
+ */
+void hal_uart_dma_set_span_callback(uart_span_callback_t cb, void* user_ctx);
+
+/**
+ * @brief Idle / RTS 檢查本體 (由 repeating timer 每個週期呼叫一次；Host 測試可直接呼叫)
+ */
+void hal_uart_dma_poll_idle(void);
+
 #endif  // HAL_UART_DMA_H
\ No newline at end of file
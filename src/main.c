@@ -1,13 +1,18 @@
+#include <stdarg.h>
 #include <stdio.h>
 #include <string.h>
 
 #include "pico/stdlib.h"
 
 // 引入各層模組
+#include "baud_negotiator.h"
+#include "event_queue.h"
 #include "hal_i2c.h"
 #include "hal_uart.h"
-#include "ring_buffer.h"
+#include "scheduler.h"
 #include "sentinel_core.h"
+#include "sentinel_frame.h"
+#include "sentinel_session.h"
 #include "ssd1306_basic.h"
 
 #ifndef PICO_DEFAULT_LED_PIN
@@ -16,122 +21,473 @@
 #define LED_PIN PICO_DEFAULT_LED_PIN
 #endif
 
+// UART 流量控制：接上 CTS/RTS 線 (UART0: GP2 / GP3) 後可改為 UART_FLOW_SW_RTS
+#ifndef APP_UART_FLOW
+#define APP_UART_FLOW UART_FLOW_NONE
+#endif
+#define APP_UART_CTS_PIN 2
+#define APP_UART_RTS_PIN 3
+
+// 事件佇列用到 HIGH 就以 RTS 暫停對端 (留下餘裕給對端停下前已在線上的 bytes)，
+// 回落到 LOW 才恢復 (hysteresis：不會在 HIGH 附近每個 span 切換一次 RTS)
+#define EVQ_SLOTS 64
+#define EVQ_RTS_HIGH (EVQ_SLOTS * 3 / 4)
+#define EVQ_RTS_LOW 16
+
+// Session：每個 link 最多幾個 in-flight 的 frame 請求 / bulk DATA，以及 bulk 重送逾時
+#define APP_SESSION_WINDOW SESSION_WINDOW_MAX
+#define APP_SESSION_RTO_MS 200
+
+// Task 週期 (ms) 與單次執行的預算 (us)；OLED 一次 show 在 400 kHz I2C 上約 12 ms
+#define APP_HEARTBEAT_MS 1000
+#define APP_OLED_MS 20
+#define APP_INPUT_BUDGET_US 2000
+#define APP_LINK_BUDGET_US 1000
+#define APP_HEARTBEAT_BUDGET_US 1000
+#define APP_OLED_BUDGET_US 15000
+
+// 指令來源：每條 link 一個輸入端 (文字解析器 + frame 解碼器)，回應送回同一條 link
+typedef enum
+{
+    APP_CH_USB = 0,  // USB CDC (stdio)
+    APP_CH_UART,     // 硬體 UART (h_uart)
+    APP_CH_COUNT
+} App_Channel_t;
+
+typedef enum
+{
+    APP_TASK_INPUT = 0,  // Event：事件佇列非空
+    APP_TASK_LINK,       // Event：baud 協商或 bulk 傳送進行中
+    APP_TASK_HEARTBEAT,  // Timer：APP_HEARTBEAT_MS
+    APP_TASK_OLED,       // Timer：APP_OLED_MS
+    APP_TASK_COUNT
+} App_Task_t;
+
 typedef struct
 {
-    ring_buffer_t rx_rb;
-    uint8_t storage[256];
+    // 所有輸入來源 (UART ISR / USB / Timer) 統一推入同一個事件佇列
+    event_queue_t evq;
+    evq_slot_t evq_slots[EVQ_SLOTS];
+    sentinel_link_t links[APP_CH_COUNT];
+    session_t sessions[APP_CH_COUNT];  // frame 請求的序號 / 回應 / bulk 傳送
+    sched_t sched;
+    sched_task_t tasks[APP_TASK_COUNT];
 } System_Ctx_t;
 
 static System_Ctx_t sys_ctx;
 static uart_handle_t h_uart;
+static baud_negotiator_t baud_neg;
 static bool oled_is_inverted = false;
+static int oled_x_pos = 0;
+
+// Baud 協商綁定到硬體 UART (協商回應必須走被切換的那條 link)
+static uint32_t Link_SetBaud(void* ctx, uint32_t baud)
+{
+    return HAL_UART_SetBaud((uart_handle_t*)ctx, baud);
+}
+
+static bool Link_TxIdle(void* ctx)
+{
+    return HAL_UART_IsTxIdle((uart_handle_t*)ctx);
+}
 
-// UART RX ISR (監聽硬體 GP1)
-void My_UART_Callback(void* ctx, uart_event_t event, void* data)
+static void Link_Send(void* ctx, const char* line)
+{
+    HAL_UART_Send((uart_handle_t*)ctx, (const uint8_t*)line, (uint16_t)strlen(line));
+}
+
+// UART RX ISR (監聽硬體 GP1)：不論 BYTE / FIFO 模式，一段資料一次推入
+static void My_UART_RxSpan(void* ctx, const uart_rx_span_t* span)
 {
     System_Ctx_t* sys = (System_Ctx_t*)ctx;
-    if (event == UART_EVENT_RX_COMPLETE)
+
+    // 超過 EVQ_PAYLOAD_MAX 會自動切段；沿用驅動在 ISR 取得資料時的時間戳記
+    evq_push_span(&sys->evq, EVQ_SRC_UART, span->data, span->len, span->timestamp_us);
+
+    // 主迴圈跟不上：暫停對端而不是讓佇列滿了丟資料 (UART_FLOW_NONE 時為 no-op)
+    if (evq_count(&sys->evq) >= EVQ_RTS_HIGH)
     {
-        uint8_t rx_byte = *(uint8_t*)data;
-        rb_push(&sys->rx_rb, rx_byte);
+        HAL_UART_SetRxReady(&h_uart, false);
     }
 }
 
-// 統一的指令處理函式
-void Process_Command(SystemCmd_t cmd, uint32_t now)
+// USB CDC 收到資料 (IRQ Context)
+// 這裡只發出通知事件，真正的 getchar 留在主迴圈 (Thread Context) 執行
+static void On_USB_CharsAvailable(void* ctx)
 {
-    if (cmd == CMD_OLED_INVERT)
+    System_Ctx_t* sys = (System_Ctx_t*)ctx;
+    evq_push(&sys->evq, EVQ_SRC_USB, NULL, 0, time_us_32());
+}
+
+// 原始 bytes 送上 link (USB 走 putchar_raw：frame 內容不能被 stdio 做 CR/LF 轉換)
+static void App_Send(uint8_t channel, const uint8_t* data, size_t len)
+{
+    if (channel == APP_CH_UART)
     {
-        oled_is_inverted = true;
-        printf("\n[APP] ✅ Command Executed: OLED INVERT\n");
+        HAL_UART_Send(&h_uart, data, (uint16_t)len);
+        return;
     }
-    else if (cmd == CMD_OLED_NORMAL)
+    for (size_t i = 0; i < len; i++)
     {
-        oled_is_inverted = false;
-        printf("\n[APP] ✅ Command Executed: OLED NORMAL\n");
+        putchar_raw(data[i]);
     }
-    else if (cmd == CMD_SYSTEM_PING)
+}
+
+// Session 的 ops：ctx 指向該 channel 的 sentinel_link_t
+static bool Link_SendFrame(void* ctx, const uint8_t* wire, size_t len)
+{
+    App_Send(((const sentinel_link_t*)ctx)->channel, wire, len);
+    return true;  // UART / USB 的送出都是 blocking
+}
+
+// Bulk 測試資料：byte 值 = offset 的低 8 bits (重送時可以重新產生)
+static size_t Link_BulkRead(void* ctx, uint32_t offset, uint8_t* buf, size_t cap)
+{
+    (void)ctx;
+    for (size_t i = 0; i < cap; i++)
     {
-        printf("\n[APP] 🚀 System Alive! Uptime: %u ms\n", now);
+        buf[i] = (uint8_t)(offset + i);
     }
+    return cap;
 }
 
-int main()
+// 回應送回指令來源的 link (USB = stdio，UART = h_uart)；frame 來的指令回 FRAME_TYPE_TEXT
+static void App_Reply(const sentinel_cmd_t* cmd, const char* fmt, ...)
 {
-    stdio_init_all();
-    sleep_ms(3000);  // 多等一下，讓你來得及開 Serial Monitor
-    printf("\n\n==========================================\n");
-    printf("🚀 Project Sentinel: Ultimate Integration\n");
-    printf("👉 Type 'INV' or 'NORM' or 'PING' below:\n");
-    printf("==========================================\n");
+    char line[128];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(line, sizeof(line), fmt, ap);
+    va_end(ap);
+    if (n < 0) return;
+    if ((size_t)n >= sizeof(line)) n = (int)sizeof(line) - 1;  // 截斷
+
+    if (cmd->framed)
+    {
+        uint8_t wire[SENTINEL_FRAME_WIRE_MAX];
+        size_t len = SentinelFrame_Encode(FRAME_TYPE_TEXT, cmd->seq, line, (size_t)n, wire,
+                                          sizeof(wire));
+        App_Send(cmd->channel, wire, len);
+    }
+    else if (cmd->channel == APP_CH_UART)
+    {
+        App_Send(APP_CH_UART, (const uint8_t*)line, (size_t)n);
+    }
+    else
+    {
+        fputs(line, stdout);
+    }
+}
 
-    rb_init(&sys_ctx.rx_rb, sys_ctx.storage, 256);
-    HAL_UART_Init(&h_uart, 0);
-    HAL_UART_RegisterCallback(&h_uart, My_UART_Callback, &sys_ctx);
+// ==========================================
+// 指令 Handler：ctx 指向本輪 scheduler 的時間 (ms)，參數已依指令表的格式解析好
+// ==========================================
+static bool Cmd_OledNormal(void* ctx, const sentinel_cmd_t* cmd)
+{
+    (void)ctx;
+    oled_is_inverted = false;
+    App_Reply(cmd, "\n[APP] ✅ Command Executed: OLED NORMAL\n");
+    return true;
+}
 
-    hal_i2c_init();
-    ssd1306_init();
+static bool Cmd_OledInvert(void* ctx, const sentinel_cmd_t* cmd)
+{
+    (void)ctx;
+    oled_is_inverted = true;
+    App_Reply(cmd, "\n[APP] ✅ Command Executed: OLED INVERT\n");
+    return true;
+}
 
-    gpio_init(LED_PIN);
-    gpio_set_dir(LED_PIN, GPIO_OUT);
+static bool Cmd_Ping(void* ctx, const sentinel_cmd_t* cmd)
+{
+    App_Reply(cmd, "\n[APP] 🚀 System Alive! Uptime: %u ms\n", *(const uint32_t*)ctx);
 
-    uint32_t last_oled_time = 0;
-    uint32_t last_heartbeat_time = 0;
-    int oled_x_pos = 0;
+    // 硬體錯誤 (UART FIFO overrun / 線路雜訊) 與應用層佇列丟棄分開列出，方便判斷瓶頸位置
+    uart_error_stats_t err;
+    HAL_UART_GetErrorStats(&h_uart, &err, false);
+    App_Reply(cmd,
+              "[APP] UART err: overrun=%lu framing=%lu parity=%lu break=%lu | evq dropped=%lu\n",
+              (unsigned long)err.overrun, (unsigned long)err.framing, (unsigned long)err.parity,
+              (unsigned long)err.breaks, (unsigned long)evq_dropped(&sys_ctx.evq));
 
-    while (true)
+    const sentinel_link_t* link = &sys_ctx.links[cmd->channel];
+    App_Reply(cmd, "[APP] frames: ok=%lu bad_crc=%lu malformed=%lu\n",
+              (unsigned long)link->frames_ok, (unsigned long)link->frames_bad_crc,
+              (unsigned long)link->frames_malformed);
+
+    const session_t* ses = &sys_ctx.sessions[cmd->channel];
+    App_Reply(cmd, "[APP] session: dup=%lu gap=%lu data=%lu retx=%lu\n",
+              (unsigned long)ses->dup_requests, (unsigned long)ses->gap_requests,
+              (unsigned long)ses->data_sent, (unsigned long)ses->retransmits);
+
+    for (int i = 0; i < APP_TASK_COUNT; i++)
     {
-        uint32_t now = to_ms_since_boot(get_absolute_time());
+        const sched_task_t* t = &sys_ctx.tasks[i];
+        App_Reply(cmd, "[APP] task %-9s runs=%lu max=%luus over=%lu late=%lums\n", t->name,
+                  (unsigned long)t->runs, (unsigned long)t->max_us, (unsigned long)t->overruns,
+                  (unsigned long)t->max_late_ms);
+    }
+    return true;
+}
 
-        // ---------------------------------------------------
-        // Task 1: 系統心跳 (每秒印一個點，證明沒當機)
-        // ---------------------------------------------------
-        if (now - last_heartbeat_time >= 1000)
+// Baud 協商固定走硬體 UART (ACK / NAK 由 baud_neg 的 link ops 送出)
+static bool Cmd_SetBaud(void* ctx, const sentinel_cmd_t* cmd)
+{
+    return BaudNeg_Request(&baud_neg, cmd->args.num[0], *(const uint32_t*)ctx);
+}
+
+static bool Cmd_BaudConfirm(void* ctx, const sentinel_cmd_t* cmd)
+{
+    (void)cmd;
+    BaudNeg_Confirm(&baud_neg, *(const uint32_t*)ctx);
+    return true;
+}
+
+static bool Cmd_Echo(void* ctx, const sentinel_cmd_t* cmd)
+{
+    (void)ctx;
+    App_Reply(cmd, "\n[APP] ECHO %s\n", cmd->args.tok[0]);
+    return true;
+}
+
+// Bulk 傳送 (測試 link 吞吐量)：只在 frame 模式下有意義，資料由 Link_BulkRead 產生
+static bool Cmd_Bulk(void* ctx, const sentinel_cmd_t* cmd)
+{
+    if (!cmd->framed)
+    {
+        App_Reply(cmd, "\n[APP] BULK needs framed mode\n");
+        return false;
+    }
+    return Session_BulkStart(&sys_ctx.sessions[cmd->channel], cmd->args.num[0], SESSION_CHUNK_MAX,
+                             *(const uint32_t*)ctx);
+}
+
+static bool Cmd_Help(void* ctx, const sentinel_cmd_t* cmd)
+{
+    (void)ctx;
+    App_Reply(cmd, "\n[APP] Commands:\n");
+    for (int id = CMD_NONE + 1; id < CMD_COUNT; id++)
+    {
+        const sentinel_cmd_info_t* info = Sentinel_CmdInfo((SystemCmd_t)id);
+        char usage[SENTINEL_LINE_MAX + SENTINEL_MAX_ARGS * 8];  // 名稱 + 每個 " <token>"
+        int n = snprintf(usage, sizeof(usage), "%s", info->name);
+        for (const char* a = info->schema; *a; a++)
         {
-            last_heartbeat_time = now;
-            printf(".");  // 輸出心跳
+            n += snprintf(&usage[n], sizeof(usage) - (size_t)n, " <%s>",
+                          (*a == 'u') ? "num" : "token");
         }
+        App_Reply(cmd, "  %-16s %s\n", usage, info->help);
+    }
+    return true;
+}
 
-        // ---------------------------------------------------
-        // Task 2: 監聽 USB 鍵盤輸入 (USB CDC Bridge)
-        // ---------------------------------------------------
-        int usb_char = getchar_timeout_us(0);  // 非阻塞讀取 USB 鍵盤
-        if (usb_char != PICO_ERROR_TIMEOUT)
-        {
-            // 💡 照妖鏡：印出你按下的每一個按鍵的 ASCII Hex 碼
-            printf("[Key: %c (0x%02X)]", usb_char, usb_char);
+// 分派表：由指令表的 handler 欄展開 (index = SystemCmd_t)
+#define CMD_HANDLER(id, name, schema, handler, help) [id] = handler,
+static const sentinel_cmd_handler_t cmd_handlers[CMD_COUNT] = {SENTINEL_CMD_TABLE(CMD_HANDLER)};
+#undef CMD_HANDLER
 
-            SystemCmd_t cmd = Sentinel_ParseChar((char)usb_char);
-            Process_Command(cmd, now);
-        }
+// Sentinel_LinkFeed 的 Callback (文字與 frame 指令共用)：ctx 原封不動交給 handler
+// frame 請求先經過 session 的序號檢查 (重送 / 跳號不執行)，執行完回 RESP
+static void On_Command(void* ctx, const sentinel_cmd_t* cmd)
+{
+    if (!cmd->framed)
+    {
+        cmd_handlers[cmd->id](ctx, cmd);
+        return;
+    }
+
+    session_t* ses = &sys_ctx.sessions[cmd->channel];
+    if (!Session_OnRequest(ses, cmd->seq)) return;
+    bool ok = cmd_handlers[cmd->id](ctx, cmd);
+    Session_Respond(ses, cmd->seq, ok ? SESSION_OK : SESSION_ERR_REJECTED);
+}
 
-        // ---------------------------------------------------
-        // Task 3: 監聽硬體 UART (Day 8 Ring Buffer)
-        // ---------------------------------------------------
-        uint8_t rx_byte;
-        if (rb_pop(&sys_ctx.rx_rb, &rx_byte))
+// 非指令的 frame：bulk 的累積 ACK，以及不符 schema 的請求 (仍佔用一個序號，回錯誤)
+static void On_Frame(void* ctx, const sentinel_frame_t* frame)
+{
+    session_t* ses = &sys_ctx.sessions[frame->channel];
+    if (frame->type == FRAME_TYPE_ACK)
+    {
+        Session_OnAck(ses, frame->seq, *(const uint32_t*)ctx);
+    }
+    else if (frame->type == FRAME_TYPE_CMD)
+    {
+        if (Session_OnRequest(ses, frame->seq))
         {
-            SystemCmd_t cmd = Sentinel_ParseChar((char)rx_byte);
-            Process_Command(cmd, now);
+            Session_Respond(ses, frame->seq, SESSION_ERR_MALFORMED);
         }
+    }
+}
 
-        // ---------------------------------------------------
-        // Task 4: OLED 動畫與防護
-        // ---------------------------------------------------
-        if (now - last_oled_time >= 20)
-        {
-            last_oled_time = now;
-            ssd1306_clear();
+// ==========================================
+// Tasks：由 scheduler 依 deadline / 事件呼叫，ctx 指向 sys_ctx
+// ==========================================
+static uint32_t App_ClockUs(void* ctx)
+{
+    (void)ctx;
+    return time_us_32();
+}
 
-            uint8_t pattern = oled_is_inverted ? 0xFF : 0x00;
-            if (oled_is_inverted) ssd1306_fill(pattern);
+// 系統心跳 (每秒印一個點，證明沒當機)
+static void Task_Heartbeat(void* ctx, uint32_t now_ms)
+{
+    (void)ctx;
+    (void)now_ms;
+    printf(".");
+}
+
+static bool Input_Ready(void* ctx)
+{
+    return evq_count(&((System_Ctx_t*)ctx)->evq) > 0;
+}
 
-            for (int y = 0; y < 32; y++)
+// 處理輸入事件 (USB CDC + 硬體 UART 合併為單一消費點)
+// 用完 budget 就讓出，剩下的事件下一輪再處理，timer task 不會被一大串輸入拖延
+static void Task_Input(void* ctx, uint32_t now_ms)
+{
+    System_Ctx_t* sys = (System_Ctx_t*)ctx;
+    input_event_t ev;
+    while (!sched_should_yield(&sys->sched) && evq_pop(&sys->evq, &ev))
+    {
+        if (ev.source == EVQ_SRC_UART)
+        {
+            Sentinel_LinkFeed(&sys->links[APP_CH_UART], ev.data, ev.len, On_Command, On_Frame,
+                              &now_ms);
+        }
+        else if (ev.source == EVQ_SRC_USB)
+        {
+            // 通知事件：一次把 USB 目前累積的字元讀完，湊成一段再交給解析器
+            sentinel_link_t* usb_link = &sys->links[APP_CH_USB];
+            uint8_t usb_buf[64];
+            size_t usb_len = 0;
+            int usb_char;
+            while ((usb_char = getchar_timeout_us(0)) != PICO_ERROR_TIMEOUT)
             {
-                ssd1306_draw_pixel(oled_x_pos, y, !oled_is_inverted);
+                // 💡 照妖鏡：印出你按下的每一個按鍵的 ASCII Hex 碼
+                // (只回顯可見字元：binary frame 的 bytes 不能回灌到 host 的接收串流)
+                if (usb_char >= 0x20 && usb_char < 0x7F)
+                {
+                    printf("[Key: %c (0x%02X)]", usb_char, usb_char);
+                }
+
+                usb_buf[usb_len++] = (uint8_t)usb_char;
+                if (usb_len == sizeof(usb_buf))
+                {
+                    Sentinel_LinkFeed(usb_link, usb_buf, usb_len, On_Command, On_Frame, &now_ms);
+                    usb_len = 0;
+                }
             }
-            ssd1306_show();
-            oled_x_pos = (oled_x_pos + 1) % 128;
+            Sentinel_LinkFeed(usb_link, usb_buf, usb_len, On_Command, On_Frame, &now_ms);
         }
     }
-}
\ No newline at end of file
+
+    // 佇列回落到 LOW：恢復對端傳送
+    // 關中斷再檢查：否則 ISR 可能在檢查之後推到 HIGH 並暫停，接著又被這裡恢復
+    uint32_t irq_state = save_and_disable_interrupts();
+    if (evq_count(&sys->evq) <= EVQ_RTS_LOW)
+    {
+        HAL_UART_SetRxReady(&h_uart, true);
+    }
+    restore_interrupts(irq_state);
+}
+
+static bool Link_Busy(void* ctx)
+{
+    System_Ctx_t* sys = (System_Ctx_t*)ctx;
+    if (baud_neg.state != BAUD_NEG_IDLE) return true;
+    for (uint8_t ch = 0; ch < APP_CH_COUNT; ch++)
+    {
+        if (Session_BulkBusy(&sys->sessions[ch])) return true;
+    }
+    return false;
+}
+
+// Baud 協商 (等 ACK 送完後切換、確認逾時) 與 bulk 傳送 (補滿 window、重送逾時)
+static void Task_Link(void* ctx, uint32_t now_ms)
+{
+    System_Ctx_t* sys = (System_Ctx_t*)ctx;
+    BaudNeg_Poll(&baud_neg, now_ms);
+    for (uint8_t ch = 0; ch < APP_CH_COUNT; ch++)
+    {
+        Session_Poll(&sys->sessions[ch], now_ms);
+    }
+}
+
+// OLED 動畫與防護
+static void Task_Oled(void* ctx, uint32_t now_ms)
+{
+    (void)ctx;
+    (void)now_ms;
+    ssd1306_clear();
+
+    uint8_t pattern = oled_is_inverted ? 0xFF : 0x00;
+    if (oled_is_inverted) ssd1306_fill(pattern);
+
+    for (int y = 0; y < 32; y++)
+    {
+        ssd1306_draw_pixel(oled_x_pos, y, !oled_is_inverted);
+    }
+    ssd1306_show();
+    oled_x_pos = (oled_x_pos + 1) % 128;
+}
+
+int main()
+{
+    stdio_init_all();
+    sleep_ms(3000);  // 多等一下，讓你來得及開 Serial Monitor
+    printf("\n\n==========================================\n");
+    printf("🚀 Project Sentinel: Ultimate Integration\n");
+    printf("👉 Type 'INV' or 'NORM' or 'PING' (or 'HELP' for all commands) below:\n");
+    printf("==========================================\n");
+
+    evq_init(&sys_ctx.evq, sys_ctx.evq_slots, EVQ_SLOTS);
+    for (uint8_t ch = 0; ch < APP_CH_COUNT; ch++)
+    {
+        Sentinel_LinkInit(&sys_ctx.links[ch], ch);
+        const session_ops_t ses_ops = {
+            .send = Link_SendFrame, .read = Link_BulkRead, .ctx = &sys_ctx.links[ch]};
+        Session_Init(&sys_ctx.sessions[ch], &ses_ops, APP_SESSION_WINDOW, APP_SESSION_RTO_MS);
+    }
+    uart_config_t uart_cfg = HAL_UART_CONFIG_DEFAULT;
+    uart_cfg.rx_mode = UART_RX_MODE_FIFO;
+    uart_cfg.flow = APP_UART_FLOW;
+    uart_cfg.cts_pin = APP_UART_CTS_PIN;
+    uart_cfg.rts_pin = APP_UART_RTS_PIN;
+    HAL_UART_Init(&h_uart, &uart_cfg);
+    HAL_UART_RegisterSpanCallback(&h_uart, My_UART_RxSpan, &sys_ctx);
+
+    const baud_link_ops_t link_ops = {
+        .set_baud = Link_SetBaud, .tx_idle = Link_TxIdle, .send = Link_Send, .ctx = &h_uart};
+    BaudNeg_Init(&baud_neg, &link_ops, h_uart.baud, BAUD_NEG_TIMEOUT_MS);
+    stdio_set_chars_available_callback(On_USB_CharsAvailable, &sys_ctx);
+
+    hal_i2c_init();
+    ssd1306_init();
+
+    gpio_init(LED_PIN);
+    gpio_set_dir(LED_PIN, GPIO_OUT);
+
+    // 輸入與 link 只在有事時執行；週期 task 排進 timer wheel
+    sched_t* sched = &sys_ctx.sched;
+    sched_task_t* tasks = sys_ctx.tasks;
+    sched_init(sched, to_ms_since_boot(get_absolute_time()), App_ClockUs, NULL);
+    sched_task_init(&tasks[APP_TASK_INPUT], "input", Task_Input, &sys_ctx, APP_INPUT_BUDGET_US);
+    sched_task_init(&tasks[APP_TASK_LINK], "link", Task_Link, &sys_ctx, APP_LINK_BUDGET_US);
+    sched_task_init(&tasks[APP_TASK_HEARTBEAT], "heartbeat", Task_Heartbeat, &sys_ctx,
+                    APP_HEARTBEAT_BUDGET_US);
+    sched_task_init(&tasks[APP_TASK_OLED], "oled", Task_Oled, &sys_ctx, APP_OLED_BUDGET_US);
+    sched_add_event(sched, &tasks[APP_TASK_INPUT], Input_Ready);
+    sched_add_event(sched, &tasks[APP_TASK_LINK], Link_Busy);
+    sched_start(sched, &tasks[APP_TASK_HEARTBEAT], APP_HEARTBEAT_MS, APP_HEARTBEAT_MS);
+    sched_start(sched, &tasks[APP_TASK_OLED], APP_OLED_MS, APP_OLED_MS);
+
+    while (true)
+    {
+        uint32_t now = to_ms_since_boot(get_absolute_time());
+        if (sched_run(sched, now) == 0)
+        {
+            // 沒有事可做：睡到下一個中斷 (UART / USB 事件) 或下一個 ms tick
+            best_effort_wfe_or_timeout(delayed_by_ms(get_absolute_time(), 1));
+        }
+    }
+}
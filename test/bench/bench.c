@@ -0,0 +1,179 @@
+/**
+ * @file bench.c
+ * @brief Host-side micro-benchmark harness implementation
+ */
+
+#include "bench.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+volatile uint32_t bench_sink;
+
+uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t time_once(const bench_case_t* c, uint32_t iters)
+{
+    if (c->setup)
+    {
+        c->setup(c->ctx);
+    }
+    uint64_t t0 = bench_now_ns();
+    c->run(c->ctx, iters);
+    return bench_now_ns() - t0;
+}
+
+static int cmp_double(const void* a, const void* b)
+{
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+void bench_run_case(const bench_case_t* c, const bench_options_t* opt, bench_result_t* out)
+{
+    // 1. 校準：iters 倍增直到單次量測超過 min_sample_ns
+    uint32_t iters = 64;
+    while (iters < (1u << 30) && time_once(c, iters) < opt->min_sample_ns)
+    {
+        iters *= 2;
+    }
+
+    // 2. Warmup (cache / branch predictor)
+    time_once(c, iters);
+
+    // 3. 重複量測取中位數，降低背景雜訊的影響
+    double samples[64];
+    uint32_t reps = opt->reps;
+    if (reps == 0) reps = 1;
+    if (reps > 64) reps = 64;
+
+    for (uint32_t r = 0; r < reps; r++)
+    {
+        samples[r] = (double)time_once(c, iters) / (double)iters;
+    }
+    qsort(samples, reps, sizeof(samples[0]), cmp_double);
+
+    memset(out, 0, sizeof(*out));
+    strncpy(out->name, c->name, BENCH_NAME_MAX - 1);
+    out->ns_per_op = samples[reps / 2];
+    out->bytes_per_sec = (c->bytes_per_op && out->ns_per_op > 0.0)
+                             ? (double)c->bytes_per_op * 1e9 / out->ns_per_op
+                             : 0.0;
+    out->iters = iters;
+    out->reps = reps;
+}
+
+void bench_print(FILE* f, bench_format_t fmt, const bench_result_t* results, size_t count)
+{
+    if (fmt == BENCH_FMT_CSV)
+    {
+        fprintf(f, "name,ns_per_op,bytes_per_sec,iters,reps\n");
+        for (size_t i = 0; i < count; i++)
+        {
+            fprintf(f, "%s,%.3f,%.0f,%u,%u\n", results[i].name, results[i].ns_per_op,
+                    results[i].bytes_per_sec, results[i].iters, results[i].reps);
+        }
+        return;
+    }
+
+    if (fmt == BENCH_FMT_JSON)
+    {
+        fprintf(f, "[\n");
+        for (size_t i = 0; i < count; i++)
+        {
+            fprintf(f,
+                    "  {\"name\": \"%s\", \"ns_per_op\": %.3f, \"bytes_per_sec\": %.0f, "
+                    "\"iters\": %u, \"reps\": %u}%s\n",
+                    results[i].name, results[i].ns_per_op, results[i].bytes_per_sec,
+                    results[i].iters, results[i].reps, (i + 1 < count) ? "," : "");
+        }
+        fprintf(f, "]\n");
+        return;
+    }
+
+    fprintf(f, "%-32s %12s %14s\n", "benchmark", "ns/op", "MB/s");
+    for (size_t i = 0; i < count; i++)
+    {
+        if (results[i].bytes_per_sec > 0.0)
+        {
+            fprintf(f, "%-32s %12.2f %14.2f\n", results[i].name, results[i].ns_per_op,
+                    results[i].bytes_per_sec / 1e6);
+        }
+        else
+        {
+            fprintf(f, "%-32s %12.2f %14s\n", results[i].name, results[i].ns_per_op, "-");
+        }
+    }
+}
+
+int bench_load_baseline(const char* path, bench_result_t* out, size_t max)
+{
+    FILE* f = fopen(path, "r");
+    if (!f)
+    {
+        return -1;
+    }
+
+    char line[256];
+    int count = 0;
+    while (fgets(line, sizeof(line), f) && (size_t)count < max)
+    {
+        char* comma = strchr(line, ',');
+        if (!comma || strncmp(line, "name,", 5) == 0)
+        {
+            continue;  // 標題列或空行
+        }
+        *comma = '\0';
+
+        bench_result_t* r = &out[count];
+        memset(r, 0, sizeof(*r));
+        size_t name_len = (size_t)(comma - line);
+        if (name_len > BENCH_NAME_MAX - 1) name_len = BENCH_NAME_MAX - 1;
+        memcpy(r->name, line, name_len);
+        r->name[name_len] = '\0';
+        r->ns_per_op = strtod(comma + 1, NULL);
+        count++;
+    }
+    fclose(f);
+    return count;
+}
+
+int bench_compare(FILE* f, const bench_result_t* results, size_t count,
+                  const bench_result_t* baseline, size_t baseline_count, double threshold_pct)
+{
+    int regressions = 0;
+
+    fprintf(f, "%-32s %12s %12s %9s\n", "benchmark", "base ns/op", "ns/op", "delta");
+    for (size_t i = 0; i < count; i++)
+    {
+        const bench_result_t* base = NULL;
+        for (size_t j = 0; j < baseline_count; j++)
+        {
+            if (strcmp(results[i].name, baseline[j].name) == 0)
+            {
+                base = &baseline[j];
+                break;
+            }
+        }
+        if (!base || base->ns_per_op <= 0.0)
+        {
+            fprintf(f, "%-32s %12s %12.2f %9s\n", results[i].name, "-", results[i].ns_per_op,
+                    "new");
+            continue;
+        }
+
+        double delta = (results[i].ns_per_op - base->ns_per_op) * 100.0 / base->ns_per_op;
+        bool regressed = delta > threshold_pct;
+        regressions += regressed ? 1 : 0;
+        fprintf(f, "%-32s %12.2f %12.2f %+8.1f%%%s\n", results[i].name, base->ns_per_op,
+                results[i].ns_per_op, delta, regressed ? "  <-- REGRESSION" : "");
+    }
+    return regressions;
+}
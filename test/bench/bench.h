@@ -0,0 +1,96 @@
+/**
+ * @file bench.h
+ * @brief Host-side micro-benchmark harness (sentinel_bench)
+ *
+ * 每個 benchmark 提供一個 run(ctx, iters) 函式，harness 負責：
+ *   1. 校準 iters，讓單次量測至少跑 BENCH_MIN_SAMPLE_NS
+ *   2. Warmup 一次後重複量測 reps 次，取中位數
+ *   3. 輸出 ns/op 與 bytes/s (table / CSV / JSON)
+ *   4. 與 baseline 檔比較，超過門檻即視為 regression
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define BENCH_MAX_CASES 32
+#define BENCH_NAME_MAX 48
+
+typedef void (*bench_setup_t)(void* ctx);
+typedef void (*bench_run_t)(void* ctx, uint32_t iters);
+
+typedef struct
+{
+    const char* name;
+    bench_setup_t setup;   // 可為 NULL；每次量測前呼叫
+    bench_run_t run;       // 執行 iters 次被測操作
+    void* ctx;
+    uint32_t bytes_per_op; // 0 表示不計算 bytes/s
+} bench_case_t;
+
+typedef struct
+{
+    char name[BENCH_NAME_MAX];
+    double ns_per_op;
+    double bytes_per_sec;
+    uint32_t iters;
+    uint32_t reps;
+} bench_result_t;
+
+typedef enum
+{
+    BENCH_FMT_TABLE = 0,
+    BENCH_FMT_CSV,
+    BENCH_FMT_JSON
+} bench_format_t;
+
+typedef struct
+{
+    uint32_t reps;           // 量測次數 (取中位數)
+    uint64_t min_sample_ns;  // 單次量測的最短時間
+    const char* filter;      // 只跑名稱包含此字串的 case (NULL = 全部)
+} bench_options_t;
+
+/** 防止編譯器把被測結果最佳化掉 */
+extern volatile uint32_t bench_sink;
+
+/** 單調時鐘 (ns) */
+uint64_t bench_now_ns(void);
+
+/**
+ * @brief Calibrate, warm up and measure one case
+ */
+void bench_run_case(const bench_case_t* c, const bench_options_t* opt, bench_result_t* out);
+
+/**
+ * @brief Print results in the selected format
+ */
+void bench_print(FILE* f, bench_format_t fmt, const bench_result_t* results, size_t count);
+
+/**
+ * @brief Load a baseline CSV (name,ns_per_op,...) produced by bench_print(BENCH_FMT_CSV)
+ * @return Number of entries loaded, or -1 if the file cannot be opened
+ */
+int bench_load_baseline(const char* path, bench_result_t* out, size_t max);
+
+/**
+ * @brief Compare results against a baseline
+ * @param threshold_pct Allowed slowdown in percent (e.g. 10.0)
+ * @return Number of regressions found
+ */
+int bench_compare(FILE* f, const bench_result_t* results, size_t count,
+                  const bench_result_t* baseline, size_t baseline_count, double threshold_pct);
+
+// ==========================================
+// Benchmark Suites (每個檔案填入自己的 case，回傳數量)
+// ==========================================
+size_t bench_suite_common(bench_case_t* out);   // bench_common.c
+size_t bench_suite_app(bench_case_t* out);      // bench_app.c
+size_t bench_suite_drivers(bench_case_t* out);  // bench_drivers.c
+size_t bench_suite_hal(bench_case_t* out);      // bench_hal_uart_dma.c
+
+#endif  // BENCH_H
@@ -0,0 +1,94 @@
+/**
+ * @file bench_app.c
+ * @brief Benchmarks for src/app (command parser)
+ */
+
+#include <string.h>
+
+#include "bench.h"
+#include "sentinel_core.h"
+#include "sentinel_frame.h"
+
+static const char k_cmd_stream[] = "PING\nINV\nNORM\nUNKNOWN\n";
+
+// 一次 op = 解析一個字元 (含換行時的指令比對)
+static void run_parse_char(void* ctx, uint32_t iters)
+{
+    (void)ctx;
+    sentinel_parser_t parser;
+    Sentinel_ParserInit(&parser, 0);
+    const size_t len = sizeof(k_cmd_stream) - 1;
+    uint32_t hits = 0;
+    size_t pos = 0;
+    for (uint32_t i = 0; i < iters; i++)
+    {
+        hits += (Sentinel_ParseChar(&parser, k_cmd_stream[pos]) != CMD_NONE);
+        if (++pos == len) pos = 0;
+    }
+    bench_sink = hits;
+}
+
+static void count_cmd(void* ctx, const sentinel_cmd_t* cmd)
+{
+    (void)cmd;
+    (*(uint32_t*)ctx)++;
+}
+
+// 一次 op = 以 Sentinel_ParseBuffer 解析整段 k_cmd_stream (與 parse_char 比較 bytes/s)
+static void run_parse_buffer(void* ctx, uint32_t iters)
+{
+    (void)ctx;
+    sentinel_parser_t parser;
+    Sentinel_ParserInit(&parser, 0);
+    uint32_t hits = 0;
+    for (uint32_t i = 0; i < iters; i++)
+    {
+        Sentinel_ParseBuffer(&parser, k_cmd_stream, sizeof(k_cmd_stream) - 1, count_cmd, &hits);
+    }
+    bench_sink = hits;
+}
+
+// 預先編碼好的 frame 串流：BAUD <u32> 與 ECHO <token> 交替
+static uint8_t k_frame_stream[4 * SENTINEL_FRAME_WIRE_MAX];
+static size_t k_frame_stream_len;
+
+static void setup_frame_stream(void* ctx)
+{
+    (void)ctx;
+    static const uint8_t baud[] = {CMD_SET_BAUD, 0x00, 0x10, 0x0E, 0x00};
+    static const uint8_t echo[] = {CMD_ECHO, 'h', 'e', 'l', 'l', 'o', '\0'};
+    size_t n = 0;
+    for (uint8_t seq = 0; seq < 4; seq++)
+    {
+        const uint8_t* p = (seq & 1) ? echo : baud;
+        size_t len = (seq & 1) ? sizeof(echo) : sizeof(baud);
+        n += SentinelFrame_Encode(FRAME_TYPE_CMD, seq, p, len, &k_frame_stream[n],
+                                  sizeof(k_frame_stream) - n);
+    }
+    k_frame_stream_len = n;
+}
+
+// 一次 op = 以 Sentinel_LinkFeed 解碼 4 個 frame (COBS + CRC + schema)
+static void run_frame_decode(void* ctx, uint32_t iters)
+{
+    (void)ctx;
+    static sentinel_link_t link;
+    Sentinel_LinkInit(&link, 0);
+    uint32_t hits = 0;
+    for (uint32_t i = 0; i < iters; i++)
+    {
+        Sentinel_LinkFeed(&link, k_frame_stream, k_frame_stream_len, count_cmd, NULL, &hits);
+    }
+    bench_sink = hits;
+}
+
+size_t bench_suite_app(bench_case_t* out)
+{
+    out[0] = (bench_case_t){"sentinel_parse_char", NULL, run_parse_char, NULL, 1};
+    out[1] = (bench_case_t){"sentinel_parse_buffer", NULL, run_parse_buffer, NULL,
+                            sizeof(k_cmd_stream) - 1};
+    setup_frame_stream(NULL);
+    out[2] = (bench_case_t){"sentinel_frame_decode", setup_frame_stream, run_frame_decode, NULL,
+                            (uint32_t)k_frame_stream_len};
+    return 3;
+}
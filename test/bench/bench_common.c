@@ -0,0 +1,85 @@
+/**
+ * @file bench_common.c
+ * @brief Benchmarks for src/common (ring_buffer_t byte vs bulk API)
+ */
+
+#include <string.h>
+
+#include "bench.h"
+#include "ring_buffer.h"
+
+#define RB_SIZE 256
+#define RB_CHUNK 64
+
+typedef struct
+{
+    ring_buffer_t rb;
+    uint8_t storage[RB_SIZE];
+    uint8_t chunk[RB_CHUNK];
+} rb_bench_ctx_t;
+
+static rb_bench_ctx_t rb_ctx;
+
+static void rb_setup(void* ctx)
+{
+    rb_bench_ctx_t* c = (rb_bench_ctx_t*)ctx;
+    rb_init(&c->rb, c->storage, RB_SIZE);
+    memset(c->chunk, 0x5A, sizeof(c->chunk));
+}
+
+// 一次 op = 推入一個 byte 再取出一個 byte (模擬 ISR → 主迴圈)
+static void run_rb_push_pop(void* ctx, uint32_t iters)
+{
+    rb_bench_ctx_t* c = (rb_bench_ctx_t*)ctx;
+    uint32_t sum = 0;
+    uint8_t b;
+    for (uint32_t i = 0; i < iters; i++)
+    {
+        rb_push(&c->rb, (uint8_t)i);
+        rb_pop(&c->rb, &b);
+        sum += b;
+    }
+    bench_sink = sum;
+}
+
+// 一次 op = 64 bytes 的 rb_write + rb_read (最多兩段 memcpy)
+static void run_rb_write_read(void* ctx, uint32_t iters)
+{
+    rb_bench_ctx_t* c = (rb_bench_ctx_t*)ctx;
+    uint8_t out[RB_CHUNK];
+    uint32_t sum = 0;
+    for (uint32_t i = 0; i < iters; i++)
+    {
+        rb_write(&c->rb, c->chunk, RB_CHUNK);
+        sum += rb_read(&c->rb, out, RB_CHUNK);
+    }
+    bench_sink = sum + out[0];
+}
+
+// 一次 op = 64 bytes 逐 byte push 後逐 byte pop (與 bulk 同樣資料量的對照組)
+static void run_rb_push_pop_64(void* ctx, uint32_t iters)
+{
+    rb_bench_ctx_t* c = (rb_bench_ctx_t*)ctx;
+    uint32_t sum = 0;
+    uint8_t b;
+    for (uint32_t i = 0; i < iters; i++)
+    {
+        for (uint32_t k = 0; k < RB_CHUNK; k++)
+        {
+            rb_push(&c->rb, c->chunk[k]);
+        }
+        while (rb_pop(&c->rb, &b))
+        {
+            sum += b;
+        }
+    }
+    bench_sink = sum;
+}
+
+size_t bench_suite_common(bench_case_t* out)
+{
+    out[0] = (bench_case_t){"rb_push_pop", rb_setup, run_rb_push_pop, &rb_ctx, 1};
+    out[1] = (bench_case_t){"rb_push_pop_x64", rb_setup, run_rb_push_pop_64, &rb_ctx, RB_CHUNK};
+    out[2] = (bench_case_t){"rb_write_read_x64", rb_setup, run_rb_write_read, &rb_ctx, RB_CHUNK};
+    return 3;
+}
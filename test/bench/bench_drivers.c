@@ -0,0 +1,56 @@
+/**
+ * @file bench_drivers.c
+ * @brief Benchmarks for src/drivers (SSD1306 frame buffer)
+ */
+
+#include "bench.h"
+#include "hal_i2c.h"
+#include "ssd1306_basic.h"
+
+// Host 上沒有 I2C：ssd1306_show 只需要一個會回傳成功的 stub
+int hal_i2c_write_safe(uint8_t addr, const uint8_t* src, size_t len)
+{
+    (void)addr;
+    bench_sink = src[len - 1];
+    return (int)len;
+}
+
+// 一次 op = 畫一個 pixel (走訪整個 128x32 畫面)
+static void run_draw_pixel(void* ctx, uint32_t iters)
+{
+    (void)ctx;
+    int x = 0;
+    int y = 0;
+    for (uint32_t i = 0; i < iters; i++)
+    {
+        ssd1306_draw_pixel(x, y, (i & 1) != 0);
+        if (++x == SSD1306_WIDTH)
+        {
+            x = 0;
+            y = (y + 1) & (SSD1306_HEIGHT - 1);
+        }
+    }
+}
+
+// 一次 op = 清畫面 + 畫一條垂直線 + show (main.c OLED task 的每 frame 成本)
+static void run_oled_frame(void* ctx, uint32_t iters)
+{
+    (void)ctx;
+    for (uint32_t i = 0; i < iters; i++)
+    {
+        ssd1306_clear();
+        for (int y = 0; y < SSD1306_HEIGHT; y++)
+        {
+            ssd1306_draw_pixel((int)(i & (SSD1306_WIDTH - 1)), y, true);
+        }
+        ssd1306_show();
+    }
+}
+
+size_t bench_suite_drivers(bench_case_t* out)
+{
+    out[0] = (bench_case_t){"ssd1306_draw_pixel", NULL, run_draw_pixel, NULL, 0};
+    out[1] = (bench_case_t){"ssd1306_frame", NULL, run_oled_frame, NULL,
+                            SSD1306_WIDTH * SSD1306_HEIGHT / 8};
+    return 2;
+}
@@ -0,0 +1,349 @@
+/**
+ * @file bench_hal_uart_dma.c
+ * @brief Benchmark for hal_uart_dma_read (白箱：直接 include 驅動原始碼)
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "bench.h"
+
+// ==========================================
+// 1. MOCK Definitions (與 test_hal_uart_dma.c 相同的最小 Pico SDK 介面)
+// ==========================================
+#define GPIO_FUNC_UART 2
+#define GPIO_OUT 1
+#define UART_PARITY_NONE 0
+#define DMA_SIZE_8 0
+#define DMA_SIZE_32 2
+#define DMA_IRQ_1 11
+#define UART0_IRQ 33
+#define UART1_IRQ 34
+#define UART_UARTIMSC_FEIM_BITS 0x00000080u
+#define UART_UARTIMSC_PEIM_BITS 0x00000100u
+#define UART_UARTIMSC_BEIM_BITS 0x00000200u
+#define UART_UARTIMSC_OEIM_BITS 0x00000400u
+#define UART_UARTMIS_FEMIS_LSB 7
+#define PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY 0x80
+
+typedef void (*irq_handler_t)(void);
+typedef unsigned int uint;
+
+typedef struct repeating_timer repeating_timer_t;
+typedef bool (*repeating_timer_callback_t)(repeating_timer_t* t);
+struct repeating_timer
+{
+    repeating_timer_callback_t callback;
+};
+
+#define UART_UARTFR_BUSY_BITS 0x00000008u
+
+typedef struct
+{
+    volatile uint32_t dr;
+    volatile uint32_t fr;
+    volatile uint32_t imsc;
+    volatile uint32_t mis;
+    volatile uint32_t icr;
+} uart_hw_t;
+
+typedef struct
+{
+    uintptr_t write_addr;
+    uint32_t transfer_count;
+    uint32_t al1_transfer_count_trig;
+} dma_channel_hw_t;
+
+typedef struct
+{
+    int unused;
+} uart_inst_t;
+
+typedef struct
+{
+    int unused;
+} dma_channel_config;
+
+static uart_inst_t mock_uart_inst;
+
+static dma_channel_hw_t mock_dma_hw[12];
+static uart_hw_t mock_uart_hw_regs;
+static int mock_dma_claim_count = 0;
+
+static int dma_claim_unused_channel(bool required)
+{
+    (void)required;
+    return mock_dma_claim_count++;
+}
+static dma_channel_hw_t* dma_channel_hw_addr(int channel)
+{
+    return &mock_dma_hw[channel];
+}
+static dma_channel_config dma_channel_get_default_config(int channel)
+{
+    (void)channel;
+    dma_channel_config c = {0};
+    return c;
+}
+static void channel_config_set_transfer_data_size(dma_channel_config* c, int size)
+{
+    (void)c;
+    (void)size;
+}
+static void channel_config_set_read_increment(dma_channel_config* c, bool incr)
+{
+    (void)c;
+    (void)incr;
+}
+static void channel_config_set_write_increment(dma_channel_config* c, bool incr)
+{
+    (void)c;
+    (void)incr;
+}
+static void channel_config_set_dreq(dma_channel_config* c, int dreq)
+{
+    (void)c;
+    (void)dreq;
+}
+static void channel_config_set_ring(dma_channel_config* c, bool write, int ring_size)
+{
+    (void)c;
+    (void)write;
+    (void)ring_size;
+}
+static void channel_config_set_chain_to(dma_channel_config* c, int chain_to)
+{
+    (void)c;
+    (void)chain_to;
+}
+static void dma_channel_configure(int chan, dma_channel_config* c, volatile void* write,
+                                  volatile const void* read, uint32_t count, bool trigger)
+{
+    (void)c;
+    (void)write;
+    (void)read;
+    (void)trigger;
+    mock_dma_hw[chan].transfer_count = count;
+}
+static void dma_channel_transfer_from_buffer_now(int chan, const volatile void* read,
+                                                 uint32_t count)
+{
+    (void)chan;
+    (void)read;
+    (void)count;
+}
+static void dma_channel_set_irq1_enabled(int chan, bool enabled)
+{
+    (void)chan;
+    (void)enabled;
+}
+static bool dma_channel_get_irq1_status(int chan)
+{
+    (void)chan;
+    return false;
+}
+static void dma_channel_acknowledge_irq1(int chan)
+{
+    (void)chan;
+}
+static void irq_add_shared_handler(int num, irq_handler_t handler, int priority)
+{
+    (void)num;
+    (void)handler;
+    (void)priority;
+}
+static void irq_set_enabled(int num, bool enabled)
+{
+    (void)num;
+    (void)enabled;
+}
+static void irq_set_exclusive_handler(int num, irq_handler_t handler)
+{
+    (void)num;
+    (void)handler;
+}
+static irq_handler_t irq_get_exclusive_handler(int num)
+{
+    (void)num;
+    return NULL;
+}
+static void irq_remove_handler(int num, irq_handler_t handler)
+{
+    (void)num;
+    (void)handler;
+}
+static void dma_channel_unclaim(int channel)
+{
+    (void)channel;
+}
+static void dma_channel_abort(int channel)
+{
+    (void)channel;
+}
+static void hw_clear_bits(volatile uint32_t* addr, uint32_t mask)
+{
+    *addr &= ~mask;
+}
+static void hw_set_bits(volatile uint32_t* addr, uint32_t mask)
+{
+    *addr |= mask;
+}
+static void uart_set_irq_enables(uart_inst_t* uart, bool rx, bool tx)
+{
+    (void)uart;
+    (void)rx;
+    (void)tx;
+}
+static uint32_t save_and_disable_interrupts(void)
+{
+    return 0;
+}
+static void restore_interrupts(uint32_t status)
+{
+    (void)status;
+}
+static bool add_repeating_timer_us(int64_t delay_us, repeating_timer_callback_t callback,
+                                   void* user_data, repeating_timer_t* out)
+{
+    (void)delay_us;
+    (void)callback;
+    (void)user_data;
+    (void)out;
+    return true;
+}
+static bool cancel_repeating_timer(repeating_timer_t* timer)
+{
+    (void)timer;
+    return true;
+}
+static uint32_t time_us_32(void)
+{
+    return 0;
+}
+static uart_inst_t* uart_get_instance(unsigned int num)
+{
+    (void)num;
+    return &mock_uart_inst;
+}
+static uint32_t uart_init(uart_inst_t* uart, uint32_t baud)
+{
+    (void)uart;
+    return baud;
+}
+static void gpio_set_function(int gpio, int func)
+{
+    (void)gpio;
+    (void)func;
+}
+static void gpio_init(int gpio)
+{
+    (void)gpio;
+}
+static void gpio_set_dir(int gpio, bool out)
+{
+    (void)gpio;
+    (void)out;
+}
+static void gpio_put(int gpio, bool value)
+{
+    (void)gpio;
+    (void)value;
+}
+static uint32_t uart_set_baudrate(uart_inst_t* uart, uint32_t baud)
+{
+    (void)uart;
+    return baud;
+}
+static void uart_set_hw_flow(uart_inst_t* uart, bool cts, bool rts)
+{
+    (void)uart;
+    (void)cts;
+    (void)rts;
+}
+static void uart_set_format(uart_inst_t* uart, int data, int stop, int parity)
+{
+    (void)uart;
+    (void)data;
+    (void)stop;
+    (void)parity;
+}
+static void uart_set_fifo_enabled(uart_inst_t* uart, bool enabled)
+{
+    (void)uart;
+    (void)enabled;
+}
+static uart_hw_t* uart_get_hw(uart_inst_t* uart)
+{
+    (void)uart;
+    return &mock_uart_hw_regs;
+}
+static int uart_get_dreq(uart_inst_t* uart, bool is_tx)
+{
+    (void)uart;
+    (void)is_tx;
+    return 0;
+}
+
+#include "../../src/hal/hal_uart_dma.c"
+
+// ==========================================
+// 2. Benchmark
+// ==========================================
+#define DMA_CHUNK 64
+
+static void dma_setup(void* ctx)
+{
+    (void)ctx;
+    mock_dma_claim_count = 0;
+    hal_uart_dma_init(NULL);
+}
+
+// 「DMA」再寫入一個 chunk：傳輸次數倒數，用完時模擬 control channel 重新裝填 + IRQ
+static void dma_produce_chunk(void)
+{
+    dma_channel_hw_t* hw = &mock_dma_hw[dma_rx_chan];
+    hw->transfer_count -= DMA_CHUNK;
+    if (hw->transfer_count == 0)
+    {
+        hw->transfer_count = UART_DMA_RX_REARM_BLOCK;
+        rx_rearm_epoch++;
+    }
+}
+
+// 一次 op = 「DMA」寫入 64 bytes 後由 hal_uart_dma_read 全部讀出
+static void run_dma_read(void* ctx, uint32_t iters)
+{
+    (void)ctx;
+    uint8_t out[DMA_CHUNK];
+    uint32_t sum = 0;
+    for (uint32_t i = 0; i < iters; i++)
+    {
+        dma_produce_chunk();
+        sum += (uint32_t)hal_uart_dma_read(out, sizeof(out));
+    }
+    bench_sink = sum;
+}
+
+// 一次 op = 同樣 64 bytes，但以 peek 的 span 就地掃描後 consume (不複製)
+static void run_dma_peek(void* ctx, uint32_t iters)
+{
+    (void)ctx;
+    uart_dma_span_t spans[2];
+    uint32_t sum = 0;
+    for (uint32_t i = 0; i < iters; i++)
+    {
+        dma_produce_chunk();
+        size_t n = hal_uart_dma_peek(spans);
+        sum += spans[0].data[0] + (uint32_t)n;
+        hal_uart_dma_consume(n);
+    }
+    bench_sink = sum;
+}
+
+size_t bench_suite_hal(bench_case_t* out)
+{
+    out[0] = (bench_case_t){"hal_uart_dma_read_x64", dma_setup, run_dma_read, NULL, DMA_CHUNK};
+    out[1] = (bench_case_t){"hal_uart_dma_peek_x64", dma_setup, run_dma_peek, NULL, DMA_CHUNK};
+    return 2;
+}
@@ -0,0 +1,144 @@
+/**
+ * @file bench_main.c
+ * @brief sentinel_bench 入口：收集所有 suite、解析參數、輸出與比較
+ *
+ * 用法：
+ *   sentinel_bench                              # 表格輸出
+ *   sentinel_bench --format csv|json            # 機器可讀輸出
+ *   sentinel_bench --filter rb_                 # 只跑名稱包含 rb_ 的 case
+ *   sentinel_bench --save baseline.csv          # 存成 baseline
+ *   sentinel_bench --compare baseline.csv [--threshold 10]
+ *                                               # 與 baseline 比較，regression 時 exit 1
+ *   sentinel_bench --quick                      # 冒煙測試 (CTest 使用)
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+
+static void usage(const char* prog)
+{
+    fprintf(stderr,
+            "usage: %s [--format table|csv|json] [--reps N] [--filter NAME]\n"
+            "          [--save FILE] [--compare FILE] [--threshold PCT] [--quick]\n",
+            prog);
+}
+
+int main(int argc, char** argv)
+{
+    bench_options_t opt = {.reps = 7, .min_sample_ns = 20 * 1000 * 1000, .filter = NULL};
+    bench_format_t fmt = BENCH_FMT_TABLE;
+    const char* save_path = NULL;
+    const char* compare_path = NULL;
+    double threshold_pct = 10.0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char* arg = argv[i];
+        const char* val = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--quick") == 0)
+        {
+            opt.reps = 1;
+            opt.min_sample_ns = 1000 * 1000;
+            continue;
+        }
+        if (!val)
+        {
+            usage(argv[0]);
+            return 2;
+        }
+        i++;
+
+        if (strcmp(arg, "--format") == 0)
+        {
+            fmt = (strcmp(val, "csv") == 0)    ? BENCH_FMT_CSV
+                  : (strcmp(val, "json") == 0) ? BENCH_FMT_JSON
+                                               : BENCH_FMT_TABLE;
+        }
+        else if (strcmp(arg, "--reps") == 0)
+        {
+            opt.reps = (uint32_t)strtoul(val, NULL, 10);
+        }
+        else if (strcmp(arg, "--filter") == 0)
+        {
+            opt.filter = val;
+        }
+        else if (strcmp(arg, "--save") == 0)
+        {
+            save_path = val;
+        }
+        else if (strcmp(arg, "--compare") == 0)
+        {
+            compare_path = val;
+        }
+        else if (strcmp(arg, "--threshold") == 0)
+        {
+            threshold_pct = strtod(val, NULL);
+        }
+        else
+        {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    // 1. 收集所有 suite
+    static bench_case_t cases[BENCH_MAX_CASES];
+    size_t n = 0;
+    n += bench_suite_common(&cases[n]);
+    n += bench_suite_app(&cases[n]);
+    n += bench_suite_drivers(&cases[n]);
+    n += bench_suite_hal(&cases[n]);
+
+    // 2. 執行
+    static bench_result_t results[BENCH_MAX_CASES];
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        if (opt.filter && !strstr(cases[i].name, opt.filter))
+        {
+            continue;
+        }
+        bench_run_case(&cases[i], &opt, &results[count++]);
+    }
+
+    // 3. 輸出
+    bench_print(stdout, fmt, results, count);
+
+    if (save_path)
+    {
+        FILE* f = fopen(save_path, "w");
+        if (!f)
+        {
+            fprintf(stderr, "cannot write %s\n", save_path);
+            return 2;
+        }
+        bench_print(f, BENCH_FMT_CSV, results, count);
+        fclose(f);
+    }
+
+    // 4. 與 baseline 比較
+    if (compare_path)
+    {
+        static bench_result_t baseline[BENCH_MAX_CASES];
+        int base_count = bench_load_baseline(compare_path, baseline, BENCH_MAX_CASES);
+        if (base_count < 0)
+        {
+            fprintf(stderr, "cannot read baseline %s\n", compare_path);
+            return 2;
+        }
+
+        printf("\n");
+        int regressions = bench_compare(stdout, results, count, baseline, (size_t)base_count,
+                                        threshold_pct);
+        if (regressions > 0)
+        {
+            printf("\n%d regression(s) above %.1f%%\n", regressions, threshold_pct);
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,107 @@
+/**
+ * @file emu.h
+ * @brief Host 週邊模擬器 (UART / DMA / NVIC / Timer) 的控制介面
+ *
+ * 驅動程式照常 include hardware/xxx.h / pico/stdlib.h，連結到這裡的實作後就能在 Linux 上
+ * 以虛擬時鐘執行 (不需要 TEST_MODE)：
+ *   - 時鐘以 clk_sys cycle (150 MHz) 為單位，UART 字元時間由實際的 IBRD / FBRD 分頻計算
+ *   - UART：32-byte RX / TX FIFO、RX level / RX timeout / 錯誤中斷、RTS / CTS、overrun
+ *   - DMA：依 DREQ 逐筆搬運、ring wrap、TRANS_COUNT reload、chain、IRQ 0 / 1；
+ *          搬運本身視為零時間 (匯流排頻寬遠高於 UART)
+ *   - NVIC：中斷進入延遲 + 每次 ISR 的 CPU 成本，ISR 執行期間 CPU 不能再進入其他 ISR
+ *
+ * 測試程式扮演「主程式 + 對端」：在某個虛擬時間點呼叫驅動 API，或讓對端送資料，
+ * 再以 emu_run_* 推進時間。
+ */
+#ifndef EMU_H
+#define EMU_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define EMU_CLK_SYS_HZ 150000000u  // clk_sys = clk_peri
+#define EMU_CYCLES_PER_US (EMU_CLK_SYS_HZ / 1000000u)
+
+#define EMU_UART_COUNT 2
+#define EMU_UART_FIFO_DEPTH 32
+
+typedef struct
+{
+    uint32_t irq_latency_cycles;  // 中斷觸發到 ISR 第一行的延遲 (Cortex-M33 約 12 cycles)
+    uint32_t isr_entry_cycles;    // 每次 ISR 的固定成本 (進出 + SDK shared handler 分派)
+    uint32_t dr_read_cycles;      // ISR 內 CPU 每讀一次 UART DR 的成本 (APB 存取)
+} emu_config_t;
+
+#define EMU_CONFIG_DEFAULT \
+    {.irq_latency_cycles = 12, .isr_entry_cycles = 150, .dr_read_cycles = 10}
+
+typedef struct
+{
+    uint64_t rx_bytes;         // 寫入 RX FIFO 的字元數
+    uint64_t rx_overrun;       // FIFO 已滿而遺失的字元數
+    uint64_t rx_last_cycle;    // 最後一個字元進入 FIFO 的時間
+    uint32_t rx_fifo_max;      // RX FIFO 曾經到達的最高水位
+    uint64_t tx_bytes;         // 已完整送上線路的字元數
+    uint64_t tx_last_cycle;    // 最後一個字元送完的時間
+    uint64_t peer_paused;      // 對端因 RTS 暫停的次數
+} emu_uart_stats_t;
+
+typedef struct
+{
+    uint64_t isr_count;
+    uint64_t isr_cycles;     // ISR 佔用的 CPU cycles 總和 (CPU 負載 = isr_cycles / 經過時間)
+    uint64_t dma_transfers;  // DMA 單筆搬運次數
+} emu_cpu_stats_t;
+
+/**
+ * @brief 重設所有週邊、時鐘與統計 (cfg = NULL 使用 EMU_CONFIG_DEFAULT)
+ * @note  IRQ handler 表與 enable 狀態保留 (如同燒在 vector table)：
+ *        驅動內「只安裝一次」的 static 旗標不會因為模擬器重設而失效。
+ */
+void emu_reset(const emu_config_t* cfg);
+
+/** 目前虛擬時間 (clk_sys cycles) */
+uint64_t emu_now(void);
+
+/** 推進到指定時間，期間處理線路事件、DMA、Timer 與中斷 */
+void emu_run_until(uint64_t cycle);
+void emu_run_us(uint64_t us);
+
+/**
+ * @brief 對端送出資料：接在對端目前排隊的資料之後，以線路速率連續傳送
+ * @return 最後一個 byte 預計進入 RX FIFO 的時間 (不含 RTS 暫停)
+ */
+uint64_t emu_uart_feed(uint32_t port, const uint8_t* data, size_t len);
+
+/** 對端尚未送出的 byte 數 */
+size_t emu_uart_pending(uint32_t port);
+
+/** 對端使用的 baud (0 = 與 UART 目前設定相同)；相差超過 3% 時收到的字元帶 framing error */
+void emu_uart_set_peer_baud(uint32_t port, uint32_t baud);
+
+/** 對端下一個送出的字元帶上錯誤 (UART_UARTDR_*_BITS >> 8 的 FE / PE / BE 順序) */
+void emu_uart_inject_error(uint32_t port, uint8_t flags);
+
+/** 對端依這支 GPIO 判斷軟體 RTS (高電位 = 暫停)；-1 = 不看 */
+void emu_uart_set_peer_rts_gpio(uint32_t port, int gpio);
+
+/** 對端的 RTS (我們的 CTS)：false 時開啟 CTS 的 UART 不會開始送下一個字元 */
+void emu_uart_set_peer_cts(uint32_t port, bool ready);
+
+/** 取走對端已經收到的 bytes */
+size_t emu_uart_read_tx(uint32_t port, uint8_t* out, size_t max);
+
+/** 目前 UART baud 設定下一個字元 (8N1 = 10 bits) 的 cycles */
+uint64_t emu_uart_char_cycles(uint32_t port);
+
+/**
+ * @brief 目前 ISR 額外花掉的 CPU cycles (例如 Callback 的工作量)；主程式 context 呼叫時忽略
+ * @details 模擬器只以週邊層級計時，不執行指令；ISR 內的軟體成本必須由呼叫端申報。
+ */
+void emu_charge(uint32_t cycles);
+
+void emu_uart_get_stats(uint32_t port, emu_uart_stats_t* out);
+void emu_get_cpu_stats(emu_cpu_stats_t* out);
+
+#endif  // EMU_H
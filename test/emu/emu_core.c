@@ -0,0 +1,436 @@
+/**
+ * @file emu_core.c
+ * @brief 模擬器核心：虛擬時鐘、事件迴圈、NVIC、repeating timer、GPIO、全域中斷開關
+ */
+#include <string.h>
+
+#include "emu_internal.h"
+#include "hardware/gpio.h"
+#include "hardware/sync.h"
+#include "pico/time.h"
+
+// ==========================================
+// 1. 狀態
+// ==========================================
+emu_core_t emu_core;
+
+#define EMU_SHARED_MAX 4
+#define EMU_TIMER_MAX 8
+
+typedef struct
+{
+    irq_handler_t exclusive;
+    irq_handler_t shared[EMU_SHARED_MAX];
+    uint8_t shared_count;
+    bool enabled;
+    uint64_t pending_since;  // 觀察到觸發的時間 (EMU_NEVER = 未觸發)
+} emu_irq_t;
+
+// handler 表不隨 emu_reset 清除 (見 emu.h)
+static emu_irq_t s_irq[EMU_IRQ_COUNT];
+
+typedef struct
+{
+    repeating_timer_t* rt;
+    uint64_t next;  // 下一次觸發 (cycles)
+} emu_timer_t;
+
+static emu_timer_t s_timers[EMU_TIMER_MAX];
+static int32_t s_timer_next_id = 1;
+
+static bool s_gpio_level[NUM_BANK0_GPIOS];
+
+// ==========================================
+// 2. 內部工具
+// ==========================================
+static uint64_t us_to_cycles(int64_t us)
+{
+    if (us < 0) us = -us;
+    return (uint64_t)us * EMU_CYCLES_PER_US;
+}
+
+static bool timer_due(void)
+{
+    for (int i = 0; i < EMU_TIMER_MAX; i++)
+    {
+        if (s_timers[i].rt && s_timers[i].next <= emu_core.now) return true;
+    }
+    return false;
+}
+
+static uint64_t timer_next_event(void)
+{
+    // 已到期的 timer 由 TIMER0_IRQ_0 的派送時間代表
+    uint64_t next = EMU_NEVER;
+    for (int i = 0; i < EMU_TIMER_MAX; i++)
+    {
+        const emu_timer_t* t = &s_timers[i];
+        if (t->rt && t->next > emu_core.now && t->next < next) next = t->next;
+    }
+    return next;
+}
+
+static bool irq_asserted(uint num)
+{
+    switch (num)
+    {
+        case TIMER0_IRQ_0:
+            return timer_due();
+        case DMA_IRQ_0:
+            return emu_dma_irq_asserted(0);
+        case DMA_IRQ_1:
+            return emu_dma_irq_asserted(1);
+        case UART0_IRQ:
+            return emu_uart_irq_asserted(0);
+        case UART1_IRQ:
+            return emu_uart_irq_asserted(1);
+        default:
+            return false;
+    }
+}
+
+// timer IRQ 屬於 SDK 的 alarm pool (一直開著)，callback 由這裡直接呼叫；其他 IRQ 需要
+// driver 開啟並安裝 handler
+static bool irq_live(uint num)
+{
+    if (num == TIMER0_IRQ_0) return true;
+    const emu_irq_t* q = &s_irq[num];
+    return q->enabled && (q->exclusive || q->shared_count > 0);
+}
+
+static uint64_t irq_dispatch_time(uint num)
+{
+    const emu_irq_t* q = &s_irq[num];
+    if (q->pending_since == EMU_NEVER || emu_core.irq_masked) return EMU_NEVER;
+
+    uint64_t t = q->pending_since + emu_core.cfg.irq_latency_cycles;
+    return (t > emu_core.cpu_free_at) ? t : emu_core.cpu_free_at;
+}
+
+static void timer_fire_due(void)
+{
+    for (int i = 0; i < EMU_TIMER_MAX; i++)
+    {
+        repeating_timer_t* rt = s_timers[i].rt;
+        if (rt == NULL || s_timers[i].next > emu_core.now) continue;
+
+        bool keep = rt->callback(rt);
+        if (s_timers[i].rt != rt) continue;  // callback 內已取消
+        if (!keep)
+        {
+            s_timers[i].rt = NULL;
+            continue;
+        }
+        // 正值：固定週期 (相對上一次排程)；負值：相對 callback 開始
+        s_timers[i].next = (rt->delay_us >= 0) ? s_timers[i].next + us_to_cycles(rt->delay_us)
+                                               : emu_core.now + us_to_cycles(rt->delay_us);
+    }
+}
+
+static void irq_dispatch(uint num)
+{
+    emu_irq_t* q = &s_irq[num];
+    q->pending_since = EMU_NEVER;
+
+    emu_core.irq_depth++;
+    emu_core.isr_charge = 0;
+    if (num == TIMER0_IRQ_0)
+    {
+        timer_fire_due();
+    }
+    else if (q->exclusive)
+    {
+        q->exclusive();
+    }
+    else
+    {
+        for (uint8_t i = 0; i < q->shared_count; i++) q->shared[i]();
+    }
+    emu_core.irq_depth--;
+
+    // ISR 的效果 (讀 FIFO、重設 DMA) 視為發生在進入的那一刻，CPU 則忙到成本付清為止
+    uint64_t cost = emu_core.cfg.isr_entry_cycles + emu_core.isr_charge;
+    if (cost == 0) cost = 1;
+    emu_core.cpu_free_at = emu_core.now + cost;
+    emu_core.stats.isr_count++;
+    emu_core.stats.isr_cycles += cost;
+}
+
+// 派送所有「現在」到期的中斷 (同時到期時編號小的優先，與 NVIC 同優先權的規則相同)
+static void irq_dispatch_due(void)
+{
+    for (;;)
+    {
+        uint best = EMU_IRQ_COUNT;
+        for (uint num = 0; num < EMU_IRQ_COUNT; num++)
+        {
+            if (irq_dispatch_time(num) <= emu_core.now)
+            {
+                best = num;
+                break;
+            }
+        }
+        if (best == EMU_IRQ_COUNT) return;
+
+        irq_dispatch(best);
+        emu_settle();
+    }
+}
+
+static uint64_t next_event(void)
+{
+    uint64_t next = emu_uart_next_event();
+    uint64_t t = timer_next_event();
+    if (t < next) next = t;
+
+    for (uint num = 0; num < EMU_IRQ_COUNT; num++)
+    {
+        t = irq_dispatch_time(num);
+        if (t < next) next = t;
+    }
+    return next;
+}
+
+// ==========================================
+// 3. 模擬器控制 (emu.h)
+// ==========================================
+void emu_settle(void)
+{
+    do
+    {
+        emu_uart_sync();
+    } while (emu_dma_run());
+
+    for (uint num = 0; num < EMU_IRQ_COUNT; num++)
+    {
+        emu_irq_t* q = &s_irq[num];
+        if (irq_live(num) && irq_asserted(num))
+        {
+            if (q->pending_since == EMU_NEVER) q->pending_since = emu_core.now;
+        }
+        else
+        {
+            q->pending_since = EMU_NEVER;
+        }
+    }
+}
+
+void emu_charge(uint32_t cycles)
+{
+    if (emu_core.irq_depth > 0) emu_core.isr_charge += cycles;
+}
+
+void emu_reset(const emu_config_t* cfg)
+{
+    static const emu_config_t default_cfg = EMU_CONFIG_DEFAULT;
+
+    memset(&emu_core, 0, sizeof(emu_core));
+    emu_core.cfg = cfg ? *cfg : default_cfg;
+    if (emu_core.cfg.irq_latency_cycles == 0) emu_core.cfg.irq_latency_cycles = 1;
+
+    for (uint num = 0; num < EMU_IRQ_COUNT; num++) s_irq[num].pending_since = EMU_NEVER;
+    memset(s_timers, 0, sizeof(s_timers));
+    memset(s_gpio_level, 0, sizeof(s_gpio_level));
+
+    emu_uart_reset();
+    emu_dma_reset();
+}
+
+uint64_t emu_now(void)
+{
+    return emu_core.now;
+}
+
+void emu_run_until(uint64_t cycle)
+{
+    emu_settle();
+    for (;;)
+    {
+        uint64_t next = next_event();
+        if (next > cycle) break;
+        if (next > emu_core.now) emu_core.now = next;
+
+        emu_uart_process(emu_core.now);
+        emu_settle();
+        irq_dispatch_due();
+    }
+    if (cycle > emu_core.now) emu_core.now = cycle;
+    emu_settle();
+}
+
+void emu_run_us(uint64_t us)
+{
+    emu_run_until(emu_core.now + us * EMU_CYCLES_PER_US);
+}
+
+void emu_get_cpu_stats(emu_cpu_stats_t* out)
+{
+    *out = emu_core.stats;
+}
+
+// ==========================================
+// 4. SDK：hardware/irq.h
+// ==========================================
+void irq_set_exclusive_handler(uint num, irq_handler_t handler)
+{
+    if (num >= EMU_IRQ_COUNT) return;
+    s_irq[num].exclusive = handler;
+    s_irq[num].shared_count = 0;
+}
+
+void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority)
+{
+    (void)order_priority;
+    if (num >= EMU_IRQ_COUNT || s_irq[num].exclusive) return;
+    emu_irq_t* q = &s_irq[num];
+
+    // 重複安裝同一個 handler (例如驅動重新 init) 只保留一份
+    for (uint8_t i = 0; i < q->shared_count; i++)
+    {
+        if (q->shared[i] == handler) return;
+    }
+    if (q->shared_count < EMU_SHARED_MAX) q->shared[q->shared_count++] = handler;
+}
+
+irq_handler_t irq_get_exclusive_handler(uint num)
+{
+    return (num < EMU_IRQ_COUNT) ? s_irq[num].exclusive : NULL;
+}
+
+void irq_remove_handler(uint num, irq_handler_t handler)
+{
+    if (num >= EMU_IRQ_COUNT) return;
+    emu_irq_t* q = &s_irq[num];
+    if (q->exclusive == handler)
+    {
+        q->exclusive = NULL;
+        return;
+    }
+    for (uint8_t i = 0; i < q->shared_count; i++)
+    {
+        if (q->shared[i] != handler) continue;
+        memmove(&q->shared[i], &q->shared[i + 1],
+                (size_t)(q->shared_count - i - 1) * sizeof(q->shared[0]));
+        q->shared_count--;
+        return;
+    }
+}
+
+void irq_set_enabled(uint num, bool enabled)
+{
+    if (num >= EMU_IRQ_COUNT) return;
+    s_irq[num].enabled = enabled;
+    emu_settle();
+}
+
+bool irq_is_enabled(uint num)
+{
+    return num < EMU_IRQ_COUNT && s_irq[num].enabled;
+}
+
+// ==========================================
+// 5. SDK：hardware/sync.h
+// ==========================================
+uint32_t save_and_disable_interrupts(void)
+{
+    uint32_t prev = emu_core.irq_masked ? 1u : 0u;
+    emu_core.irq_masked = true;
+    return prev;
+}
+
+void restore_interrupts(uint32_t status)
+{
+    emu_core.irq_masked = (status != 0);
+}
+
+// ==========================================
+// 6. SDK：pico/time.h
+// ==========================================
+uint32_t time_us_32(void)
+{
+    return (uint32_t)(emu_core.now / EMU_CYCLES_PER_US);
+}
+
+uint64_t time_us_64(void)
+{
+    return emu_core.now / EMU_CYCLES_PER_US;
+}
+
+bool add_repeating_timer_us(int64_t delay_us, repeating_timer_callback_t callback, void* user_data,
+                            repeating_timer_t* out)
+{
+    if (delay_us == 0 || callback == NULL || out == NULL) return false;
+
+    for (int i = 0; i < EMU_TIMER_MAX; i++)
+    {
+        if (s_timers[i].rt != NULL) continue;
+
+        out->delay_us = delay_us;
+        out->callback = callback;
+        out->user_data = user_data;
+        out->alarm_id = s_timer_next_id++;
+        s_timers[i].rt = out;
+        s_timers[i].next = emu_core.now + us_to_cycles(delay_us);
+        return true;
+    }
+    return false;
+}
+
+bool cancel_repeating_timer(repeating_timer_t* timer)
+{
+    for (int i = 0; i < EMU_TIMER_MAX; i++)
+    {
+        if (s_timers[i].rt == timer)
+        {
+            s_timers[i].rt = NULL;
+            return true;
+        }
+    }
+    return false;
+}
+
+void busy_wait_us(uint64_t delay_us)
+{
+    emu_run_us(delay_us);
+}
+
+void sleep_us(uint64_t us)
+{
+    emu_run_us(us);
+}
+
+void sleep_ms(uint32_t ms)
+{
+    emu_run_us((uint64_t)ms * 1000u);
+}
+
+// ==========================================
+// 7. SDK：hardware/gpio.h
+// ==========================================
+void gpio_init(uint gpio)
+{
+    if (gpio < NUM_BANK0_GPIOS) s_gpio_level[gpio] = false;
+}
+
+void gpio_set_function(uint gpio, enum gpio_function fn)
+{
+    (void)gpio;
+    (void)fn;
+}
+
+void gpio_set_dir(uint gpio, bool out)
+{
+    (void)gpio;
+    (void)out;
+}
+
+void gpio_put(uint gpio, bool value)
+{
+    // 軟體 RTS：對端在下一個字元邊界讀取電位 (emu_uart_sync)
+    if (gpio < NUM_BANK0_GPIOS) s_gpio_level[gpio] = value;
+}
+
+bool gpio_get(uint gpio)
+{
+    return gpio < NUM_BANK0_GPIOS && s_gpio_level[gpio];
+}
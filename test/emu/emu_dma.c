@@ -0,0 +1,343 @@
+/**
+ * @file emu_dma.c
+ * @brief 模擬器：DMA channel
+ *
+ * 每個 channel 在 DREQ 允許時搬一筆；一筆搬運視為零時間，因此 DMA 只會被 UART 的
+ * FIFO 狀態限速 (對 UART 速率而言匯流排頻寬幾乎無限)。
+ * 位址在 host 上是真正的指標；讀寫到 UART DR 的位址時改為 FIFO pop / push，
+ * 寫到某個 channel 的 TRANS_COUNT / AL1_TRANS_COUNT_TRIG 時等同寫入該暫存器。
+ * (64-bit host 的指標放不進 32-bit 暫存器，因此 DMA 寫其他 channel 的位址暫存器不支援)
+ */
+#include <stddef.h>  // offsetof
+#include <string.h>
+
+#include "emu_internal.h"
+
+// ==========================================
+// 1. 狀態
+// ==========================================
+typedef struct
+{
+    bool claimed;
+    bool busy;
+    dma_channel_config cfg;
+    uintptr_t read;
+    uintptr_t write;
+    uint32_t reload;  // 觸發時載入 transfer_count 的值
+} emu_dma_ch_t;
+
+static emu_dma_ch_t s_ch[NUM_DMA_CHANNELS];
+static dma_channel_hw_t s_hw[NUM_DMA_CHANNELS];  // 驅動讀 transfer_count 的鏡像
+static uint32_t s_intr;                          // 各 channel 的完成旗標
+static uint32_t s_inte[2];                       // IRQ 0 / 1 的 enable mask
+
+// ==========================================
+// 2. 匯流排
+// ==========================================
+static uint32_t bus_read(uintptr_t addr, uint32_t size)
+{
+    uint32_t port;
+    if (emu_uart_is_dr(addr, &port)) return emu_uart_dr_pop(port);
+
+    uint32_t v = 0;
+    memcpy(&v, (const void*)addr, size);
+    return v;
+}
+
+static void channel_trigger(uint channel);
+
+static void bus_write(uintptr_t addr, uint32_t size, uint32_t value)
+{
+    uint32_t port;
+    if (emu_uart_is_dr(addr, &port))
+    {
+        emu_uart_dr_push(port, (uint8_t)value);
+        return;
+    }
+
+    uintptr_t base = (uintptr_t)s_hw;
+    if (addr >= base && addr < base + sizeof(s_hw))
+    {
+        size_t offset = addr - base;
+        uint channel = (uint)(offset / sizeof(dma_channel_hw_t));
+        size_t reg = offset % sizeof(dma_channel_hw_t);
+        if (reg == offsetof(dma_channel_hw_t, transfer_count) ||
+            reg == offsetof(dma_channel_hw_t, al1_transfer_count_trig))
+        {
+            s_ch[channel].reload = value;
+            if (reg == offsetof(dma_channel_hw_t, al1_transfer_count_trig))
+            {
+                channel_trigger(channel);
+            }
+        }
+        return;
+    }
+
+    memcpy((void*)addr, &value, size);
+}
+
+// ==========================================
+// 3. Channel
+// ==========================================
+static void channel_trigger(uint channel)
+{
+    emu_dma_ch_t* c = &s_ch[channel];
+    if (!c->cfg.enable) return;
+
+    c->busy = true;
+    s_hw[channel].transfer_count = c->reload;
+}
+
+static void channel_complete(uint channel)
+{
+    emu_dma_ch_t* c = &s_ch[channel];
+    c->busy = false;
+    s_intr |= 1u << channel;
+    if (c->cfg.chain_to != channel) channel_trigger(c->cfg.chain_to);
+}
+
+// ring：只有低 ring_bits 位元遞增，其餘位元不變 (緩衝區需對齊 2^ring_bits)
+static uintptr_t addr_advance(uintptr_t addr, uint32_t size, uint8_t ring_bits)
+{
+    if (ring_bits == 0) return addr + size;
+    uintptr_t mask = ((uintptr_t)1 << ring_bits) - 1u;
+    return (addr & ~mask) | ((addr + size) & mask);
+}
+
+static bool dreq_ready(uint8_t dreq)
+{
+    return dreq == DREQ_FORCE || emu_uart_dreq(dreq);
+}
+
+static bool channel_step(uint channel)
+{
+    emu_dma_ch_t* c = &s_ch[channel];
+    if (!c->busy) return false;
+    if (s_hw[channel].transfer_count == 0)
+    {
+        channel_complete(channel);
+        return true;
+    }
+    if (!dreq_ready(c->cfg.dreq)) return false;
+
+    uint32_t size = 1u << c->cfg.data_size;
+    bus_write(c->write, size, bus_read(c->read, size));
+    emu_core.stats.dma_transfers++;
+
+    // ring 只套用在 ring_write 指定的那一邊
+    uint8_t ring_bits = c->cfg.ring_bits;
+    if (c->cfg.read_increment)
+    {
+        c->read = addr_advance(c->read, size, c->cfg.ring_write ? 0 : ring_bits);
+    }
+    if (c->cfg.write_increment)
+    {
+        c->write = addr_advance(c->write, size, c->cfg.ring_write ? ring_bits : 0);
+    }
+
+    if (--s_hw[channel].transfer_count == 0) channel_complete(channel);
+    return true;
+}
+
+// ==========================================
+// 4. 模擬器內部介面 (emu_internal.h)
+// ==========================================
+void emu_dma_reset(void)
+{
+    memset(s_ch, 0, sizeof(s_ch));
+    memset(s_hw, 0, sizeof(s_hw));
+    s_intr = 0;
+    s_inte[0] = 0;
+    s_inte[1] = 0;
+}
+
+bool emu_dma_run(void)
+{
+    bool any = false;
+    bool progress;
+    do
+    {
+        progress = false;
+        for (uint ch = 0; ch < NUM_DMA_CHANNELS; ch++)
+        {
+            if (channel_step(ch)) progress = true;
+        }
+        if (progress)
+        {
+            any = true;
+            emu_uart_sync();  // DREQ 依 FIFO 狀態變化 (TX 搬入後 shift register 可能馬上取走)
+        }
+    } while (progress);
+    return any;
+}
+
+bool emu_dma_irq_asserted(uint32_t irq_index)
+{
+    return (s_intr & s_inte[irq_index]) != 0;
+}
+
+// ==========================================
+// 5. SDK：hardware/dma.h
+// ==========================================
+int dma_claim_unused_channel(bool required)
+{
+    (void)required;
+    for (int ch = 0; ch < NUM_DMA_CHANNELS; ch++)
+    {
+        if (!s_ch[ch].claimed)
+        {
+            s_ch[ch].claimed = true;
+            return ch;
+        }
+    }
+    return -1;
+}
+
+void dma_channel_unclaim(uint channel)
+{
+    s_ch[channel].claimed = false;
+}
+
+dma_channel_hw_t* dma_channel_hw_addr(uint channel)
+{
+    return &s_hw[channel];
+}
+
+dma_channel_config dma_channel_get_default_config(uint channel)
+{
+    dma_channel_config c = {.data_size = DMA_SIZE_32,
+                            .read_increment = true,
+                            .write_increment = false,
+                            .dreq = DREQ_FORCE,
+                            .chain_to = (uint8_t)channel,
+                            .ring_write = false,
+                            .ring_bits = 0,
+                            .enable = true};
+    return c;
+}
+
+void channel_config_set_transfer_data_size(dma_channel_config* c,
+                                           enum dma_channel_transfer_size size)
+{
+    c->data_size = (uint8_t)size;
+}
+
+void channel_config_set_read_increment(dma_channel_config* c, bool incr)
+{
+    c->read_increment = incr;
+}
+
+void channel_config_set_write_increment(dma_channel_config* c, bool incr)
+{
+    c->write_increment = incr;
+}
+
+void channel_config_set_dreq(dma_channel_config* c, uint dreq)
+{
+    c->dreq = (uint8_t)dreq;
+}
+
+void channel_config_set_chain_to(dma_channel_config* c, uint chain_to)
+{
+    c->chain_to = (uint8_t)chain_to;
+}
+
+void channel_config_set_ring(dma_channel_config* c, bool write, uint size_bits)
+{
+    c->ring_write = write;
+    c->ring_bits = (uint8_t)size_bits;
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config* config,
+                           volatile void* write_addr, const volatile void* read_addr,
+                           uint transfer_count, bool trigger)
+{
+    emu_dma_ch_t* c = &s_ch[channel];
+    c->cfg = *config;
+    c->write = (uintptr_t)write_addr;
+    c->read = (uintptr_t)read_addr;
+    c->reload = transfer_count;
+    s_hw[channel].transfer_count = transfer_count;
+    if (trigger) dma_channel_start(channel);
+}
+
+void dma_channel_set_write_addr(uint channel, volatile void* write_addr, bool trigger)
+{
+    s_ch[channel].write = (uintptr_t)write_addr;
+    if (trigger) dma_channel_start(channel);
+}
+
+void dma_channel_set_read_addr(uint channel, const volatile void* read_addr, bool trigger)
+{
+    s_ch[channel].read = (uintptr_t)read_addr;
+    if (trigger) dma_channel_start(channel);
+}
+
+void dma_channel_transfer_from_buffer_now(uint channel, const volatile void* read_addr,
+                                          uint32_t transfer_count)
+{
+    s_ch[channel].read = (uintptr_t)read_addr;
+    s_ch[channel].reload = transfer_count;
+    dma_channel_start(channel);
+}
+
+void dma_channel_start(uint channel)
+{
+    channel_trigger(channel);
+    emu_settle();
+}
+
+void dma_channel_abort(uint channel)
+{
+    s_ch[channel].busy = false;
+}
+
+bool dma_channel_is_busy(uint channel)
+{
+    return s_ch[channel].busy;
+}
+
+void dma_channel_set_irq0_enabled(uint channel, bool enabled)
+{
+    if (enabled)
+    {
+        s_inte[0] |= 1u << channel;
+    }
+    else
+    {
+        s_inte[0] &= ~(1u << channel);
+    }
+}
+
+void dma_channel_set_irq1_enabled(uint channel, bool enabled)
+{
+    if (enabled)
+    {
+        s_inte[1] |= 1u << channel;
+    }
+    else
+    {
+        s_inte[1] &= ~(1u << channel);
+    }
+}
+
+bool dma_channel_get_irq0_status(uint channel)
+{
+    return (s_intr & s_inte[0] & (1u << channel)) != 0;
+}
+
+bool dma_channel_get_irq1_status(uint channel)
+{
+    return (s_intr & s_inte[1] & (1u << channel)) != 0;
+}
+
+// INTS 的 write-1-to-clear 清的是共用的 INTR：兩條 IRQ 線上的旗標一起清掉
+void dma_channel_acknowledge_irq0(uint channel)
+{
+    s_intr &= ~(1u << channel);
+}
+
+void dma_channel_acknowledge_irq1(uint channel)
+{
+    s_intr &= ~(1u << channel);
+}
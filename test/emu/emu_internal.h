@@ -0,0 +1,49 @@
+/**
+ * @file emu_internal.h
+ * @brief 模擬器各模組 (core / uart / dma) 之間的內部介面
+ */
+#ifndef EMU_INTERNAL_H
+#define EMU_INTERNAL_H
+
+#include "emu.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/uart.h"
+
+#define EMU_IRQ_COUNT 64
+#define EMU_NEVER UINT64_MAX
+
+typedef struct
+{
+    emu_config_t cfg;
+    uint64_t now;          // 虛擬時間 (cycles)
+    uint64_t cpu_free_at;  // CPU 在這之前忙於上一個 ISR
+    int irq_depth;         // > 0 = 正在 ISR 中
+    uint64_t isr_charge;   // 目前 ISR 額外累計的成本
+    bool irq_masked;       // save_and_disable_interrupts
+    emu_cpu_stats_t stats;
+} emu_core_t;
+
+extern emu_core_t emu_core;
+
+// --- core ---
+/** 讓 DMA 跑到沒有可搬的資料、更新 UART 暫存器、記錄新觸發的 IRQ */
+void emu_settle(void);
+
+// --- uart ---
+void emu_uart_reset(void);
+uint64_t emu_uart_next_event(void);
+void emu_uart_process(uint64_t now);
+void emu_uart_sync(void);  // 處理 ICR 寫入、重新計算 FR / RIS / MIS、啟動 TX / 對端
+bool emu_uart_irq_asserted(uint32_t port);
+bool emu_uart_dreq(uint32_t dreq);
+bool emu_uart_is_dr(uintptr_t addr, uint32_t* port);
+uint32_t emu_uart_dr_pop(uint32_t port);
+void emu_uart_dr_push(uint32_t port, uint8_t data);
+
+// --- dma ---
+void emu_dma_reset(void);
+bool emu_dma_run(void);  // 回傳是否有任何搬運
+bool emu_dma_irq_asserted(uint32_t irq_index);
+
+#endif  // EMU_INTERNAL_H
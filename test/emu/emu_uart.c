@@ -0,0 +1,596 @@
+/**
+ * @file emu_uart.c
+ * @brief 模擬器：PL011 UART 與線路另一端 (對端)
+ *
+ * 時間單位都是 clk_sys cycle。一個 bit 的長度以「1/4 cycle」為單位保存 (bit_q)：
+ * PL011 的分頻是 16 × (IBRD + FBRD / 64)，因此 bit_q = 64 × IBRD + FBRD 是整數，
+ * 第 k 個字元的到達時間 base + (k × 10 × bit_q) / 4 不會累積誤差。
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "emu_internal.h"
+#include "hardware/gpio.h"
+
+// ==========================================
+// 1. 狀態
+// ==========================================
+#define EMU_UART_BITS_PER_CHAR 10u  // 8N1
+#define EMU_UART_RT_BITS 32u        // RX timeout = 32 個 bit time 沒有新字元
+#define EMU_UART_DR_ERR_SHIFT 8     // DR[11:8] = FE / PE / BE / OE
+#define EMU_UART_RIS_ERR_SHIFT 7    // RIS[10:7] = FE / PE / BE / OE
+#define EMU_UART_BAUD_TOLERANCE 3   // 對端 baud 相差超過 3% 就收不到正確字元
+
+typedef struct
+{
+    uint8_t* data;
+    size_t len;
+    size_t cap;
+    size_t pos;  // 讀取位置
+} emu_bytes_t;
+
+// uart_inst_t 指向這個結構 (暫存器放在第一個欄位，uart_get_hw 直接回傳)
+struct uart_inst
+{
+    uart_hw_t hw;
+    uint32_t port;
+
+    // RX FIFO：每格 12 bits (資料 + 錯誤旗標)
+    uint16_t rx_fifo[EMU_UART_FIFO_DEPTH];
+    uint8_t rx_head;
+    uint8_t rx_count;
+    bool rx_overrun_pending;  // 下一個寫入 FIFO 的字元帶 OE
+    bool rt_flag;
+    uint64_t rt_deadline;
+    uint32_t ris_errors;  // FE / PE / BE / OE 中斷 (sticky，ICR 清除)
+
+    // TX FIFO + shift register
+    uint8_t tx_fifo[EMU_UART_FIFO_DEPTH];
+    uint8_t tx_head;
+    uint8_t tx_count;
+    bool tx_busy;
+    uint8_t tx_shift;
+    uint64_t tx_done_at;
+
+    // 對端
+    emu_bytes_t peer_tx;   // 對端準備送給我們的資料
+    emu_bytes_t peer_err;  // 與 peer_tx 對齊的錯誤旗標
+    emu_bytes_t peer_rx;   // 對端已收到的資料
+    uint8_t next_err;
+    uint32_t peer_baud;  // 0 = 跟隨 UART 設定
+    int peer_rts_gpio;
+    bool peer_cts;
+
+    // 線路：目前這一串連續傳送的起點與已送字元數
+    bool line_active;
+    uint64_t line_base;
+    uint64_t line_k;
+    uint32_t line_q;
+
+    emu_uart_stats_t stats;
+};
+
+typedef struct uart_inst emu_uart_t;
+
+static emu_uart_t s_uart[EMU_UART_COUNT];
+
+// ==========================================
+// 2. 內部工具
+// ==========================================
+static void bytes_push(emu_bytes_t* b, const uint8_t* data, size_t len)
+{
+    if (b->len + len > b->cap)
+    {
+        size_t cap = b->cap ? b->cap : 256;
+        while (cap < b->len + len) cap *= 2;
+        b->data = realloc(b->data, cap);
+        b->cap = cap;
+    }
+    if (data)
+    {
+        memcpy(b->data + b->len, data, len);
+    }
+    else
+    {
+        memset(b->data + b->len, 0, len);
+    }
+    b->len += len;
+}
+
+static void bytes_clear(emu_bytes_t* b)
+{
+    b->len = 0;
+    b->pos = 0;
+}
+
+static uint32_t uart_bit_q(const emu_uart_t* u)
+{
+    uint32_t q = (u->hw.ibrd << 6) + u->hw.fbrd;
+    return q ? q : 1;
+}
+
+static uint32_t peer_bit_q(const emu_uart_t* u)
+{
+    if (u->peer_baud == 0) return uart_bit_q(u);
+    return (uint32_t)(((uint64_t)4u * EMU_CLK_SYS_HZ + u->peer_baud / 2) / u->peer_baud);
+}
+
+static uint64_t chars_to_cycles(uint64_t chars, uint32_t bit_q)
+{
+    return (chars * EMU_UART_BITS_PER_CHAR * bit_q) / 4u;
+}
+
+static uint32_t fifo_depth(const emu_uart_t* u)
+{
+    return (u->hw.lcr_h & UART_UARTLCR_H_FEN_BITS) ? EMU_UART_FIFO_DEPTH : 1u;
+}
+
+// IFLS RXIFLSEL：1/8、1/4、1/2、3/4、7/8；FIFO 關閉時一個字元就觸發
+static uint32_t rx_trigger_level(const emu_uart_t* u)
+{
+    static const uint8_t levels[] = {4, 8, 16, 24, 28};
+    if (fifo_depth(u) == 1) return 1;
+
+    uint32_t sel = (u->hw.ifls & UART_UARTIFLS_RXIFLSEL_BITS) >> UART_UARTIFLS_RXIFLSEL_LSB;
+    return levels[(sel < 5) ? sel : 4];
+}
+
+static bool peer_may_send(const emu_uart_t* u)
+{
+    if (u->peer_rts_gpio >= 0 && gpio_get((uint)u->peer_rts_gpio)) return false;
+    // 硬體 RTS：RX FIFO 到達觸發水位時 deassert
+    if ((u->hw.cr & UART_UARTCR_RTSEN_BITS) && u->rx_count >= rx_trigger_level(u)) return false;
+    return true;
+}
+
+static uint64_t line_next_arrival(const emu_uart_t* u)
+{
+    return u->line_base + chars_to_cycles(u->line_k + 1, u->line_q);
+}
+
+static bool line_mismatch(const emu_uart_t* u)
+{
+    uint64_t a = uart_bit_q(u);
+    uint64_t b = u->line_q;
+    uint64_t diff = (a > b) ? a - b : b - a;
+    return diff * 100u > a * EMU_UART_BAUD_TOLERANCE;
+}
+
+static void rx_push(emu_uart_t* u, uint16_t dr)
+{
+    uint64_t now = emu_core.now;
+    u->rt_deadline = now + (EMU_UART_RT_BITS * (uint64_t)uart_bit_q(u)) / 4u;
+
+    if (u->rx_count >= fifo_depth(u))
+    {
+        // FIFO 已滿：shift register 的字元遺失，FIFO 內容不受影響
+        u->stats.rx_overrun++;
+        u->rx_overrun_pending = true;
+        u->ris_errors |= UART_UARTIMSC_OEIM_BITS;
+        return;
+    }
+
+    if (u->rx_overrun_pending)
+    {
+        dr |= UART_UARTDR_OE_BITS;
+        u->rx_overrun_pending = false;
+    }
+    u->ris_errors |= (uint32_t)((dr >> EMU_UART_DR_ERR_SHIFT) & 0xFu) << EMU_UART_RIS_ERR_SHIFT;
+
+    u->rx_fifo[(u->rx_head + u->rx_count) % EMU_UART_FIFO_DEPTH] = dr;
+    u->rx_count++;
+    u->stats.rx_bytes++;
+    u->stats.rx_last_cycle = now;
+    if (u->rx_count > u->stats.rx_fifo_max) u->stats.rx_fifo_max = u->rx_count;
+}
+
+static void line_arrival(emu_uart_t* u)
+{
+    uint16_t dr = u->peer_tx.data[u->peer_tx.pos];
+    dr |= (uint16_t)(u->peer_err.data[u->peer_tx.pos] << EMU_UART_DR_ERR_SHIFT);
+    u->peer_tx.pos++;
+    if (line_mismatch(u))
+    {
+        dr = (uint16_t)((dr ^ 0x5Au) | UART_UARTDR_FE_BITS);  // 取樣點錯位：亂碼 + 沒有 stop bit
+    }
+    if (u->hw.cr & UART_UARTCR_RXE_BITS) rx_push(u, dr);
+    u->line_k++;
+
+    if (u->peer_tx.pos == u->peer_tx.len)
+    {
+        bytes_clear(&u->peer_tx);
+        bytes_clear(&u->peer_err);
+        u->line_active = false;
+    }
+    else if (!peer_may_send(u))
+    {
+        u->line_active = false;
+        u->stats.peer_paused++;
+    }
+    else if (peer_bit_q(u) != u->line_q)
+    {
+        // 跟隨 UART 的對端在字元邊界換 baud
+        u->line_base = emu_core.now;
+        u->line_k = 0;
+        u->line_q = peer_bit_q(u);
+    }
+}
+
+static void tx_kick(emu_uart_t* u)
+{
+    if (u->tx_busy || u->tx_count == 0) return;
+    if ((u->hw.cr & UART_UARTCR_CTSEN_BITS) && !u->peer_cts) return;
+
+    u->tx_shift = u->tx_fifo[u->tx_head];
+    u->tx_head = (uint8_t)((u->tx_head + 1) % EMU_UART_FIFO_DEPTH);
+    u->tx_count--;
+    u->tx_busy = true;
+    u->tx_done_at = emu_core.now + chars_to_cycles(1, uart_bit_q(u));
+}
+
+static void uart_sync_one(emu_uart_t* u)
+{
+    uart_hw_t* hw = &u->hw;
+
+    // 1. ICR (write-1-to-clear)
+    if (hw->icr)
+    {
+        u->ris_errors &= ~hw->icr;
+        if (hw->icr & UART_UARTIMSC_RTIM_BITS) u->rt_flag = false;
+        hw->icr = 0;
+    }
+
+    // 2. 對端在暫停 / 閒置後重新開始送
+    if (!u->line_active && u->peer_tx.pos < u->peer_tx.len && peer_may_send(u))
+    {
+        u->line_active = true;
+        u->line_base = emu_core.now;
+        u->line_k = 0;
+        u->line_q = peer_bit_q(u);
+    }
+
+    tx_kick(u);
+
+    // 3. 狀態暫存器
+    uint32_t depth = fifo_depth(u);
+    uint32_t fr = 0;
+    if (u->rx_count == 0) fr |= UART_UARTFR_RXFE_BITS;
+    if (u->rx_count >= depth) fr |= UART_UARTFR_RXFF_BITS;
+    if (u->tx_count == 0) fr |= UART_UARTFR_TXFE_BITS;
+    if (u->tx_count >= depth) fr |= UART_UARTFR_TXFF_BITS;
+    if (u->tx_count > 0 || u->tx_busy) fr |= UART_UARTFR_BUSY_BITS;
+    hw->fr = fr;
+
+    uint32_t ris = u->ris_errors;
+    if (u->rx_count >= rx_trigger_level(u)) ris |= UART_UARTIMSC_RXIM_BITS;
+    if (u->rt_flag) ris |= UART_UARTIMSC_RTIM_BITS;
+    if (u->tx_count <= depth / 2) ris |= UART_UARTIMSC_TXIM_BITS;
+    hw->ris = ris;
+    hw->mis = ris & hw->imsc;
+}
+
+// ==========================================
+// 3. 模擬器內部介面 (emu_internal.h)
+// ==========================================
+void emu_uart_reset(void)
+{
+    for (uint32_t i = 0; i < EMU_UART_COUNT; i++)
+    {
+        emu_uart_t* u = &s_uart[i];
+        free(u->peer_tx.data);
+        free(u->peer_err.data);
+        free(u->peer_rx.data);
+        memset(u, 0, sizeof(*u));
+        u->port = i;
+        u->peer_rts_gpio = -1;
+        u->peer_cts = true;
+    }
+}
+
+uint64_t emu_uart_next_event(void)
+{
+    uint64_t next = EMU_NEVER;
+    for (uint32_t i = 0; i < EMU_UART_COUNT; i++)
+    {
+        const emu_uart_t* u = &s_uart[i];
+        uint64_t t;
+        if (u->line_active && (t = line_next_arrival(u)) < next) next = t;
+        if (u->rx_count > 0 && !u->rt_flag && u->rt_deadline < next) next = u->rt_deadline;
+        if (u->tx_busy && u->tx_done_at < next) next = u->tx_done_at;
+    }
+    return next;
+}
+
+void emu_uart_process(uint64_t now)
+{
+    for (uint32_t i = 0; i < EMU_UART_COUNT; i++)
+    {
+        emu_uart_t* u = &s_uart[i];
+        if (u->tx_busy && u->tx_done_at <= now)
+        {
+            bytes_push(&u->peer_rx, &u->tx_shift, 1);
+            u->tx_busy = false;
+            u->stats.tx_bytes++;
+            u->stats.tx_last_cycle = now;
+        }
+        if (u->line_active && line_next_arrival(u) <= now)
+        {
+            line_arrival(u);
+        }
+        if (u->rx_count > 0 && !u->rt_flag && u->rt_deadline <= now)
+        {
+            u->rt_flag = true;
+        }
+    }
+}
+
+void emu_uart_sync(void)
+{
+    for (uint32_t i = 0; i < EMU_UART_COUNT; i++) uart_sync_one(&s_uart[i]);
+}
+
+bool emu_uart_irq_asserted(uint32_t port)
+{
+    return port < EMU_UART_COUNT && s_uart[port].hw.mis != 0;
+}
+
+// PL011 的 DMA 請求：RX FIFO 有資料 / TX FIFO 有空位 (且 DMACR 開啟)
+bool emu_uart_dreq(uint32_t dreq)
+{
+    if (dreq < DREQ_UART0_TX || dreq > DREQ_UART1_RX) return false;
+    const emu_uart_t* u = &s_uart[(dreq - DREQ_UART0_TX) / 2];
+    if ((dreq - DREQ_UART0_TX) % 2 == 0)
+    {
+        return (u->hw.dmacr & UART_UARTDMACR_TXDMAE_BITS) && u->tx_count < fifo_depth(u);
+    }
+    return (u->hw.dmacr & UART_UARTDMACR_RXDMAE_BITS) && u->rx_count > 0;
+}
+
+bool emu_uart_is_dr(uintptr_t addr, uint32_t* port)
+{
+    for (uint32_t i = 0; i < EMU_UART_COUNT; i++)
+    {
+        if (addr == (uintptr_t)&s_uart[i].hw.dr)
+        {
+            *port = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t emu_uart_dr_pop(uint32_t port)
+{
+    emu_uart_t* u = &s_uart[port];
+    if (u->rx_count == 0) return 0;
+
+    uint32_t dr = u->rx_fifo[u->rx_head];
+    u->rx_head = (uint8_t)((u->rx_head + 1) % EMU_UART_FIFO_DEPTH);
+    u->rx_count--;
+    if (u->rx_count == 0) u->rt_flag = false;
+    return dr;
+}
+
+void emu_uart_dr_push(uint32_t port, uint8_t data)
+{
+    emu_uart_t* u = &s_uart[port];
+    if (u->tx_count >= fifo_depth(u)) return;  // FIFO 滿時寫入被丟棄 (與硬體相同)
+
+    u->tx_fifo[(u->tx_head + u->tx_count) % EMU_UART_FIFO_DEPTH] = data;
+    u->tx_count++;
+    tx_kick(u);
+}
+
+// ==========================================
+// 4. 對端控制 (emu.h)
+// ==========================================
+uint64_t emu_uart_feed(uint32_t port, const uint8_t* data, size_t len)
+{
+    emu_uart_t* u = &s_uart[port];
+    bytes_push(&u->peer_tx, data, len);
+    bytes_push(&u->peer_err, NULL, len);
+    if (len > 0 && u->next_err)
+    {
+        u->peer_err.data[u->peer_err.len - len] = u->next_err;
+        u->next_err = 0;
+    }
+
+    size_t remaining = u->peer_tx.len - u->peer_tx.pos;
+    if (u->line_active) return u->line_base + chars_to_cycles(u->line_k + remaining, u->line_q);
+    return emu_core.now + chars_to_cycles(remaining, peer_bit_q(u));
+}
+
+size_t emu_uart_pending(uint32_t port)
+{
+    return s_uart[port].peer_tx.len - s_uart[port].peer_tx.pos;
+}
+
+void emu_uart_set_peer_baud(uint32_t port, uint32_t baud)
+{
+    s_uart[port].peer_baud = baud;
+}
+
+void emu_uart_inject_error(uint32_t port, uint8_t flags)
+{
+    s_uart[port].next_err = flags & 0x7u;
+}
+
+void emu_uart_set_peer_rts_gpio(uint32_t port, int gpio)
+{
+    s_uart[port].peer_rts_gpio = gpio;
+}
+
+void emu_uart_set_peer_cts(uint32_t port, bool ready)
+{
+    s_uart[port].peer_cts = ready;
+}
+
+size_t emu_uart_read_tx(uint32_t port, uint8_t* out, size_t max)
+{
+    emu_bytes_t* b = &s_uart[port].peer_rx;
+    size_t n = b->len - b->pos;
+    if (n > max) n = max;
+    memcpy(out, b->data + b->pos, n);
+    b->pos += n;
+    if (b->pos == b->len) bytes_clear(b);
+    return n;
+}
+
+uint64_t emu_uart_char_cycles(uint32_t port)
+{
+    return chars_to_cycles(1, uart_bit_q(&s_uart[port]));
+}
+
+void emu_uart_get_stats(uint32_t port, emu_uart_stats_t* out)
+{
+    *out = s_uart[port].stats;
+}
+
+// ==========================================
+// 5. SDK：hardware/uart.h
+// ==========================================
+uart_inst_t* uart_get_instance(uint num)
+{
+    return &s_uart[num];
+}
+
+uint uart_get_index(uart_inst_t* uart)
+{
+    return uart->port;
+}
+
+uart_hw_t* uart_get_hw(uart_inst_t* uart)
+{
+    return &uart->hw;
+}
+
+uint uart_init(uart_inst_t* uart, uint baudrate)
+{
+    emu_uart_t* u = uart;
+
+    // 重設 UART 本身；對端 (線路另一端) 的狀態不受影響
+    memset(&u->hw, 0, sizeof(u->hw));
+    u->rx_head = u->rx_count = 0;
+    u->rx_overrun_pending = false;
+    u->rt_flag = false;
+    u->ris_errors = 0;
+    u->tx_head = u->tx_count = 0;
+    u->tx_busy = false;
+
+    uint actual = uart_set_baudrate(uart, baudrate);
+    u->hw.lcr_h = UART_UARTLCR_H_FEN_BITS;
+    u->hw.cr = UART_UARTCR_UARTEN_BITS | UART_UARTCR_TXE_BITS | UART_UARTCR_RXE_BITS;
+    u->hw.dmacr = UART_UARTDMACR_TXDMAE_BITS | UART_UARTDMACR_RXDMAE_BITS;
+    u->hw.ifls = (2u << UART_UARTIFLS_RXIFLSEL_LSB) | 2u;  // 重設值：RX / TX 都是 1/2
+    emu_settle();
+    return actual;
+}
+
+// 與 SDK 相同的分頻計算 (clk_peri = EMU_CLK_SYS_HZ)
+uint uart_set_baudrate(uart_inst_t* uart, uint baudrate)
+{
+    emu_uart_t* u = uart;
+    uint32_t div = (uint32_t)((8u * (uint64_t)EMU_CLK_SYS_HZ) / baudrate) + 1u;
+    uint32_t ibrd = div >> 7;
+    uint32_t fbrd;
+    if (ibrd == 0)
+    {
+        ibrd = 1;
+        fbrd = 0;
+    }
+    else if (ibrd >= 65535)
+    {
+        ibrd = 65535;
+        fbrd = 0;
+    }
+    else
+    {
+        fbrd = (div & 0x7f) >> 1;
+    }
+    u->hw.ibrd = ibrd;
+    u->hw.fbrd = fbrd;
+    return (uint)((4u * (uint64_t)EMU_CLK_SYS_HZ) / (64u * ibrd + fbrd));
+}
+
+void uart_set_format(uart_inst_t* uart, uint data_bits, uint stop_bits, uart_parity_t parity)
+{
+    // 模擬器固定 8N1 (字元時間 10 bits)
+    (void)uart;
+    (void)data_bits;
+    (void)stop_bits;
+    (void)parity;
+}
+
+void uart_set_fifo_enabled(uart_inst_t* uart, bool enabled)
+{
+    emu_uart_t* u = uart;
+    if (enabled)
+    {
+        hw_set_bits(&u->hw.lcr_h, UART_UARTLCR_H_FEN_BITS);
+    }
+    else
+    {
+        hw_clear_bits(&u->hw.lcr_h, UART_UARTLCR_H_FEN_BITS);
+    }
+}
+
+void uart_set_hw_flow(uart_inst_t* uart, bool cts, bool rts)
+{
+    emu_uart_t* u = uart;
+    hw_write_masked(&u->hw.cr,
+                    (cts ? UART_UARTCR_CTSEN_BITS : 0u) | (rts ? UART_UARTCR_RTSEN_BITS : 0u),
+                    UART_UARTCR_CTSEN_BITS | UART_UARTCR_RTSEN_BITS);
+}
+
+void uart_set_irq_enables(uart_inst_t* uart, bool rx_has_data, bool tx_needs_data)
+{
+    uart_hw_t* hw = &uart->hw;
+    hw->imsc = (tx_needs_data ? UART_UARTIMSC_TXIM_BITS : 0u) |
+               (rx_has_data ? (UART_UARTIMSC_RXIM_BITS | UART_UARTIMSC_RTIM_BITS) : 0u);
+    if (rx_has_data)
+    {
+        hw_write_masked(&hw->ifls, 0u << UART_UARTIFLS_RXIFLSEL_LSB, UART_UARTIFLS_RXIFLSEL_BITS);
+    }
+    if (tx_needs_data)
+    {
+        hw_write_masked(&hw->ifls, 0u << UART_UARTIFLS_TXIFLSEL_LSB, UART_UARTIFLS_TXIFLSEL_BITS);
+    }
+}
+
+// 見 hardware/uart.h：回傳 true 時 FIFO 開頭已 pop 到 DR
+bool uart_is_readable(uart_inst_t* uart)
+{
+    emu_uart_t* u = uart;
+    if (u->rx_count == 0) return false;
+
+    u->hw.dr = emu_uart_dr_pop(u->port);
+    emu_charge(emu_core.cfg.dr_read_cycles);
+    return true;
+}
+
+bool uart_is_writable(uart_inst_t* uart)
+{
+    emu_uart_t* u = uart;
+    return u->tx_count < fifo_depth(u);
+}
+
+// TX FIFO 滿時虛擬時鐘前進到下一個字元送出 (期間照常派送中斷)
+void uart_write_blocking(uart_inst_t* uart, const uint8_t* src, size_t len)
+{
+    emu_uart_t* u = uart;
+    for (size_t i = 0; i < len; i++)
+    {
+        while (!uart_is_writable(uart))
+        {
+            uint64_t t = u->tx_busy ? u->tx_done_at : emu_core.now + emu_uart_char_cycles(u->port);
+            emu_run_until(t);
+        }
+        emu_uart_dr_push(u->port, src[i]);
+    }
+    emu_settle();
+}
+
+uint uart_get_dreq(uart_inst_t* uart, bool is_tx)
+{
+    return DREQ_UART0_TX + 2u * uart->port + (is_tx ? 0u : 1u);
+}
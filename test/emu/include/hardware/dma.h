@@ -0,0 +1,75 @@
+/**
+ * @file hardware/dma.h
+ * @brief Host 模擬器：DMA channel (DREQ pacing、ring wrap、chain、TRANS_COUNT reload、IRQ 0/1)
+ */
+#ifndef EMU_HARDWARE_DMA_H
+#define EMU_HARDWARE_DMA_H
+
+#include "hardware/regs.h"
+
+#define NUM_DMA_CHANNELS 16
+
+enum dma_channel_transfer_size
+{
+    DMA_SIZE_8 = 0,
+    DMA_SIZE_16 = 1,
+    DMA_SIZE_32 = 2
+};
+
+// 與 SDK 的 alias 排列相同：DMA 也可以寫其他 channel 的暫存器 (control channel 重新裝填)
+typedef struct
+{
+    io_rw_32 read_addr;
+    io_rw_32 write_addr;
+    io_rw_32 transfer_count;
+    io_rw_32 ctrl_trig;
+    io_rw_32 al1_ctrl;
+    io_rw_32 al1_read_addr;
+    io_rw_32 al1_write_addr;
+    io_rw_32 al1_transfer_count_trig;
+} dma_channel_hw_t;
+
+typedef struct
+{
+    uint8_t data_size;  // enum dma_channel_transfer_size
+    bool read_increment;
+    bool write_increment;
+    uint8_t dreq;
+    uint8_t chain_to;
+    bool ring_write;
+    uint8_t ring_bits;  // 0 = 不繞回
+    bool enable;
+} dma_channel_config;
+
+int dma_claim_unused_channel(bool required);
+void dma_channel_unclaim(uint channel);
+dma_channel_hw_t* dma_channel_hw_addr(uint channel);
+
+dma_channel_config dma_channel_get_default_config(uint channel);
+void channel_config_set_transfer_data_size(dma_channel_config* c,
+                                           enum dma_channel_transfer_size size);
+void channel_config_set_read_increment(dma_channel_config* c, bool incr);
+void channel_config_set_write_increment(dma_channel_config* c, bool incr);
+void channel_config_set_dreq(dma_channel_config* c, uint dreq);
+void channel_config_set_chain_to(dma_channel_config* c, uint chain_to);
+void channel_config_set_ring(dma_channel_config* c, bool write, uint size_bits);
+
+void dma_channel_configure(uint channel, const dma_channel_config* config,
+                           volatile void* write_addr, const volatile void* read_addr,
+                           uint transfer_count, bool trigger);
+void dma_channel_set_write_addr(uint channel, volatile void* write_addr, bool trigger);
+void dma_channel_set_read_addr(uint channel, const volatile void* read_addr, bool trigger);
+void dma_channel_transfer_from_buffer_now(uint channel, const volatile void* read_addr,
+                                          uint32_t transfer_count);
+void dma_channel_start(uint channel);
+void dma_channel_abort(uint channel);
+bool dma_channel_is_busy(uint channel);
+
+void dma_channel_set_irq0_enabled(uint channel, bool enabled);
+void dma_channel_set_irq1_enabled(uint channel, bool enabled);
+bool dma_channel_get_irq0_status(uint channel);
+bool dma_channel_get_irq1_status(uint channel);
+void dma_channel_acknowledge_irq0(uint channel);
+void dma_channel_acknowledge_irq1(uint channel);
+
+#endif  // EMU_HARDWARE_DMA_H
@@ -0,0 +1,30 @@
+/**
+ * @file hardware/gpio.h
+ * @brief Host 模擬器：GPIO (只記錄功能與輸出電位；軟體 RTS 由模擬的對端讀取)
+ */
+#ifndef EMU_HARDWARE_GPIO_H
+#define EMU_HARDWARE_GPIO_H
+
+#include "hardware/regs.h"
+
+#define NUM_BANK0_GPIOS 48
+
+#define GPIO_OUT 1
+#define GPIO_IN 0
+
+enum gpio_function
+{
+    GPIO_FUNC_SPI = 1,
+    GPIO_FUNC_UART = 2,
+    GPIO_FUNC_I2C = 3,
+    GPIO_FUNC_SIO = 5,
+    GPIO_FUNC_NULL = 0x1f
+};
+
+void gpio_init(uint gpio);
+void gpio_set_function(uint gpio, enum gpio_function fn);
+void gpio_set_dir(uint gpio, bool out);
+void gpio_put(uint gpio, bool value);
+bool gpio_get(uint gpio);
+
+#endif  // EMU_HARDWARE_GPIO_H
@@ -0,0 +1,21 @@
+/**
+ * @file hardware/irq.h
+ * @brief Host 模擬器：NVIC (exclusive / shared handler、進入延遲、ISR 執行成本)
+ */
+#ifndef EMU_HARDWARE_IRQ_H
+#define EMU_HARDWARE_IRQ_H
+
+#include "hardware/regs.h"
+
+#define PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY 0x80
+
+typedef void (*irq_handler_t)(void);
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler);
+void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority);
+void irq_remove_handler(uint num, irq_handler_t handler);
+irq_handler_t irq_get_exclusive_handler(uint num);
+void irq_set_enabled(uint num, bool enabled);
+bool irq_is_enabled(uint num);
+
+#endif  // EMU_HARDWARE_IRQ_H
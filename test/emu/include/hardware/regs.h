@@ -0,0 +1,86 @@
+/**
+ * @file hardware/regs.h
+ * @brief Host 模擬器：Pico SDK 暫存器型別與 UART 暫存器 bit 定義 (RP2350 數值)
+ */
+#ifndef EMU_HARDWARE_REGS_H
+#define EMU_HARDWARE_REGS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef unsigned int uint;
+
+typedef volatile uint32_t io_rw_32;
+typedef volatile uint32_t io_ro_32;
+typedef volatile uint32_t io_wo_32;
+
+// --- IRQ 編號 (RP2350) ---
+#define TIMER0_IRQ_0 0
+#define DMA_IRQ_0 10
+#define DMA_IRQ_1 11
+#define UART0_IRQ 33
+#define UART1_IRQ 34
+
+// --- DREQ (RP2350) ---
+#define DREQ_UART0_TX 28
+#define DREQ_UART0_RX 29
+#define DREQ_UART1_TX 30
+#define DREQ_UART1_RX 31
+#define DREQ_FORCE 0x3f
+
+// --- UART (PL011) ---
+#define UART_UARTDR_FE_BITS 0x00000100u
+#define UART_UARTDR_PE_BITS 0x00000200u
+#define UART_UARTDR_BE_BITS 0x00000400u
+#define UART_UARTDR_OE_BITS 0x00000800u
+
+#define UART_UARTFR_BUSY_BITS 0x00000008u
+#define UART_UARTFR_RXFE_BITS 0x00000010u
+#define UART_UARTFR_TXFF_BITS 0x00000020u
+#define UART_UARTFR_RXFF_BITS 0x00000040u
+#define UART_UARTFR_TXFE_BITS 0x00000080u
+
+#define UART_UARTIFLS_TXIFLSEL_LSB 0
+#define UART_UARTIFLS_TXIFLSEL_BITS 0x00000007u
+#define UART_UARTIFLS_RXIFLSEL_LSB 3
+#define UART_UARTIFLS_RXIFLSEL_BITS 0x00000038u
+
+#define UART_UARTLCR_H_FEN_BITS 0x00000010u
+
+// IMSC / RIS / MIS / ICR 共用相同的 bit 位置
+#define UART_UARTIMSC_RXIM_BITS 0x00000010u
+#define UART_UARTIMSC_TXIM_BITS 0x00000020u
+#define UART_UARTIMSC_RTIM_BITS 0x00000040u
+#define UART_UARTIMSC_FEIM_BITS 0x00000080u
+#define UART_UARTIMSC_PEIM_BITS 0x00000100u
+#define UART_UARTIMSC_BEIM_BITS 0x00000200u
+#define UART_UARTIMSC_OEIM_BITS 0x00000400u
+#define UART_UARTMIS_FEMIS_LSB 7
+
+#define UART_UARTIMSC_BITS 0x000007f0u
+
+#define UART_UARTCR_UARTEN_BITS 0x00000001u
+#define UART_UARTCR_TXE_BITS 0x00000100u
+#define UART_UARTCR_RXE_BITS 0x00000200u
+#define UART_UARTCR_RTSEN_BITS 0x00004000u
+#define UART_UARTCR_CTSEN_BITS 0x00008000u
+
+#define UART_UARTDMACR_RXDMAE_BITS 0x00000001u
+#define UART_UARTDMACR_TXDMAE_BITS 0x00000002u
+
+static inline void hw_set_bits(io_rw_32* addr, uint32_t mask)
+{
+    *addr |= mask;
+}
+
+static inline void hw_clear_bits(io_rw_32* addr, uint32_t mask)
+{
+    *addr &= ~mask;
+}
+
+static inline void hw_write_masked(io_rw_32* addr, uint32_t values, uint32_t write_mask)
+{
+    *addr = (*addr & ~write_mask) | (values & write_mask);
+}
+
+#endif  // EMU_HARDWARE_REGS_H
@@ -0,0 +1,13 @@
+/**
+ * @file hardware/sync.h
+ * @brief Host 模擬器：全域中斷開關 (關中斷期間模擬器不會派送 IRQ)
+ */
+#ifndef EMU_HARDWARE_SYNC_H
+#define EMU_HARDWARE_SYNC_H
+
+#include "hardware/regs.h"
+
+uint32_t save_and_disable_interrupts(void);
+void restore_interrupts(uint32_t status);
+
+#endif  // EMU_HARDWARE_SYNC_H
@@ -0,0 +1,62 @@
+/**
+ * @file hardware/uart.h
+ * @brief Host 模擬器：PL011 UART (32-byte FIFO、baud 時序、RX timeout、錯誤旗標)
+ * @note  暫存器只是一般記憶體，CPU 讀寫沒有副作用，因此：
+ *        - 讀 DR 的 FIFO pop 發生在 uart_is_readable() 回傳 true 的那一刻，
+ *          呼叫端必須在每次 true 之後讀一次 (且只讀一次) DR
+ *        - ICR 的寫入在 ISR 返回後由模擬器處理
+ */
+#ifndef EMU_HARDWARE_UART_H
+#define EMU_HARDWARE_UART_H
+
+#include <stddef.h>
+
+#include "hardware/regs.h"
+
+typedef struct
+{
+    io_rw_32 dr;
+    io_rw_32 rsr;
+    io_ro_32 fr;
+    io_rw_32 ibrd;
+    io_rw_32 fbrd;
+    io_rw_32 lcr_h;
+    io_rw_32 cr;
+    io_rw_32 ifls;
+    io_rw_32 imsc;
+    io_ro_32 ris;
+    io_ro_32 mis;
+    io_wo_32 icr;
+    io_rw_32 dmacr;
+} uart_hw_t;
+
+typedef struct uart_inst uart_inst_t;
+
+typedef enum
+{
+    UART_PARITY_NONE,
+    UART_PARITY_EVEN,
+    UART_PARITY_ODD
+} uart_parity_t;
+
+#define uart0 (uart_get_instance(0))
+#define uart1 (uart_get_instance(1))
+
+uart_inst_t* uart_get_instance(uint num);
+uint uart_get_index(uart_inst_t* uart);
+uart_hw_t* uart_get_hw(uart_inst_t* uart);
+
+uint uart_init(uart_inst_t* uart, uint baudrate);
+uint uart_set_baudrate(uart_inst_t* uart, uint baudrate);
+void uart_set_format(uart_inst_t* uart, uint data_bits, uint stop_bits, uart_parity_t parity);
+void uart_set_fifo_enabled(uart_inst_t* uart, bool enabled);
+void uart_set_hw_flow(uart_inst_t* uart, bool cts, bool rts);
+void uart_set_irq_enables(uart_inst_t* uart, bool rx_has_data, bool tx_needs_data);
+
+bool uart_is_readable(uart_inst_t* uart);
+bool uart_is_writable(uart_inst_t* uart);
+void uart_write_blocking(uart_inst_t* uart, const uint8_t* src, size_t len);
+
+uint uart_get_dreq(uart_inst_t* uart, bool is_tx);
+
+#endif  // EMU_HARDWARE_UART_H
@@ -0,0 +1,13 @@
+/**
+ * @file pico/stdlib.h
+ * @brief Host 模擬器：驅動程式用到的 Pico SDK 子集合 (實作在 test/emu/emu_*.c)
+ */
+#ifndef EMU_PICO_STDLIB_H
+#define EMU_PICO_STDLIB_H
+
+#include "hardware/gpio.h"
+#include "hardware/regs.h"
+#include "hardware/uart.h"
+#include "pico/time.h"
+
+#endif  // EMU_PICO_STDLIB_H
@@ -0,0 +1,33 @@
+/**
+ * @file pico/time.h
+ * @brief Host 模擬器：虛擬時鐘與 repeating timer (在 timer IRQ context 執行 callback)
+ */
+#ifndef EMU_PICO_TIME_H
+#define EMU_PICO_TIME_H
+
+#include "hardware/regs.h"
+
+typedef struct repeating_timer repeating_timer_t;
+typedef bool (*repeating_timer_callback_t)(repeating_timer_t* rt);
+
+struct repeating_timer
+{
+    int64_t delay_us;
+    repeating_timer_callback_t callback;
+    void* user_data;
+    int32_t alarm_id;
+};
+
+uint32_t time_us_32(void);
+uint64_t time_us_64(void);
+
+bool add_repeating_timer_us(int64_t delay_us, repeating_timer_callback_t callback, void* user_data,
+                            repeating_timer_t* out);
+bool cancel_repeating_timer(repeating_timer_t* timer);
+
+/** CPU 忙等：虛擬時鐘前進 (期間照常派送中斷) */
+void busy_wait_us(uint64_t delay_us);
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
+
+#endif  // EMU_PICO_TIME_H
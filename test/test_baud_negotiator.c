@@ -0,0 +1,241 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "baud_negotiator.h"
+#include "hal_uart.h"  // HAL_UART_BAUD_MIN / MAX
+#include "sentinel_core.h"
+#include "unity.h"
+
+// ==========================================
+// 1. 模擬 Link (虛擬時鐘 + 兩端各自的 baud)
+// ==========================================
+// 線上每個 byte = 10 bits (8N1)；兩端 baud 不同時對端只會收到亂碼
+typedef struct
+{
+    uint32_t dev_baud;           // 受測端 (韌體) 速率
+    uint32_t host_baud;          // 對端 (PC) 速率
+    uint64_t now_us;             // 虛擬時鐘
+    uint64_t tx_busy_until_us;   // 受測端 TX 線上忙碌到何時
+    uint64_t tx_bytes;           // 受測端送出的總 byte 數
+    char host_last_line[32];     // 對端最後收到的一行 ("?" = 速率不符的亂碼)
+    int host_lines;
+} sim_link_t;
+
+static sim_link_t link;
+static baud_negotiator_t neg;
+static sentinel_parser_t parser;  // 受測端的 UART 指令解析器
+
+static uint64_t wire_time_us(uint32_t baud, uint32_t bytes)
+{
+    return ((uint64_t)bytes * 10u * 1000000u + baud - 1) / baud;
+}
+
+static void sim_send_bytes(uint32_t len)
+{
+    uint64_t start = (link.tx_busy_until_us > link.now_us) ? link.tx_busy_until_us : link.now_us;
+    link.tx_busy_until_us = start + wire_time_us(link.dev_baud, len);
+    link.tx_bytes += len;
+}
+
+static void sim_send(void* ctx, const char* line)
+{
+    (void)ctx;
+    sim_send_bytes((uint32_t)strlen(line));
+
+    bool readable = (link.dev_baud == link.host_baud);
+    snprintf(link.host_last_line, sizeof(link.host_last_line), "%s", readable ? line : "?");
+    link.host_lines++;
+}
+
+static bool sim_tx_idle(void* ctx)
+{
+    (void)ctx;
+    return link.now_us >= link.tx_busy_until_us;
+}
+
+static uint32_t sim_set_baud(void* ctx, uint32_t baud)
+{
+    (void)ctx;
+    if (baud < HAL_UART_BAUD_MIN || baud > HAL_UART_BAUD_MAX) return 0;
+    link.dev_baud = baud;
+    return baud;
+}
+
+static const baud_link_ops_t sim_ops = {
+    .set_baud = sim_set_baud, .tx_idle = sim_tx_idle, .send = sim_send, .ctx = NULL};
+
+static uint32_t now_ms(void)
+{
+    return (uint32_t)(link.now_us / 1000u);
+}
+
+// 受測端收到一行：速率一致才是有效字元，否則餵入亂碼 (與 main.c 的 Cmd_SetBaud / Cmd_BaudConfirm 相同分派)
+static void device_rx(const char* line)
+{
+    bool readable = (link.dev_baud == link.host_baud);
+    for (const char* p = line; *p; p++)
+    {
+        char c = readable ? *p : (char)0xF0;
+        if (*p == '\n') c = '\n';  // 讓解析器在行尾重置
+
+        SystemCmd_t cmd = Sentinel_ParseChar(&parser, c);
+        if (cmd == CMD_SET_BAUD)
+        {
+            BaudNeg_Request(&neg, Sentinel_LastCmd(&parser)->args.num[0], now_ms());
+        }
+        else if (cmd == CMD_BAUD_CONFIRM)
+        {
+            BaudNeg_Confirm(&neg, now_ms());
+        }
+    }
+}
+
+static void advance_ms(uint32_t ms)
+{
+    for (uint32_t i = 0; i < ms; i++)
+    {
+        link.now_us += 1000;
+        BaudNeg_Poll(&neg, now_ms());
+    }
+}
+
+// 完整協商流程：host_follows = 對端收到 ACK 後是否跟著切換
+static void negotiate(uint32_t baud, bool host_follows)
+{
+    char cmd[24];
+    snprintf(cmd, sizeof(cmd), "BAUD %lu\n", (unsigned long)baud);
+    device_rx(cmd);
+    advance_ms(5);  // ACK 送完 → 受測端切換
+
+    if (host_follows && strncmp(link.host_last_line, "BAUD ACK", 8) == 0)
+    {
+        link.host_baud = baud;
+    }
+    device_rx("BAUD OK\n");
+    advance_ms(5);
+}
+
+// ==========================================
+// 2. Test Cases
+// ==========================================
+void setUp(void)
+{
+    memset(&link, 0, sizeof(link));
+    link.dev_baud = 115200;
+    link.host_baud = 115200;
+    BaudNeg_Init(&neg, &sim_ops, 115200, BAUD_NEG_TIMEOUT_MS);
+    Sentinel_ParserInit(&parser, 0);
+}
+
+void tearDown(void) {}
+
+void test_parser_should_extract_baud_argument(void)
+{
+    const char* in = "BAUD 921600\n";
+    SystemCmd_t cmd = CMD_NONE;
+    for (const char* p = in; *p; p++) cmd = Sentinel_ParseChar(&parser, *p);
+
+    TEST_ASSERT_EQUAL(CMD_SET_BAUD, cmd);
+    TEST_ASSERT_EQUAL_UINT32(921600, Sentinel_LastCmd(&parser)->args.num[0]);
+
+    in = "BAUD 12x\n";
+    for (const char* p = in; *p; p++) cmd = Sentinel_ParseChar(&parser, *p);
+    TEST_ASSERT_EQUAL(CMD_NONE, cmd);
+
+    in = "BAUD OK\n";
+    for (const char* p = in; *p; p++) cmd = Sentinel_ParseChar(&parser, *p);
+    TEST_ASSERT_EQUAL(CMD_BAUD_CONFIRM, cmd);
+}
+
+void test_negotiation_should_ack_drain_switch_and_lock(void)
+{
+    device_rx("BAUD 3000000\n");
+    TEST_ASSERT_EQUAL_STRING("BAUD ACK 3000000\n", link.host_last_line);
+    TEST_ASSERT_EQUAL(BAUD_NEG_DRAINING, neg.state);
+
+    // ACK 還在線上時不能切換 (否則最後幾個 byte 會以新速率送出)
+    TEST_ASSERT_FALSE(sim_tx_idle(NULL));
+    BaudNeg_Poll(&neg, now_ms());
+    TEST_ASSERT_EQUAL_UINT32(115200, link.dev_baud);
+
+    advance_ms(5);
+    TEST_ASSERT_EQUAL_UINT32(3000000, link.dev_baud);
+    TEST_ASSERT_EQUAL(BAUD_NEG_AWAIT_CONFIRM, neg.state);
+
+    link.host_baud = 3000000;
+    device_rx("BAUD OK\n");
+    TEST_ASSERT_EQUAL(BAUD_NEG_IDLE, neg.state);
+    TEST_ASSERT_EQUAL_STRING("BAUD LOCKED 3000000\n", link.host_last_line);
+}
+
+void test_negotiation_should_revert_when_peer_does_not_follow(void)
+{
+    negotiate(921600, false);
+    TEST_ASSERT_EQUAL(BAUD_NEG_AWAIT_CONFIRM, neg.state);  // 亂碼不算確認
+
+    advance_ms(BAUD_NEG_TIMEOUT_MS);
+    TEST_ASSERT_EQUAL(BAUD_NEG_IDLE, neg.state);
+    TEST_ASSERT_EQUAL_UINT32(115200, link.dev_baud);
+    TEST_ASSERT_EQUAL_STRING("BAUD REVERT 115200\n", link.host_last_line);
+
+    // 退回後仍可正常溝通
+    device_rx("PING\n");
+    TEST_ASSERT_EQUAL_UINT32(115200, neg.baud);
+}
+
+void test_negotiation_should_nak_unsupported_rate(void)
+{
+    device_rx("BAUD 20000000\n");  // 超過 HAL_UART_BAUD_MAX
+    advance_ms(5);
+    TEST_ASSERT_EQUAL_STRING("BAUD NAK\n", link.host_last_line);
+    TEST_ASSERT_EQUAL_UINT32(115200, link.dev_baud);
+    TEST_ASSERT_EQUAL(BAUD_NEG_IDLE, neg.state);
+
+    // 協商中再收到請求也回 NAK
+    device_rx("BAUD 921600\n");
+    device_rx("BAUD 460800\n");
+    TEST_ASSERT_EQUAL_STRING("BAUD NAK\n", link.host_last_line);
+    TEST_ASSERT_EQUAL_UINT32(921600, neg.pending_baud);
+}
+
+// 以模擬 link 量測遙測吞吐量：協商前 (115200) vs 協商後 (3 Mbaud)
+static double measure_kib_per_s(uint32_t bytes)
+{
+    advance_ms(1);
+    uint64_t start = link.now_us;
+    link.tx_busy_until_us = start;
+    for (uint32_t sent = 0; sent < bytes; sent += 64)
+    {
+        sim_send_bytes(64);
+    }
+    double secs = (double)(link.tx_busy_until_us - start) / 1e6;
+
+    link.now_us = link.tx_busy_until_us;  // 等遙測送完，後續協商才不會卡在 TX
+    return (double)bytes / 1024.0 / secs;
+}
+
+void test_throughput_gain_after_negotiation(void)
+{
+    const uint32_t telemetry = 64 * 1024;
+
+    double before = measure_kib_per_s(telemetry);
+    negotiate(3000000, true);
+    TEST_ASSERT_EQUAL_UINT32(3000000, neg.baud);
+    double after = measure_kib_per_s(telemetry);
+
+    printf("throughput: 115200 = %.1f KiB/s, 3000000 = %.1f KiB/s (x%.1f)\n", before, after,
+           after / before);
+    TEST_ASSERT_TRUE(before < 12.0);  // 約 11 KiB/s 的上限
+    TEST_ASSERT_TRUE(after / before > 25.0);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_parser_should_extract_baud_argument);
+    RUN_TEST(test_negotiation_should_ack_drain_switch_and_lock);
+    RUN_TEST(test_negotiation_should_revert_when_peer_does_not_follow);
+    RUN_TEST(test_negotiation_should_nak_unsupported_rate);
+    RUN_TEST(test_throughput_gain_after_negotiation);
+    return UNITY_END();
+}
@@ -0,0 +1,196 @@
+// 檔案位置: test/test_bip_buffer.c
+// Variable-length Record Ring (Bip-buffer) 單元測試 + 雙執行緒 Frame 壓力測試
+
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+
+#include "bip_buffer.h"
+#include "unity.h"
+
+#define TEST_BUF_SIZE 64
+static uint32_t raw_words[TEST_BUF_SIZE / 4];  // 以 uint32_t 宣告確保 4-byte 對齊
+static bip_buffer_t bip;
+
+void setUp(void)
+{
+    memset(raw_words, 0, sizeof(raw_words));
+    bip_init(&bip, (uint8_t*)raw_words, TEST_BUF_SIZE);
+}
+
+void tearDown(void) {}
+
+static void publish(const char* text)
+{
+    uint32_t len = (uint32_t)strlen(text);
+    uint8_t* slot = bip_reserve(&bip, len);
+    TEST_ASSERT_NOT_NULL(slot);
+    memcpy(slot, text, len);
+    TEST_ASSERT_TRUE(bip_commit(&bip, len));
+}
+
+// ==========================================
+// 1. 單執行緒功能測試
+// ==========================================
+void test_Bip_ReserveCommitPeek_Should_ReturnWholeRecords(void)
+{
+    publish("INV");
+    publish("PING");
+
+    uint32_t len;
+    const uint8_t* rec = bip_peek(&bip, &len);
+    TEST_ASSERT_NOT_NULL(rec);
+    TEST_ASSERT_EQUAL_UINT32(3, len);
+    TEST_ASSERT_EQUAL_MEMORY("INV", rec, 3);
+    bip_release(&bip);
+
+    rec = bip_peek(&bip, &len);
+    TEST_ASSERT_EQUAL_UINT32(4, len);
+    TEST_ASSERT_EQUAL_MEMORY("PING", rec, 4);
+    bip_release(&bip);
+
+    TEST_ASSERT_NULL(bip_peek(&bip, &len));
+    TEST_ASSERT_TRUE(bip_is_empty(&bip));
+}
+
+void test_Bip_Commit_Should_AllowShorterThanReserved(void)
+{
+    // 模擬 DMA 預留 20 bytes 但只收到 5 bytes
+    uint8_t* slot = bip_reserve(&bip, 20);
+    memcpy(slot, "HELLO", 5);
+    TEST_ASSERT_FALSE(bip_commit(&bip, 21));
+    TEST_ASSERT_TRUE(bip_commit(&bip, 5));
+    TEST_ASSERT_FALSE(bip_commit(&bip, 5));  // 沒有 pending reservation
+
+    uint32_t len;
+    const uint8_t* rec = bip_peek(&bip, &len);
+    TEST_ASSERT_EQUAL_UINT32(5, len);
+    TEST_ASSERT_EQUAL_MEMORY("HELLO", rec, 5);
+}
+
+void test_Bip_Record_Should_NeverStraddleTheEnd(void)
+{
+    // 佔用 0..39 (24 + 16 bytes) 後釋放，write/read 停在 offset 40 (尾端只剩 24 bytes)
+    publish("0123456789ABCDEFGHIJ");
+    publish("0123456789AB");
+    uint32_t len;
+    bip_peek(&bip, &len);
+    bip_release(&bip);
+    bip_peek(&bip, &len);
+    bip_release(&bip);
+
+    // 需要 4 + 26 → 32 bytes，放不下尾端 → 從 offset 0 開始 (連續指標)
+    uint8_t* slot = bip_reserve(&bip, 26);
+    TEST_ASSERT_EQUAL_PTR((uint8_t*)raw_words + BIP_HEADER_SIZE, slot);
+    memset(slot, 0xAB, 26);
+    bip_commit(&bip, 26);
+
+    const uint8_t* rec = bip_peek(&bip, &len);
+    TEST_ASSERT_EQUAL_PTR(slot, rec);
+    TEST_ASSERT_EQUAL_UINT32(26, len);
+    bip_release(&bip);
+    TEST_ASSERT_TRUE(bip_is_empty(&bip));
+}
+
+void test_Bip_Reserve_Should_FailWhenFullOrTooLarge(void)
+{
+    TEST_ASSERT_NULL(bip_reserve(&bip, TEST_BUF_SIZE / 2 - BIP_HEADER_SIZE + 1));
+
+    publish("0123456789ABCDEFGHIJKLMNOPQR");  // 4 + 28 = 32 bytes
+    publish("0123456789ABCDEFGHIJKLMNOPQR");  // 剛好填滿
+    TEST_ASSERT_NULL(bip_reserve(&bip, 1));
+
+    uint32_t len;
+    bip_peek(&bip, &len);
+    bip_release(&bip);
+    TEST_ASSERT_NOT_NULL(bip_reserve(&bip, 1));
+}
+
+// ==========================================
+// 2. 雙執行緒 Frame 壓力測試
+// ==========================================
+// Producer 發佈長度 1..60 的 Frame，內容為 (frame 序號 + index)；
+// Consumer 就地驗證長度與內容，確保沒有遺失、撕裂或錯序。
+
+#define STRESS_BUF_SIZE 1024
+#define STRESS_FRAMES 200000u
+
+static uint32_t stress_words[STRESS_BUF_SIZE / 4];
+static bip_buffer_t stress_bip;
+
+static void backoff(void)
+{
+    struct timespec ts = {0, 1000};
+    nanosleep(&ts, NULL);
+}
+
+static inline uint32_t frame_len(uint32_t n)
+{
+    return 1 + (n * 7u) % 60u;
+}
+
+static void* producer_thread(void* arg)
+{
+    (void)arg;
+    for (uint32_t n = 0; n < STRESS_FRAMES; n++)
+    {
+        uint32_t len = frame_len(n);
+        uint8_t* slot;
+        while ((slot = bip_reserve(&stress_bip, len)) == NULL)
+        {
+            backoff();
+        }
+        for (uint32_t i = 0; i < len; i++)
+        {
+            slot[i] = (uint8_t)(n + i);
+        }
+        bip_commit(&stress_bip, len);
+    }
+    return NULL;
+}
+
+void test_Bip_TwoThreads_Should_DeliverIntactFramesInOrder(void)
+{
+    pthread_t prod;
+    bool ok = true;
+
+    bip_init(&stress_bip, (uint8_t*)stress_words, STRESS_BUF_SIZE);
+    pthread_create(&prod, NULL, producer_thread, NULL);
+
+    for (uint32_t n = 0; n < STRESS_FRAMES;)
+    {
+        uint32_t len;
+        const uint8_t* rec = bip_peek(&stress_bip, &len);
+        if (rec == NULL)
+        {
+            backoff();
+            continue;
+        }
+
+        if (len != frame_len(n))
+        {
+            ok = false;
+        }
+        for (uint32_t i = 0; i < len && ok; i++)
+        {
+            ok = (rec[i] == (uint8_t)(n + i));
+        }
+        bip_release(&stress_bip);
+        n++;
+    }
+
+    pthread_join(prod, NULL);
+    TEST_ASSERT_TRUE_MESSAGE(ok, "Frame corrupted or out of order");
+    TEST_ASSERT_TRUE(bip_is_empty(&stress_bip));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_Bip_ReserveCommitPeek_Should_ReturnWholeRecords);
+    RUN_TEST(test_Bip_Commit_Should_AllowShorterThanReserved);
+    RUN_TEST(test_Bip_Record_Should_NeverStraddleTheEnd);
+    RUN_TEST(test_Bip_Reserve_Should_FailWhenFullOrTooLarge);
+    RUN_TEST(test_Bip_TwoThreads_Should_DeliverIntactFramesInOrder);
+    return UNITY_END();
+}
@@ -0,0 +1,177 @@
+// 檔案位置: test/test_event_queue.c
+// Multi-Producer Event Queue 單元測試 + 多執行緒 Producer 壓力測試
+
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+
+#include "event_queue.h"
+#include "unity.h"
+
+#define TEST_SLOTS 4
+static evq_slot_t slots[TEST_SLOTS];
+static event_queue_t q;
+
+void setUp(void)
+{
+    evq_init(&q, slots, TEST_SLOTS);
+}
+
+void tearDown(void) {}
+
+// ==========================================
+// 1. 單執行緒功能測試
+// ==========================================
+void test_EventQueue_PushPop_Should_KeepTagAndTimestamp(void)
+{
+    TEST_ASSERT_TRUE(evq_push(&q, EVQ_SRC_UART, (const uint8_t*)"PING", 4, 1000));
+    TEST_ASSERT_TRUE(evq_push(&q, EVQ_SRC_USB, NULL, 0, 2000));
+
+    input_event_t ev;
+    TEST_ASSERT_TRUE(evq_pop(&q, &ev));
+    TEST_ASSERT_EQUAL_UINT8(EVQ_SRC_UART, ev.source);
+    TEST_ASSERT_EQUAL_UINT8(4, ev.len);
+    TEST_ASSERT_EQUAL_UINT32(1000, ev.timestamp_us);
+    TEST_ASSERT_EQUAL_MEMORY("PING", ev.data, 4);
+
+    TEST_ASSERT_TRUE(evq_pop(&q, &ev));
+    TEST_ASSERT_EQUAL_UINT8(EVQ_SRC_USB, ev.source);
+    TEST_ASSERT_EQUAL_UINT8(0, ev.len);
+
+    TEST_ASSERT_FALSE(evq_pop(&q, &ev));
+}
+
+void test_EventQueue_Full_Should_CountDrops(void)
+{
+    for (int i = 0; i < TEST_SLOTS; i++)
+    {
+        TEST_ASSERT_TRUE(evq_push(&q, EVQ_SRC_TIMER, NULL, 0, i));
+    }
+    TEST_ASSERT_EQUAL_UINT32(TEST_SLOTS, evq_count(&q));
+    TEST_ASSERT_FALSE(evq_push(&q, EVQ_SRC_TIMER, NULL, 0, 99));
+    TEST_ASSERT_EQUAL_UINT32(1, evq_dropped(&q));
+    TEST_ASSERT_EQUAL_UINT32(TEST_SLOTS, evq_count(&q));  // 被丟棄的不算
+
+    // 讀出一筆後 slot 交還給 Producer，可以再寫入 (第二輪)
+    input_event_t ev;
+    TEST_ASSERT_TRUE(evq_pop(&q, &ev));
+    TEST_ASSERT_EQUAL_UINT32(0, ev.timestamp_us);
+    TEST_ASSERT_EQUAL_UINT32(TEST_SLOTS - 1, evq_count(&q));
+    TEST_ASSERT_TRUE(evq_push(&q, EVQ_SRC_TIMER, NULL, 0, 4));
+}
+
+void test_EventQueue_PushSpan_Should_SplitLongSpans(void)
+{
+    uint8_t span[EVQ_PAYLOAD_MAX * 2 + 3];
+    for (size_t i = 0; i < sizeof(span); i++)
+    {
+        span[i] = (uint8_t)i;
+    }
+
+    TEST_ASSERT_EQUAL_size_t(sizeof(span), evq_push_span(&q, EVQ_SRC_UART, span, sizeof(span), 7));
+
+    input_event_t ev;
+    size_t offset = 0;
+    while (evq_pop(&q, &ev))
+    {
+        TEST_ASSERT_EQUAL_MEMORY(&span[offset], ev.data, ev.len);
+        offset += ev.len;
+    }
+    TEST_ASSERT_EQUAL_size_t(sizeof(span), offset);
+}
+
+void test_EventQueue_Push_Should_RejectOversizedPayload(void)
+{
+    uint8_t big[EVQ_PAYLOAD_MAX + 1] = {0};
+    TEST_ASSERT_FALSE(evq_push(&q, EVQ_SRC_UART, big, sizeof(big), 0));
+}
+
+// ==========================================
+// 2. 多 Producer 壓力測試 (模擬 UART ISR / USB / Timer 同時推入)
+// ==========================================
+// 每個 Producer 以遞增序號作為 payload；Consumer 檢查每個來源的序號
+// 連續且不重複 (同一來源內的順序必須保持)，全部來源總數不可遺失。
+
+#define STRESS_SLOTS 256
+#define STRESS_PER_PRODUCER 200000u
+
+static evq_slot_t stress_slots[STRESS_SLOTS];
+static event_queue_t stress_q;
+
+static void backoff(void)
+{
+    struct timespec ts = {0, 1000};
+    nanosleep(&ts, NULL);
+}
+
+static void* producer_thread(void* arg)
+{
+    uint8_t source = (uint8_t)(uintptr_t)arg;
+    for (uint32_t seq = 0; seq < STRESS_PER_PRODUCER; seq++)
+    {
+        while (!evq_push(&stress_q, source, (const uint8_t*)&seq, sizeof(seq), seq))
+        {
+            backoff();
+        }
+    }
+    return NULL;
+}
+
+void test_EventQueue_MultiProducer_Should_NotLoseOrReorderPerSource(void)
+{
+    pthread_t prod[EVQ_SRC_COUNT];
+    uint32_t expected[EVQ_SRC_COUNT] = {0};
+    bool order_ok = true;
+
+    evq_init(&stress_q, stress_slots, STRESS_SLOTS);
+    for (uintptr_t s = 0; s < EVQ_SRC_COUNT; s++)
+    {
+        pthread_create(&prod[s], NULL, producer_thread, (void*)s);
+    }
+
+    uint32_t received = 0;
+    while (received < STRESS_PER_PRODUCER * EVQ_SRC_COUNT)
+    {
+        input_event_t ev;
+        if (!evq_pop(&stress_q, &ev))
+        {
+            backoff();
+            continue;
+        }
+
+        uint32_t seq;
+        memcpy(&seq, ev.data, sizeof(seq));
+        if (ev.source >= EVQ_SRC_COUNT || seq != expected[ev.source])
+        {
+            order_ok = false;
+        }
+        else
+        {
+            expected[ev.source]++;
+        }
+        received++;
+    }
+
+    for (int s = 0; s < EVQ_SRC_COUNT; s++)
+    {
+        pthread_join(prod[s], NULL);
+        TEST_ASSERT_EQUAL_UINT32(STRESS_PER_PRODUCER, expected[s]);
+    }
+    TEST_ASSERT_TRUE_MESSAGE(order_ok, "Per-source order broken");
+
+    input_event_t ev;
+    TEST_ASSERT_FALSE(evq_pop(&stress_q, &ev));
+    TEST_ASSERT_EQUAL_UINT32(STRESS_PER_PRODUCER * EVQ_SRC_COUNT,
+                             atomic_load(&stress_q.enqueue_pos));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_EventQueue_PushPop_Should_KeepTagAndTimestamp);
+    RUN_TEST(test_EventQueue_Full_Should_CountDrops);
+    RUN_TEST(test_EventQueue_PushSpan_Should_SplitLongSpans);
+    RUN_TEST(test_EventQueue_Push_Should_RejectOversizedPayload);
+    RUN_TEST(test_EventQueue_MultiProducer_Should_NotLoseOrReorderPerSource);
+    return UNITY_END();
+}
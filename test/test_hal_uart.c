@@ -18,10 +18,12 @@ typedef struct
 
     // 狀態旗標
     bool data_ready;
+    uint8_t last_block_index;
 } Ultimate_UART_Ctx_t;
 
 static Ultimate_UART_Ctx_t my_system;
 static uart_handle_t h_uart;
+static const uart_config_t uart0_cfg = HAL_UART_CONFIG_DEFAULT;
 
 // ==========================================
 // 2. 實作終極 Callback (The Bridge)
@@ -40,24 +42,13 @@ void Ultimate_Callback(void* ctx, uart_event_t event, void* data)
     {
         // 🟢 [關鍵修正] 這裡必須要把資料從 DMA Buffer 搬到 Ring Buffer
 
-        // 1. 取得搬運長度 (假設 hal_uart.c 傳來的是長度指標)
-        // 如果您的 mock 傳的是 NULL，這裡可以直接用 10 (測試用)
-        uint16_t len = 0;
-        if (data != NULL)
-        {
-            len = *(uint16_t*)data;
-        }
-        else
-        {
-            len = 10;  // Fallback for test
-        }
+        // 1. 取得剛填滿的 Ping-Pong 緩衝區 (位址 + 長度)
+        const uart_dma_block_t* block = (const uart_dma_block_t*)data;
 
         // 2. 批量寫入 Ring Buffer
         // 這裡展現了 DMA Buffer (線性) -> Ring Buffer (環形) 的橋接
-        for (int i = 0; i < len; i++)
-        {
-            rb_push(&sys->rb, sys->dma_temp_buffer[i]);
-        }
+        rb_write(&sys->rb, block->data, block->len);
+        sys->last_block_index = block->index;
 
         // 3. 設定旗標，通知主程式
         sys->data_ready = true;
@@ -76,26 +67,19 @@ void test_day6_7_8_integration(void)
     memset(my_system.dma_temp_buffer, 0, 128);
 
     // 2. 初始化 UART & 註冊 Callback
-    HAL_UART_Init(&h_uart, 0);
+    HAL_UART_Init(&h_uart, &uart0_cfg);
     HAL_UART_RegisterCallback(&h_uart, Ultimate_Callback, &my_system);
 
     // 3. 設定 DMA (模擬設定暫存器)
-    // 告訴驅動層：之後收到的資料請搬到 my_system.dma_temp_buffer
-    HAL_UART_Receive_DMA(&h_uart, my_system.dma_temp_buffer, 10);
+    // 告訴驅動層：之後收到的資料請搬到 my_system.dma_temp_buffer (前後兩半各 10 bytes Ping-Pong)
+    HAL_UART_Receive_DMA(&h_uart, my_system.dma_temp_buffer, 20);
 
     // 4. [模擬硬體行為] DMA 搬運發生了！
     const char* burst_data = "SpeedTest!";
 
-    // ⚠️ 注意：這一步模擬了 "硬體把資料寫入記憶體" 的動作
-    // 如果您的 HAL_UART_SimulateDMA_Complete 裡面沒有寫 memcpy，
-    // 我們必須在這裡手動模擬 "硬體寫入"：
-    memcpy(my_system.dma_temp_buffer, burst_data, 10);
-
-    // 觸發中斷 (通知 Callback 說搬完了)
+    // SimulateDMA_Complete 會模擬硬體把資料寫入目前的緩衝區，再觸發中斷
     uint16_t len = 10;
-    // 這裡我們傳入 len 的地址，對應 Callback 裡的 *(uint16_t*)data
-    HAL_UART_SimulateDMA_Complete(&h_uart, NULL, len);
-    // 註：有些實作 SimulateDMA 會自己 memcpy，看您的 hal_uart.c 怎麼寫
+    HAL_UART_SimulateDMA_Complete(&h_uart, (const uint8_t*)burst_data, len);
 
     // 5. 驗證結果
 
@@ -114,6 +98,343 @@ void test_day6_7_8_integration(void)
     TEST_ASSERT_EQUAL_CHAR('p', byte);
 }
 
+void test_dma_ping_pong_should_alternate_buffers(void)
+{
+    static uint8_t buf_a[8];
+    static uint8_t buf_b[8];
+
+    rb_init(&my_system.rb, my_system.rb_storage, 1024);
+    HAL_UART_Init(&h_uart, &uart0_cfg);
+    HAL_UART_RegisterCallback(&h_uart, Ultimate_Callback, &my_system);
+    HAL_UART_Receive_DMA_DoubleBuffer(&h_uart, buf_a, buf_b, sizeof(buf_a));
+
+    HAL_UART_SimulateDMA_Complete(&h_uart, (const uint8_t*)"AAAAAAAA", 8);
+    TEST_ASSERT_EQUAL_UINT8(0, my_system.last_block_index);
+    TEST_ASSERT_EQUAL_MEMORY("AAAAAAAA", buf_a, 8);
+
+    // 第二個區塊寫入另一個緩衝區，buf_a 的內容保持不變 (處理期間不會被覆寫)
+    HAL_UART_SimulateDMA_Complete(&h_uart, (const uint8_t*)"BBBBBBBB", 8);
+    TEST_ASSERT_EQUAL_UINT8(1, my_system.last_block_index);
+    TEST_ASSERT_EQUAL_MEMORY("BBBBBBBB", buf_b, 8);
+    TEST_ASSERT_EQUAL_MEMORY("AAAAAAAA", buf_a, 8);
+
+    // 第三個區塊回到 buf_a；超過緩衝區長度的部分會被截斷
+    HAL_UART_SimulateDMA_Complete(&h_uart, (const uint8_t*)"CCCCCCCCCC", 10);
+    TEST_ASSERT_EQUAL_UINT8(0, my_system.last_block_index);
+    TEST_ASSERT_EQUAL_MEMORY("CCCCCCCC", buf_a, 8);
+
+    TEST_ASSERT_EQUAL_UINT32(24, rb_count(&my_system.rb));
+}
+
+// ==========================================
+// 4. FIFO 批次接收 (Day 10)
+// ==========================================
+typedef struct
+{
+    uint32_t callbacks;
+    uint32_t bytes;
+    uint8_t last[HAL_UART_FIFO_DEPTH];
+} Batch_Probe_t;
+
+static Batch_Probe_t probe;
+
+static void Batch_Callback(void* ctx, uart_event_t event, void* data)
+{
+    Batch_Probe_t* p = (Batch_Probe_t*)ctx;
+    p->callbacks++;
+    if (event == UART_EVENT_RX_SPAN)
+    {
+        const uart_rx_span_t* span = (const uart_rx_span_t*)data;
+        memcpy(p->last, span->data, span->len);
+        p->bytes += span->len;
+    }
+    else if (event == UART_EVENT_RX_COMPLETE)
+    {
+        p->bytes++;
+    }
+}
+
+void test_fifo_mode_should_deliver_one_span_per_interrupt(void)
+{
+    uint8_t burst[40];
+    for (int i = 0; i < 40; i++) burst[i] = (uint8_t)('A' + (i % 26));
+
+    memset(&probe, 0, sizeof(probe));
+    HAL_UART_Init(&h_uart, &uart0_cfg);
+    HAL_UART_RegisterCallback(&h_uart, Batch_Callback, &probe);
+    HAL_UART_SetRxMode(&h_uart, UART_RX_MODE_FIFO);
+
+    HAL_UART_SimulateFifoRx(&h_uart, burst, sizeof(burst));
+
+    // 40 bytes = 32 (FIFO 滿) + 8 (RX timeout) → 2 次中斷、2 次 Callback
+    TEST_ASSERT_EQUAL_UINT32(2, h_uart.rx_irq_count);
+    TEST_ASSERT_EQUAL_UINT32(2, probe.callbacks);
+    TEST_ASSERT_EQUAL_UINT32(40, probe.bytes);
+    TEST_ASSERT_EQUAL_MEMORY(&burst[32], probe.last, 8);
+}
+
+void test_byte_mode_should_interrupt_per_byte(void)
+{
+    uint8_t burst[40] = {0};
+
+    memset(&probe, 0, sizeof(probe));
+    HAL_UART_Init(&h_uart, &uart0_cfg);
+    HAL_UART_RegisterCallback(&h_uart, Batch_Callback, &probe);
+
+    HAL_UART_SimulateFifoRx(&h_uart, burst, sizeof(burst));
+
+    TEST_ASSERT_EQUAL_UINT32(40, h_uart.rx_irq_count);
+    TEST_ASSERT_EQUAL_UINT32(40, probe.callbacks);
+    TEST_ASSERT_EQUAL_UINT32(40, probe.bytes);
+}
+
+// ==========================================
+// Span Callback (BYTE / FIFO / DMA 共用)
+// ==========================================
+typedef struct
+{
+    uint32_t calls;
+    uint8_t port;
+    uint32_t timestamp_us;
+} Span_Probe_t;
+
+static Span_Probe_t span_probe;
+
+// 不論接收模式，一段資料一次 rb_write 即可
+static void Span_Callback(void* ctx, const uart_rx_span_t* span)
+{
+    Ultimate_UART_Ctx_t* sys = (Ultimate_UART_Ctx_t*)ctx;
+    rb_write(&sys->rb, span->data, span->len);
+    span_probe.calls++;
+    span_probe.port = span->port;
+    span_probe.timestamp_us = span->timestamp_us;
+}
+
+void test_span_callback_should_cover_all_rx_paths(void)
+{
+    static uint8_t dma_buf[16];
+    uint8_t burst[40];
+    for (int i = 0; i < 40; i++) burst[i] = (uint8_t)i;
+
+    memset(&span_probe, 0, sizeof(span_probe));
+    memset(&probe, 0, sizeof(probe));
+    rb_init(&my_system.rb, my_system.rb_storage, sizeof(my_system.rb_storage));
+    HAL_UART_Init(&h_uart, &uart0_cfg);
+    HAL_UART_RegisterCallback(&h_uart, Batch_Callback, &probe);
+    HAL_UART_RegisterSpanCallback(&h_uart, Span_Callback, &my_system);
+    HAL_UART_SimulateSetTime(1234);
+
+    // BYTE 模式：每次中斷 1 byte → 1 個 span
+    HAL_UART_SimulateFifoRx(&h_uart, burst, 3);
+    TEST_ASSERT_EQUAL_UINT32(3, span_probe.calls);
+    TEST_ASSERT_EQUAL_UINT8(0, span_probe.port);
+    TEST_ASSERT_EQUAL_UINT32(1234, span_probe.timestamp_us);
+
+    // FIFO 模式：一次中斷一個 span
+    HAL_UART_SetRxMode(&h_uart, UART_RX_MODE_FIFO);
+    HAL_UART_SimulateFifoRx(&h_uart, burst + 3, 37);
+    TEST_ASSERT_EQUAL_UINT32(3 + 2, span_probe.calls);
+
+    // DMA：每個填滿的 Ping-Pong 緩衝區一個 span
+    HAL_UART_Receive_DMA(&h_uart, dma_buf, sizeof(dma_buf));
+    HAL_UART_SimulateDMA_Complete(&h_uart, burst, 8);
+    TEST_ASSERT_EQUAL_UINT32(3 + 2 + 1, span_probe.calls);
+
+    // 舊的事件 Callback 不會再收到 RX 資料，資料完整依序進入 Ring Buffer
+    TEST_ASSERT_EQUAL_UINT32(0, probe.callbacks);
+    uint8_t out[48];
+    TEST_ASSERT_EQUAL_UINT32(48, rb_read(&my_system.rb, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_MEMORY(burst, out, 40);
+    TEST_ASSERT_EQUAL_MEMORY(burst, out + 40, 8);
+
+    // 取消註冊後回到逐 byte 的相容事件
+    HAL_UART_RegisterSpanCallback(&h_uart, NULL, NULL);
+    HAL_UART_SetRxMode(&h_uart, UART_RX_MODE_BYTE);
+    HAL_UART_SimulateISR(&h_uart, 0x55);
+    TEST_ASSERT_EQUAL_UINT32(1, probe.callbacks);
+}
+
+// ==========================================
+// 接收錯誤統計
+// ==========================================
+typedef struct
+{
+    uint32_t rx_bytes;
+    uint32_t error_events;
+    uart_error_event_t last_error;
+} Error_Probe_t;
+
+static void Error_Callback(void* ctx, uart_event_t event, void* data)
+{
+    Error_Probe_t* p = (Error_Probe_t*)ctx;
+    if (event == UART_EVENT_ERROR)
+    {
+        p->error_events++;
+        p->last_error = *(const uart_error_event_t*)data;
+    }
+    else if (event == UART_EVENT_RX_COMPLETE)
+    {
+        p->rx_bytes++;
+    }
+}
+
+void test_rx_errors_should_be_counted_and_reported(void)
+{
+    Error_Probe_t ep = {0};
+    HAL_UART_Init(&h_uart, &uart0_cfg);
+    HAL_UART_RegisterCallback(&h_uart, Error_Callback, &ep);
+
+    HAL_UART_SimulateRxError(&h_uart, 'A', 0);
+    HAL_UART_SimulateRxError(&h_uart, 0xFF, UART_ERR_FRAMING);
+    HAL_UART_SimulateRxError(&h_uart, 0x00, UART_ERR_BREAK | UART_ERR_FRAMING);
+    HAL_UART_SimulateRxError(&h_uart, 'B', UART_ERR_OVERRUN);
+    HAL_UART_SimulateRxError(&h_uart, 'C', UART_ERR_PARITY);
+
+    // 只有無錯誤與 overrun 的 byte 會往上送；overrun 的 byte 本身有效
+    TEST_ASSERT_EQUAL_UINT32(2, ep.rx_bytes);
+    TEST_ASSERT_EQUAL_UINT32(4, ep.error_events);
+    TEST_ASSERT_EQUAL_UINT8(0, ep.last_error.port);
+    TEST_ASSERT_EQUAL_HEX8(UART_ERR_PARITY, ep.last_error.flags);
+
+    uart_error_stats_t stats;
+    HAL_UART_GetErrorStats(&h_uart, &stats, true);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.framing);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.breaks);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.overrun);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.parity);
+
+    HAL_UART_GetErrorStats(&h_uart, &stats, false);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.framing + stats.breaks + stats.overrun + stats.parity);
+
+    // DMA 模式：字元被 DMA 讀走，改由錯誤中斷計數
+    static uint8_t dma_buf[16];
+    HAL_UART_Receive_DMA(&h_uart, dma_buf, sizeof(dma_buf));
+    HAL_UART_SimulateErrorIrq(&h_uart, UART_ERR_OVERRUN);
+    HAL_UART_GetErrorStats(&h_uart, &stats, false);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.overrun);
+    TEST_ASSERT_EQUAL_UINT32(5, ep.error_events);
+}
+
+// ==========================================
+// 多埠 (Multi-instance)
+// ==========================================
+static Batch_Probe_t probe1;
+static uart_handle_t h_uart1;
+
+void test_two_ports_should_dispatch_to_their_own_handle(void)
+{
+    memset(&probe, 0, sizeof(probe));
+    memset(&probe1, 0, sizeof(probe1));
+
+    // port 0：預設設定 (逐 byte)；port 1：不同腳位、高 baud、FIFO 模式
+    uart_config_t cfg1 = HAL_UART_CONFIG_DEFAULT;
+    cfg1.port = 1;
+    cfg1.tx_pin = 4;
+    cfg1.rx_pin = 5;
+    cfg1.baud = 921600;
+    cfg1.rx_mode = UART_RX_MODE_FIFO;
+
+    TEST_ASSERT_TRUE(HAL_UART_Init(&h_uart, &uart0_cfg));
+    TEST_ASSERT_TRUE(HAL_UART_Init(&h_uart1, &cfg1));
+    HAL_UART_RegisterCallback(&h_uart, Batch_Callback, &probe);
+    HAL_UART_RegisterCallback(&h_uart1, Batch_Callback, &probe1);
+
+    TEST_ASSERT_EQUAL_PTR(&h_uart, HAL_UART_GetHandle(0));
+    TEST_ASSERT_EQUAL_PTR(&h_uart1, HAL_UART_GetHandle(1));
+    TEST_ASSERT_EQUAL_UINT32(921600, h_uart1.baud);
+    TEST_ASSERT_EQUAL(UART_RX_MODE_FIFO, h_uart1.rx_mode);
+
+    uint8_t burst[40] = {0};
+    HAL_UART_SimulatePortRx(1, burst, sizeof(burst));
+    HAL_UART_SimulatePortRx(0, burst, 3);
+
+    // 各自的 handle / Callback / 模式互不干擾
+    TEST_ASSERT_EQUAL_UINT32(2, probe1.callbacks);
+    TEST_ASSERT_EQUAL_UINT32(40, probe1.bytes);
+    TEST_ASSERT_EQUAL_UINT32(3, probe.callbacks);
+    TEST_ASSERT_EQUAL_UINT32(3, probe.bytes);
+    TEST_ASSERT_EQUAL_UINT32(3, h_uart.rx_irq_count);
+}
+
+void test_init_should_reject_invalid_config(void)
+{
+    uart_config_t bad = HAL_UART_CONFIG_DEFAULT;
+    bad.port = HAL_UART_PORT_COUNT;
+
+    TEST_ASSERT_FALSE(HAL_UART_Init(&h_uart, &bad));
+    TEST_ASSERT_FALSE(HAL_UART_Init(&h_uart, NULL));
+    TEST_ASSERT_FALSE(HAL_UART_Init(NULL, &uart0_cfg));
+    TEST_ASSERT_NULL(HAL_UART_GetHandle(HAL_UART_PORT_COUNT));
+}
+
+void test_config_with_dma_buffer_should_start_ping_pong(void)
+{
+    uint8_t dma_buf[16];
+    uart_config_t cfg = HAL_UART_CONFIG_DEFAULT;
+    cfg.dma_rx_buf = dma_buf;
+    cfg.dma_rx_size = sizeof(dma_buf);
+
+    TEST_ASSERT_TRUE(HAL_UART_Init(&h_uart, &cfg));
+    TEST_ASSERT_TRUE(h_uart.dma_active);
+    TEST_ASSERT_EQUAL_PTR(dma_buf, h_uart.dma_rx_buffer[0]);
+    TEST_ASSERT_EQUAL_PTR(dma_buf + 8, h_uart.dma_rx_buffer[1]);
+    TEST_ASSERT_EQUAL_UINT16(8, h_uart.dma_rx_len);
+}
+
+void test_set_baud_should_validate_range(void)
+{
+    TEST_ASSERT_TRUE(HAL_UART_Init(&h_uart, &uart0_cfg));
+    TEST_ASSERT_EQUAL_UINT32(115200, h_uart.baud);
+
+    TEST_ASSERT_EQUAL_UINT32(3000000, HAL_UART_SetBaud(&h_uart, 3000000));
+    TEST_ASSERT_EQUAL_UINT32(3000000, h_uart.baud);
+
+    // 超出範圍：回傳 0，維持原設定
+    TEST_ASSERT_EQUAL_UINT32(0, HAL_UART_SetBaud(&h_uart, HAL_UART_BAUD_MAX + 1));
+    TEST_ASSERT_EQUAL_UINT32(0, HAL_UART_SetBaud(&h_uart, HAL_UART_BAUD_MIN - 1));
+    TEST_ASSERT_EQUAL_UINT32(3000000, h_uart.baud);
+
+    uart_config_t bad = HAL_UART_CONFIG_DEFAULT;
+    bad.baud = HAL_UART_BAUD_MAX + 1;
+    TEST_ASSERT_FALSE(HAL_UART_Init(&h_uart, &bad));
+}
+
+// 應用層 Ring Buffer 接近滿時以軟體 RTS 暫停對端，讀走後再恢復 (取代滿了直接丟資料)
+void test_sw_rts_should_follow_ring_buffer_watermarks(void)
+{
+    uart_config_t cfg = HAL_UART_CONFIG_DEFAULT;
+    cfg.flow = UART_FLOW_SW_RTS;
+    cfg.cts_pin = 2;
+    cfg.rts_pin = 3;
+
+    memset(&my_system, 0, sizeof(my_system));
+    rb_init(&my_system.rb, my_system.rb_storage, sizeof(my_system.rb_storage));
+    TEST_ASSERT_TRUE(HAL_UART_Init(&h_uart, &cfg));
+    HAL_UART_RegisterCallback(&h_uart, Ultimate_Callback, &my_system);
+    TEST_ASSERT_TRUE(rb_set_watermarks(&my_system.rb, 768, 256, HAL_UART_RtsWatermark, &h_uart));
+    TEST_ASSERT_FALSE(h_uart.rx_paused);
+
+    uint8_t burst[100] = {0};
+    for (int i = 0; i < 7; i++) HAL_UART_SimulatePortRx(0, burst, sizeof(burst));
+    TEST_ASSERT_FALSE(h_uart.rx_paused);  // 700 < 768
+
+    HAL_UART_SimulatePortRx(0, burst, sizeof(burst));
+    TEST_ASSERT_TRUE(h_uart.rx_paused);
+    TEST_ASSERT_EQUAL_UINT32(1, h_uart.rx_pause_count);
+
+    // 讀到 low 之上仍維持暫停 (hysteresis)，降到 low 才恢復
+    uint8_t sink[600];
+    rb_read(&my_system.rb, sink, 500);
+    TEST_ASSERT_TRUE(h_uart.rx_paused);
+    rb_read(&my_system.rb, sink, 100);
+    TEST_ASSERT_FALSE(h_uart.rx_paused);
+
+    // 沒有啟用流量控制時 SetRxReady 不做事
+    TEST_ASSERT_TRUE(HAL_UART_Init(&h_uart, &uart0_cfg));
+    HAL_UART_SetRxReady(&h_uart, false);
+    TEST_ASSERT_FALSE(h_uart.rx_paused);
+}
+
 // ==========================================
 // Unity 基礎設施
 // ==========================================
@@ -124,5 +445,15 @@ int main(void)
 {
     UNITY_BEGIN();
     RUN_TEST(test_day6_7_8_integration);
+    RUN_TEST(test_dma_ping_pong_should_alternate_buffers);
+    RUN_TEST(test_fifo_mode_should_deliver_one_span_per_interrupt);
+    RUN_TEST(test_byte_mode_should_interrupt_per_byte);
+    RUN_TEST(test_span_callback_should_cover_all_rx_paths);
+    RUN_TEST(test_rx_errors_should_be_counted_and_reported);
+    RUN_TEST(test_two_ports_should_dispatch_to_their_own_handle);
+    RUN_TEST(test_init_should_reject_invalid_config);
+    RUN_TEST(test_config_with_dma_buffer_should_start_ping_pong);
+    RUN_TEST(test_set_baud_should_validate_range);
+    RUN_TEST(test_sw_rts_should_follow_ring_buffer_watermarks);
     return UNITY_END();
 }
\ No newline at end of file
@@ -9,36 +9,60 @@
 // ==========================================
 
 // 補上缺失的 Macro
-#define UART_ID uart0
-#define UART_TX_PIN 0
-#define UART_RX_PIN 1
-#define BAUD_RATE 115200
-
 #define GPIO_FUNC_UART 2
+#define GPIO_OUT 1
 #define UART_PARITY_NONE 0
 #define DMA_SIZE_8 0
+#define DMA_SIZE_32 2
+#define DMA_IRQ_1 11
+#define UART0_IRQ 33
+#define UART1_IRQ 34
+#define UART_UARTIMSC_FEIM_BITS 0x00000080u
+#define UART_UARTIMSC_PEIM_BITS 0x00000100u
+#define UART_UARTIMSC_BEIM_BITS 0x00000200u
+#define UART_UARTIMSC_OEIM_BITS 0x00000400u
+#define UART_UARTMIS_FEMIS_LSB 7
+#define PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY 0x80
+
+typedef void (*irq_handler_t)(void);
+typedef unsigned int uint;
+
+typedef struct repeating_timer repeating_timer_t;
+typedef bool (*repeating_timer_callback_t)(repeating_timer_t* t);
+struct repeating_timer
+{
+    repeating_timer_callback_t callback;
+};
 
 // [修正 1] 定義硬體結構，包含 dr (Data Register)
+#define UART_UARTFR_BUSY_BITS 0x00000008u
+
 typedef struct
 {
     volatile uint32_t dr;
+    volatile uint32_t fr;
+    volatile uint32_t imsc;
+    volatile uint32_t mis;
+    volatile uint32_t icr;
 } uart_hw_t;
 
 typedef struct
 {
-    uint32_t write_addr;
+    uintptr_t write_addr;
+    uint32_t transfer_count;           // 剩餘傳輸次數 (倒數)
+    uint32_t al1_transfer_count_trig;  // control channel 寫入的目標
 } dma_channel_hw_t;
 
 typedef struct
 {
+    int unused;
 } uart_inst_t;
 typedef struct
 {
 } dma_channel_config;
 
 // 定義假變數
-static uart_inst_t mock_uart_inst;
-#define uart0 (&mock_uart_inst)
+static uart_inst_t mock_uart_insts[2];
 
 // 模擬硬體實體
 dma_channel_hw_t mock_dma_hw[12];
@@ -46,7 +70,25 @@ static uart_hw_t mock_uart_hw_regs;  // [修正 1] 假的 UART 硬體暫存器
 
 // 追蹤變數
 int mock_dma_claim_count = 0;
+int mock_dma_claim_limit = 12;  // 可申請的 channel 數 (模擬 DMA 資源不足)
+int mock_dma_unclaim_count = 0;
 bool mock_uart_fifo_enabled = false;
+uart_inst_t* mock_uart_init_inst = NULL;
+uint32_t mock_uart_init_baud = 0;
+bool mock_hw_cts = false;
+bool mock_hw_rts = false;
+int mock_rts_level = -1;  // 軟體 RTS 腳位目前的電位 (-1 = 未初始化)
+int mock_rts_toggles = 0;
+
+// TX DMA 追蹤：最近一次啟動的傳輸、完成旗標與註冊的中斷 handler
+const uint8_t* mock_tx_src = NULL;
+uint32_t mock_tx_count = 0;
+int mock_tx_starts = 0;
+uint32_t mock_dma_irq1_pending = 0;  // 每個 channel 一個 bit (INTS1)
+irq_handler_t mock_dma_irq1_handlers[4];
+int mock_dma_irq1_handler_count = 0;
+uint8_t mock_uart_tx_wire[4096];  // 「線上」已送出的 bytes
+uint32_t mock_uart_tx_wire_len = 0;
 
 // ==========================================
 // 2. STUB Functions (假函式實作)
@@ -55,9 +97,17 @@ bool mock_uart_fifo_enabled = false;
 // [DMA 相關]
 int dma_claim_unused_channel(bool required)
 {
+    if (mock_dma_claim_count >= mock_dma_claim_limit) return -1;
     return mock_dma_claim_count++;
 }
 
+void dma_channel_unclaim(int channel)
+{
+    mock_dma_unclaim_count++;
+}
+
+void dma_channel_abort(int channel) {}
+
 dma_channel_hw_t* dma_channel_hw_addr(int channel)
 {
     return &mock_dma_hw[channel];
@@ -75,18 +125,154 @@ void channel_config_set_write_increment(dma_channel_config* c, bool incr) {}
 void channel_config_set_dreq(dma_channel_config* c, int dreq) {}
 void channel_config_set_ring(dma_channel_config* c, bool write, int ring_size) {}
 
-void dma_channel_configure(int chan, dma_channel_config* c, void* write, const void* read,
-                           int count, bool trigger)
+void channel_config_set_chain_to(dma_channel_config* c, int chain_to) {}
+
+void dma_channel_configure(int chan, dma_channel_config* c, volatile void* write,
+                           const volatile void* read, uint32_t count, bool trigger)
+{
+    mock_dma_hw[chan].write_addr = (uintptr_t)write;
+    mock_dma_hw[chan].transfer_count = count;
+}
+
+void dma_channel_transfer_from_buffer_now(int chan, const volatile void* read, uint32_t count)
+{
+    mock_tx_src = (const uint8_t*)read;
+    mock_tx_count = count;
+    mock_tx_starts++;
+}
+
+void dma_channel_set_irq1_enabled(int chan, bool enabled) {}
+
+bool dma_channel_get_irq1_status(int chan)
+{
+    return (mock_dma_irq1_pending >> chan) & 1u;
+}
+
+void dma_channel_acknowledge_irq1(int chan)
+{
+    mock_dma_irq1_pending &= ~(1u << chan);
+}
+
+// [IRQ 相關]
+void irq_add_shared_handler(int num, irq_handler_t handler, int priority)
+{
+    mock_dma_irq1_handlers[mock_dma_irq1_handler_count++] = handler;
+}
+
+// 觸發 DMA_IRQ_1：依序呼叫所有 shared handler
+static void mock_fire_dma_irq1(void)
+{
+    for (int i = 0; i < mock_dma_irq1_handler_count; i++)
+    {
+        mock_dma_irq1_handlers[i]();
+    }
+}
+void irq_set_enabled(int num, bool enabled) {}
+
+// UART 錯誤中斷 handler (irq_set_exclusive_handler 註冊)
+irq_handler_t mock_uart_irq_handler = NULL;
+void irq_set_exclusive_handler(int num, irq_handler_t handler)
+{
+    mock_uart_irq_handler = handler;
+}
+
+irq_handler_t irq_get_exclusive_handler(int num)
+{
+    return mock_uart_irq_handler;
+}
+
+void irq_remove_handler(int num, irq_handler_t handler)
 {
-    // Mock: 這裡可以做參數檢查
+    if (handler == mock_uart_irq_handler)
+    {
+        mock_uart_irq_handler = NULL;
+        return;
+    }
+    for (int i = 0; i < mock_dma_irq1_handler_count; i++)
+    {
+        if (mock_dma_irq1_handlers[i] != handler) continue;
+        mock_dma_irq1_handlers[i] = mock_dma_irq1_handlers[--mock_dma_irq1_handler_count];
+        return;
+    }
 }
 
-void dma_channel_wait_for_finish_blocking(int chan) {}
+void hw_set_bits(volatile uint32_t* addr, uint32_t mask)
+{
+    *addr |= mask;
+}
+
+void hw_clear_bits(volatile uint32_t* addr, uint32_t mask)
+{
+    *addr &= ~mask;
+}
+
+uint32_t save_and_disable_interrupts(void)
+{
+    return 0;
+}
+void restore_interrupts(uint32_t status) {}
+
+// [Timer 相關] 只記錄週期與 callback，由測試手動觸發 tick
+int64_t mock_timer_delay_us = 0;
+bool mock_timer_active = false;
+uint32_t mock_now_us = 0;
+
+uint32_t time_us_32(void)
+{
+    return mock_now_us;
+}
+
+bool add_repeating_timer_us(int64_t delay_us, repeating_timer_callback_t callback, void* user_data,
+                            repeating_timer_t* out)
+{
+    out->callback = callback;
+    mock_timer_delay_us = delay_us;
+    mock_timer_active = true;
+    return true;
+}
+
+bool cancel_repeating_timer(repeating_timer_t* timer)
+{
+    mock_timer_active = false;
+    mock_uart_hw_regs.fr = 0;
+    return true;
+}
 
 // [UART 相關]
-void uart_init(uart_inst_t* uart, int baud) {}
+uart_inst_t* uart_get_instance(unsigned int num)
+{
+    return &mock_uart_insts[num];
+}
+
+uint32_t uart_init(uart_inst_t* uart, uint32_t baud)
+{
+    mock_uart_init_inst = uart;
+    mock_uart_init_baud = baud;
+    return baud;
+}
 void gpio_set_function(int gpio, int func) {}
-void uart_set_hw_flow(uart_inst_t* uart, bool cts, bool rts) {}
+void gpio_init(int gpio) {}
+void gpio_set_dir(int gpio, bool out) {}
+void gpio_put(int gpio, bool value)
+{
+    mock_rts_level = value;
+    mock_rts_toggles++;
+}
+uint32_t uart_set_baudrate(uart_inst_t* uart, uint32_t baud)
+{
+    mock_uart_init_baud = baud;
+    return baud;
+}
+void uart_set_irq_enables(uart_inst_t* uart, bool rx, bool tx)
+{
+    mock_uart_hw_regs.imsc = 0;  // 與 SDK 相同：整個 IMSC 被覆寫
+}
+
+void uart_set_hw_flow(uart_inst_t* uart, bool cts, bool rts)
+{
+    mock_hw_cts = cts;
+    mock_hw_rts = rts;
+}
 void uart_set_format(uart_inst_t* uart, int data, int stop, int parity) {}
 
 void uart_set_fifo_enabled(uart_inst_t* uart, bool enabled)
@@ -109,10 +295,60 @@ int uart_get_dreq(uart_inst_t* uart, bool is_tx)
 // 3. Source Inclusion (白箱測試)
 // ==========================================
 // 因為我們要測試內部 static 變數，所以直接 include .c 檔
-// 但為了消除 "Warning: cast to smaller integer type"，我們在 include 前定義 uintptr_t 補丁
-// 其實最好的解法是修改 src/hal/hal_uart_dma.c 使用 uintptr_t，但為了不改動 source，我們這裡忽略警告
 #include "../src/hal/hal_uart_dma.c"
 
+// 模擬 DMA 把目前這段傳輸送完並觸發 DMA_IRQ_1
+static void complete_tx_dma(void)
+{
+    memcpy(&mock_uart_tx_wire[mock_uart_tx_wire_len], mock_tx_src, mock_tx_count);
+    mock_uart_tx_wire_len += mock_tx_count;
+    mock_dma_irq1_pending |= 1u << dma_tx_chan;
+    mock_fire_dma_irq1();
+}
+
+// 模擬 UART → RX DMA 寫入 n bytes：寫入位址在 ring 內繞回，
+// 傳輸次數用完時 chain 到 control channel 重新裝填並觸發 DMA_IRQ_1
+// defer_irq = true 時只重新裝填、不執行 IRQ (模擬 IRQ 尚未被服務的窗口)
+static void dma_rx_produce(const uint8_t* data, uint32_t n, bool defer_irq)
+{
+    dma_channel_hw_t* hw = &mock_dma_hw[dma_rx_chan];
+    for (uint32_t i = 0; i < n; i++)
+    {
+        uint32_t off = (uint32_t)(hw->write_addr - (uintptr_t)rx_ring_buffer);
+        rx_ring_buffer[off] = data ? data[i] : (uint8_t)i;
+        hw->write_addr = (uintptr_t)rx_ring_buffer + ((off + 1) & (UART_DMA_BUFFER_SIZE - 1));
+
+        if (--hw->transfer_count == 0)
+        {
+            hw->al1_transfer_count_trig = rx_rearm_count;  // control channel 的單次寫入
+            hw->transfer_count = hw->al1_transfer_count_trig;
+            mock_dma_irq1_pending |= 1u << dma_rx_ctrl_chan;
+            if (!defer_irq) mock_fire_dma_irq1();
+        }
+    }
+}
+
+// 模擬 repeating timer 到期一次
+static void idle_tick(void)
+{
+    TEST_ASSERT_TRUE(mock_timer_active);
+    rx_idle_timer.callback(&rx_idle_timer);
+}
+
+// Idle Callback 紀錄
+static int idle_cb_calls = 0;
+static size_t idle_cb_len = 0;
+static uint8_t idle_cb_data[UART_DMA_BUFFER_SIZE];
+
+static void on_idle(const uart_dma_span_t spans[2], size_t len, void* user_ctx)
+{
+    idle_cb_calls++;
+    idle_cb_len = len;
+    memcpy(idle_cb_data, spans[0].data, spans[0].len);
+    memcpy(idle_cb_data + spans[0].len, spans[1].data, spans[1].len);
+    (*(int*)user_ctx)++;
+}
+
 // ==========================================
 // 4. Test Cases
 // ==========================================
@@ -120,32 +356,65 @@ int uart_get_dreq(uart_inst_t* uart, bool is_tx)
 void setUp(void)
 {
     mock_dma_claim_count = 0;
+    mock_dma_claim_limit = 12;
+    mock_dma_unclaim_count = 0;
     mock_uart_fifo_enabled = false;
-    rx_read_index = 0;
     memset(rx_ring_buffer, 0, UART_DMA_BUFFER_SIZE);
+    memset(mock_dma_hw, 0, sizeof(mock_dma_hw));
+    mock_tx_src = NULL;
+    mock_tx_count = 0;
+    mock_tx_starts = 0;
+    mock_dma_irq1_pending = 0;
+    mock_dma_irq1_handler_count = 0;
+    mock_timer_active = false;
+    rx_idle_cb = NULL;
+    rx_idle_timer_running = false;
+    idle_cb_calls = 0;
+    idle_cb_len = 0;
+    mock_uart_tx_wire_len = 0;
+    mock_rts_level = -1;
+    mock_rts_toggles = 0;
 }
 
-void tearDown(void) {}
+void tearDown(void)
+{
+    hal_uart_dma_deinit();
+}
 
 void test_init_should_configure_peripherals(void)
 {
-    bool result = hal_uart_dma_init();
+    bool result = hal_uart_dma_init(NULL);
     TEST_ASSERT_TRUE(result);
-    TEST_ASSERT_EQUAL_INT(2, mock_dma_claim_count);
+    TEST_ASSERT_EQUAL_INT(3, mock_dma_claim_count);  // TX + RX + RX control channel
     TEST_ASSERT_TRUE(mock_uart_fifo_enabled);
+    TEST_ASSERT_EQUAL_UINT32(UART_DMA_RX_REARM_BLOCK, mock_dma_hw[dma_rx_chan].transfer_count);
+}
+
+void test_init_should_use_config_port_and_baud(void)
+{
+    uart_config_t cfg = HAL_UART_CONFIG_DEFAULT;
+    cfg.port = 1;
+    cfg.baud = 921600;
+
+    TEST_ASSERT_TRUE(hal_uart_dma_init(&cfg));
+    TEST_ASSERT_EQUAL_PTR(&mock_uart_insts[1], mock_uart_init_inst);
+    TEST_ASSERT_EQUAL_UINT32(921600, mock_uart_init_baud);
+
+    // 未指定設定 = 舊的預設值 (uart0, 115200)
+    TEST_ASSERT_TRUE(hal_uart_dma_init(NULL));
+    TEST_ASSERT_EQUAL_PTR(&mock_uart_insts[0], mock_uart_init_inst);
+    TEST_ASSERT_EQUAL_UINT32(115200, mock_uart_init_baud);
+
+    cfg.port = HAL_UART_PORT_COUNT;
+    TEST_ASSERT_FALSE(hal_uart_dma_init(&cfg));
 }
 
 void test_read_logic(void)
 {
-    hal_uart_dma_init();
+    hal_uart_dma_init(NULL);
 
     // 模擬 DMA 寫入了 3 個 bytes
-    rx_ring_buffer[0] = 'H';
-    rx_ring_buffer[1] = 'i';
-    rx_ring_buffer[2] = '!';
-
-    // [修正 3] 使用 uintptr_t 避免 macOS 64-bit 指標警告
-    mock_dma_hw[dma_rx_chan].write_addr = (uintptr_t)rx_ring_buffer + 3;
+    dma_rx_produce((const uint8_t*)"Hi!", 3, false);
 
     uint8_t buf[10];
     size_t len = hal_uart_dma_read(buf, 10);
@@ -154,10 +423,547 @@ void test_read_logic(void)
     TEST_ASSERT_EQUAL_UINT8('H', buf[0]);
 }
 
+void test_read_wraps_around_ring_end(void)
+{
+    hal_uart_dma_init(NULL);
+
+    // 讀取指標在尾端前 2 bytes，DMA 已繞回寫到 index 3
+    uart_dma_span_t spans[2];
+    dma_rx_produce(NULL, UART_DMA_BUFFER_SIZE - 2, false);
+    hal_uart_dma_consume(hal_uart_dma_peek(spans));
+    dma_rx_produce((const uint8_t*)"ABCDE", 5, false);
+
+    uint8_t buf[10];
+    TEST_ASSERT_EQUAL_INT(5, hal_uart_dma_read(buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_MEMORY("ABCDE", buf, 5);
+    TEST_ASSERT_EQUAL_INT(0, hal_uart_dma_read(buf, sizeof(buf)));
+}
+
+void test_read_respects_max_len(void)
+{
+    hal_uart_dma_init(NULL);
+
+    uart_dma_span_t spans[2];
+    dma_rx_produce(NULL, UART_DMA_BUFFER_SIZE - 2, false);
+    hal_uart_dma_consume(hal_uart_dma_peek(spans));
+    dma_rx_produce((const uint8_t*)"ABCDE", 5, false);
+
+    uint8_t buf[3];
+    TEST_ASSERT_EQUAL_INT(3, hal_uart_dma_read(buf, 3));  // 跨越尾端的部分讀取
+    TEST_ASSERT_EQUAL_MEMORY("ABC", buf, 3);
+    TEST_ASSERT_EQUAL_INT(2, hal_uart_dma_read(buf, 3));
+    TEST_ASSERT_EQUAL_MEMORY("DE", buf, 2);
+}
+
+void test_peek_returns_spans_into_dma_ring(void)
+{
+    hal_uart_dma_init(NULL);
+    uart_dma_span_t spans[2];
+
+    // 沒有繞回：只有一段
+    dma_rx_produce((const uint8_t*)"PING", 4, false);
+    TEST_ASSERT_EQUAL_INT(4, hal_uart_dma_peek(spans));
+    TEST_ASSERT_EQUAL_PTR(rx_ring_buffer, spans[0].data);  // 零複製：直接指向 DMA buffer
+    TEST_ASSERT_EQUAL_INT(4, spans[0].len);
+    TEST_ASSERT_EQUAL_INT(0, spans[1].len);
+
+    // peek 不會移動讀取指標
+    TEST_ASSERT_EQUAL_INT(4, hal_uart_dma_peek(spans));
+
+    hal_uart_dma_consume(4);
+    TEST_ASSERT_EQUAL_INT(0, hal_uart_dma_peek(spans));
+
+    // 繞回：兩段
+    dma_rx_produce(NULL, UART_DMA_BUFFER_SIZE - 5, false);
+    hal_uart_dma_consume(hal_uart_dma_peek(spans));
+    dma_rx_produce(NULL, 3, false);
+    TEST_ASSERT_EQUAL_INT(3, hal_uart_dma_peek(spans));
+    TEST_ASSERT_EQUAL_PTR(&rx_ring_buffer[UART_DMA_BUFFER_SIZE - 1], spans[0].data);
+    TEST_ASSERT_EQUAL_INT(1, spans[0].len);
+    TEST_ASSERT_EQUAL_PTR(rx_ring_buffer, spans[1].data);
+    TEST_ASSERT_EQUAL_INT(2, spans[1].len);
+
+    hal_uart_dma_consume(3);
+    TEST_ASSERT_EQUAL_INT(0, hal_uart_dma_peek(spans));
+}
+
+void test_full_ring_is_not_an_overrun(void)
+{
+    hal_uart_dma_init(NULL);
+    uart_dma_span_t spans[2];
+
+    // 剛好落後一整圈：資料仍然完整
+    dma_rx_produce(NULL, UART_DMA_BUFFER_SIZE, false);
+    TEST_ASSERT_EQUAL_INT(UART_DMA_BUFFER_SIZE, hal_uart_dma_peek(spans));
+    TEST_ASSERT_EQUAL_UINT32(0, hal_uart_dma_rx_lost());
+}
+
+void test_overrun_is_detected_and_counted(void)
+{
+    hal_uart_dma_init(NULL);
+    uart_dma_span_t spans[2];
+
+    // 讀取端落後超過一圈：只丟棄被覆蓋的 10 bytes + margin，最新的一段仍然回傳
+    const uint32_t lost = 10 + UART_DMA_OVERRUN_MARGIN;
+    const uint32_t kept = UART_DMA_BUFFER_SIZE - UART_DMA_OVERRUN_MARGIN;
+    dma_rx_produce(NULL, UART_DMA_BUFFER_SIZE + 10, false);
+    TEST_ASSERT_EQUAL_INT(kept, hal_uart_dma_peek(spans));
+    TEST_ASSERT_EQUAL_UINT32(lost, hal_uart_dma_rx_lost());
+
+    uint8_t buf[UART_DMA_BUFFER_SIZE];
+    TEST_ASSERT_EQUAL_INT(kept, hal_uart_dma_read(buf, sizeof(buf)));
+    for (uint32_t i = 0; i < kept; i++)
+    {
+        TEST_ASSERT_EQUAL_UINT8((uint8_t)(lost + i), buf[i]);  // 依序的尾端資料
+    }
+
+    // 之後的新資料可以正常讀取
+    dma_rx_produce((const uint8_t*)"OK", 2, false);
+    TEST_ASSERT_EQUAL_INT(2, hal_uart_dma_read(buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_MEMORY("OK", buf, 2);
+    TEST_ASSERT_EQUAL_UINT32(lost, hal_uart_dma_rx_lost());
+}
+
+void test_rx_rearm_keeps_stream_gapless(void)
+{
+    hal_uart_dma_init(NULL);
+    uint8_t buf[UART_DMA_BUFFER_SIZE];
+
+    // 連續接收超過兩個 block：每個 block 結束時由 control channel 重新裝填
+    uint32_t total = 0;
+    uint32_t next = 0;
+    bool in_order = true;
+    while (total < 2 * UART_DMA_RX_REARM_BLOCK + 100)
+    {
+        uint8_t chunk[100];
+        for (int i = 0; i < 100; i++) chunk[i] = (uint8_t)(total + i);
+        dma_rx_produce(chunk, 100, false);
+        total += 100;
+
+        size_t n = hal_uart_dma_read(buf, sizeof(buf));
+        for (size_t i = 0; i < n; i++)
+        {
+            if (buf[i] != (uint8_t)next++) in_order = false;
+        }
+    }
+
+    TEST_ASSERT_TRUE(in_order);
+    TEST_ASSERT_EQUAL_UINT32(total, next);
+    TEST_ASSERT_EQUAL_UINT32(2, rx_rearm_epoch);
+    TEST_ASSERT_EQUAL_UINT32(0, hal_uart_dma_rx_lost());
+}
+
+void test_rx_rearm_before_irq_does_not_go_backwards(void)
+{
+    hal_uart_dma_init(NULL);
+    uart_dma_span_t spans[2];
+    uint8_t buf[UART_DMA_BUFFER_SIZE];
+
+    // 讀到 block 尾端前 4 bytes
+    uint32_t total = 0;
+    while (total < UART_DMA_RX_REARM_BLOCK - 4)
+    {
+        uint32_t n = UART_DMA_RX_REARM_BLOCK - 4 - total;
+        if (n > 128) n = 128;
+        dma_rx_produce(NULL, n, false);
+        total += (uint32_t)hal_uart_dma_read(buf, sizeof(buf));
+    }
+
+    // 跨越 block 邊界，但 control channel 的 IRQ 尚未被服務
+    dma_rx_produce((const uint8_t*)"ABCDEF", 6, true);
+    TEST_ASSERT_EQUAL_INT(6, hal_uart_dma_peek(spans));
+    TEST_ASSERT_EQUAL_UINT32(0, hal_uart_dma_rx_lost());
+
+    // IRQ 補上後計數保持一致
+    mock_fire_dma_irq1();
+    TEST_ASSERT_EQUAL_INT(6, hal_uart_dma_read(buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_MEMORY("ABCDEF", buf, 6);
+}
+
+void test_send_returns_immediately_and_starts_dma(void)
+{
+    hal_uart_dma_init(NULL);
+
+    uint8_t msg[] = "PONG\n";
+    TEST_ASSERT_EQUAL(HAL_UART_DMA_TX_QUEUED, hal_uart_dma_send(msg, 5));
+
+    // 呼叫端 buffer 可立即重用：資料已複製進佇列
+    memset(msg, 0, sizeof(msg));
+    TEST_ASSERT_EQUAL_INT(1, mock_tx_starts);
+    TEST_ASSERT_EQUAL_UINT32(5, mock_tx_count);
+    TEST_ASSERT_EQUAL_MEMORY("PONG\n", mock_tx_src, 5);
+    TEST_ASSERT_EQUAL_UINT32(5, hal_uart_dma_tx_pending());
+
+    complete_tx_dma();
+    TEST_ASSERT_EQUAL_UINT32(0, hal_uart_dma_tx_pending());
+    TEST_ASSERT_EQUAL_INT(1, mock_tx_starts);  // 佇列空了就不再啟動
+}
+
+void test_send_while_busy_is_chained_by_irq(void)
+{
+    hal_uart_dma_init(NULL);
+
+    hal_uart_dma_send((const uint8_t*)"AB", 2);
+    hal_uart_dma_send((const uint8_t*)"CDE", 3);  // DMA 忙碌中：只排隊，不重新啟動
+    TEST_ASSERT_EQUAL_INT(1, mock_tx_starts);
+
+    complete_tx_dma();  // 第一段完成 → 中斷自動接續第二段
+    TEST_ASSERT_EQUAL_INT(2, mock_tx_starts);
+    TEST_ASSERT_EQUAL_UINT32(3, mock_tx_count);
+
+    complete_tx_dma();
+    TEST_ASSERT_EQUAL_UINT32(5, mock_uart_tx_wire_len);
+    TEST_ASSERT_EQUAL_MEMORY("ABCDE", mock_uart_tx_wire, 5);
+}
+
+void test_send_wraps_queue_in_two_spans(void)
+{
+    hal_uart_dma_init(NULL);
+
+    uint8_t filler[UART_DMA_TX_QUEUE_SIZE - 8];
+    memset(filler, 'x', sizeof(filler));
+    hal_uart_dma_send(filler, sizeof(filler));
+    complete_tx_dma();
+
+    // 剩 8 bytes 到尾端，送 12 bytes 會被切成 8 + 4 兩段
+    hal_uart_dma_send((const uint8_t*)"0123456789ab", 12);
+    TEST_ASSERT_EQUAL_UINT32(8, mock_tx_count);
+    complete_tx_dma();
+    TEST_ASSERT_EQUAL_UINT32(4, mock_tx_count);
+    complete_tx_dma();
+
+    TEST_ASSERT_EQUAL_MEMORY("0123456789ab", &mock_uart_tx_wire[sizeof(filler)], 12);
+    TEST_ASSERT_EQUAL_UINT32(0, hal_uart_dma_tx_pending());
+}
+
+void test_send_full_queue_rejects_whole_message(void)
+{
+    hal_uart_dma_init(NULL);
+
+    uint8_t big[UART_DMA_TX_QUEUE_SIZE - 4];
+    memset(big, 'y', sizeof(big));
+    TEST_ASSERT_EQUAL(HAL_UART_DMA_TX_QUEUED, hal_uart_dma_send(big, sizeof(big)));
+
+    // 只剩 3 bytes (size - 1 - used)：4 bytes 的訊息整筆拒絕，不做部分寫入
+    TEST_ASSERT_EQUAL(HAL_UART_DMA_TX_FULL, hal_uart_dma_send((const uint8_t*)"ABCD", 4));
+    TEST_ASSERT_EQUAL_UINT32(sizeof(big), hal_uart_dma_tx_pending());
+    TEST_ASSERT_EQUAL(HAL_UART_DMA_TX_ERROR, hal_uart_dma_send(NULL, 4));
+}
+
+void test_idle_callback_fires_after_burst(void)
+{
+    hal_uart_dma_init(NULL);
+    int ctx_hits = 0;
+    hal_uart_dma_set_idle_callback(on_idle, &ctx_hits);
+    TEST_ASSERT_EQUAL_INT64(-UART_DMA_IDLE_TICK_US, mock_timer_delay_us);
+
+    // burst 進行中：每個 tick 都有新資料 → 不通知
+    dma_rx_produce((const uint8_t*)"PI", 2, false);
+    idle_tick();
+    dma_rx_produce((const uint8_t*)"NG", 2, false);
+    idle_tick();
+    TEST_ASSERT_EQUAL_INT(0, idle_cb_calls);
+
+    // 線路安靜一個 tick → 通知整段新資料，並自動 consume
+    idle_tick();
+    TEST_ASSERT_EQUAL_INT(1, idle_cb_calls);
+    TEST_ASSERT_EQUAL_INT(1, ctx_hits);
+    TEST_ASSERT_EQUAL_INT(4, idle_cb_len);
+    TEST_ASSERT_EQUAL_MEMORY("PING", idle_cb_data, 4);
+
+    uart_dma_span_t spans[2];
+    TEST_ASSERT_EQUAL_INT(0, hal_uart_dma_peek(spans));
+
+    // 持續閒置且沒有新資料 → 不重複通知
+    idle_tick();
+    TEST_ASSERT_EQUAL_INT(1, idle_cb_calls);
+}
+
+void test_idle_callback_flushes_long_burst_at_half_ring(void)
+{
+    hal_uart_dma_init(NULL);
+    int ctx_hits = 0;
+    hal_uart_dma_set_idle_callback(on_idle, &ctx_hits);
+
+    // 一直沒有 idle，但未讀資料已達 ring 一半 → 提前交出，避免 overrun
+    dma_rx_produce(NULL, UART_DMA_BUFFER_SIZE / 2, false);
+    idle_tick();
+    TEST_ASSERT_EQUAL_INT(1, idle_cb_calls);
+    TEST_ASSERT_EQUAL_INT(UART_DMA_BUFFER_SIZE / 2, idle_cb_len);
+
+    dma_rx_produce(NULL, UART_DMA_BUFFER_SIZE / 2, false);
+    idle_tick();
+    dma_rx_produce(NULL, UART_DMA_BUFFER_SIZE / 2, false);
+    idle_tick();
+    TEST_ASSERT_EQUAL_INT(3, idle_cb_calls);
+    TEST_ASSERT_EQUAL_UINT32(0, hal_uart_dma_rx_lost());
+}
+
+void test_idle_callback_unregister_stops_timer(void)
+{
+    hal_uart_dma_init(NULL);
+    int ctx_hits = 0;
+    hal_uart_dma_set_idle_callback(on_idle, &ctx_hits);
+    TEST_ASSERT_TRUE(mock_timer_active);
+
+    hal_uart_dma_set_idle_callback(NULL, NULL);
+    TEST_ASSERT_FALSE(mock_timer_active);
+
+    // 沒有 Callback 時 poll 不會動到讀取指標
+    dma_rx_produce((const uint8_t*)"X", 1, false);
+    hal_uart_dma_poll_idle();
+    hal_uart_dma_poll_idle();
+    uart_dma_span_t spans[2];
+    TEST_ASSERT_EQUAL_INT(1, hal_uart_dma_peek(spans));
+}
+
+// Span Callback：與 hal_uart 相同的 uart_rx_span_t，ring 繞回時分兩段交出
+static uint8_t span_cb_data[UART_DMA_BUFFER_SIZE];
+static size_t span_cb_total = 0;
+static int span_cb_calls = 0;
+static uart_rx_span_t span_cb_last;
+
+static void on_span(void* ctx, const uart_rx_span_t* span)
+{
+    (void)ctx;
+    memcpy(span_cb_data + span_cb_total, span->data, span->len);
+    span_cb_total += span->len;
+    span_cb_calls++;
+    span_cb_last = *span;
+}
+
+void test_span_callback_delivers_typed_spans(void)
+{
+    uart_config_t cfg = HAL_UART_CONFIG_DEFAULT;
+    cfg.port = 1;
+    hal_uart_dma_init(&cfg);
+    span_cb_total = 0;
+    span_cb_calls = 0;
+    mock_now_us = 777;
+
+    // 先讓讀取指標停在 ring 尾端附近，下一批資料會繞回
+    uint8_t sink[UART_DMA_BUFFER_SIZE];
+    dma_rx_produce(NULL, UART_DMA_BUFFER_SIZE - 4, false);
+    hal_uart_dma_read(sink, sizeof(sink));
+
+    hal_uart_dma_set_span_callback(on_span, NULL);
+    TEST_ASSERT_TRUE(mock_timer_active);
+    uint8_t msg[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    dma_rx_produce(msg, sizeof(msg), false);
+    idle_tick();  // 還在收
+    idle_tick();  // 閒置 → 交出
+
+    TEST_ASSERT_EQUAL_INT(2, span_cb_calls);
+    TEST_ASSERT_EQUAL_size_t(sizeof(msg), span_cb_total);
+    TEST_ASSERT_EQUAL_MEMORY(msg, span_cb_data, sizeof(msg));
+    TEST_ASSERT_EQUAL_UINT16(6, span_cb_last.len);
+    TEST_ASSERT_EQUAL_UINT8(1, span_cb_last.port);
+    TEST_ASSERT_EQUAL_UINT32(777, span_cb_last.timestamp_us);
+
+    uart_dma_span_t spans[2];
+    TEST_ASSERT_EQUAL_size_t(0, hal_uart_dma_peek(spans));  // 已自動 consume
+
+    hal_uart_dma_set_span_callback(NULL, NULL);
+    TEST_ASSERT_FALSE(mock_timer_active);
+}
+
+// UART 硬體錯誤與 ring overrun 分開計數：前者是 DMA 來不及搬 FIFO，後者是讀取端太慢
+void test_uart_errors_are_counted_separately_from_ring_overrun(void)
+{
+    hal_uart_dma_init(NULL);
+    TEST_ASSERT_NOT_NULL(mock_uart_irq_handler);
+    TEST_ASSERT_EQUAL_HEX32(UART_DMA_ERROR_IRQ_BITS, mock_uart_hw_regs.imsc);  // 沒有 RX / RT
+
+    mock_uart_hw_regs.mis = UART_UARTIMSC_OEIM_BITS | UART_UARTIMSC_FEIM_BITS;
+    mock_uart_irq_handler();
+    TEST_ASSERT_EQUAL_HEX32(mock_uart_hw_regs.mis, mock_uart_hw_regs.icr);
+    mock_uart_hw_regs.mis = UART_UARTIMSC_OEIM_BITS;
+    mock_uart_irq_handler();
+
+    dma_rx_produce(NULL, UART_DMA_BUFFER_SIZE + 1, false);
+    uart_dma_span_t spans[2];
+    hal_uart_dma_peek(spans);
+
+    uart_error_stats_t stats;
+    hal_uart_dma_get_error_stats(&stats, true);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.overrun);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.framing);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.parity + stats.breaks);
+    TEST_ASSERT_EQUAL_UINT32(1 + UART_DMA_OVERRUN_MARGIN, hal_uart_dma_rx_lost());
+
+    hal_uart_dma_get_error_stats(&stats, false);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.overrun);
+    mock_uart_hw_regs.mis = 0;
+}
+
+void test_idle_tick_scales_with_baud(void)
+{
+    hal_uart_dma_init(NULL);  // 115200：一個 tick 不到 UART_DMA_TICK_BYTES，維持上限
+    TEST_ASSERT_EQUAL_UINT32(UART_DMA_IDLE_TICK_US, hal_uart_dma_idle_tick_us());
+    hal_uart_dma_set_span_callback(on_span, NULL);
+    TEST_ASSERT_EQUAL_INT64(-UART_DMA_IDLE_TICK_US, mock_timer_delay_us);
+
+    // 3 Mbaud：64 bytes * 10 bits / 3 Mbaud = 213 µs，執行中的 timer 以新週期重新啟動
+    TEST_ASSERT_EQUAL_UINT32(3000000, hal_uart_dma_set_baud(3000000));
+    TEST_ASSERT_EQUAL_UINT32(UART_DMA_TICK_BYTES * 10u * 1000000u / 3000000u,
+                             hal_uart_dma_idle_tick_us());
+    TEST_ASSERT_EQUAL_INT64(-(int64_t)hal_uart_dma_idle_tick_us(), mock_timer_delay_us);
+    TEST_ASSERT_TRUE(mock_timer_active);
+
+    // 最高可接受的 baud：週期不低於下限；更高的 baud 拒絕且不變更
+    TEST_ASSERT_EQUAL_UINT32(UART_DMA_BAUD_MAX, hal_uart_dma_set_baud(UART_DMA_BAUD_MAX));
+    TEST_ASSERT_TRUE(hal_uart_dma_idle_tick_us() >= UART_DMA_IDLE_TICK_MIN_US);
+    uint32_t top_tick = hal_uart_dma_idle_tick_us();
+    TEST_ASSERT_EQUAL_UINT32(0, hal_uart_dma_set_baud(UART_DMA_BAUD_MAX + 1));
+    TEST_ASSERT_EQUAL_UINT32(top_tick, hal_uart_dma_idle_tick_us());
+
+    uart_config_t cfg = HAL_UART_CONFIG_DEFAULT;
+    cfg.baud = UART_DMA_BAUD_MAX + 1;
+    TEST_ASSERT_FALSE(hal_uart_dma_init(&cfg));
+}
+
+void test_set_baud_and_tx_idle(void)
+{
+    hal_uart_dma_init(NULL);
+
+    TEST_ASSERT_EQUAL_UINT32(3000000, hal_uart_dma_set_baud(3000000));
+    TEST_ASSERT_EQUAL_UINT32(3000000, mock_uart_init_baud);
+    TEST_ASSERT_EQUAL_UINT32(0, hal_uart_dma_set_baud(HAL_UART_BAUD_MAX + 1));
+    TEST_ASSERT_EQUAL_UINT32(3000000, mock_uart_init_baud);  // 超出範圍不變更
+
+    // 佇列有資料 → 不是 idle；DMA 搬完但 UART 仍在送 (BUSY) → 也不是 idle
+    TEST_ASSERT_TRUE(hal_uart_dma_tx_idle());
+    hal_uart_dma_send((const uint8_t*)"ACK\n", 4);
+    TEST_ASSERT_FALSE(hal_uart_dma_tx_idle());
+    mock_uart_hw_regs.fr = UART_UARTFR_BUSY_BITS;
+    complete_tx_dma();
+    TEST_ASSERT_FALSE(hal_uart_dma_tx_idle());
+    mock_uart_hw_regs.fr = 0;
+    TEST_ASSERT_TRUE(hal_uart_dma_tx_idle());
+}
+
+// 軟體 RTS：主程式讀太慢時，ring 未讀量到 3/4 就暫停對端，讀到 1/4 以下才恢復
+void test_sw_rts_follows_rx_ring_fill(void)
+{
+    uart_config_t cfg = HAL_UART_CONFIG_DEFAULT;
+    cfg.flow = UART_FLOW_SW_RTS;
+    cfg.cts_pin = 2;
+    cfg.rts_pin = 3;
+    TEST_ASSERT_TRUE(hal_uart_dma_init(&cfg));
+    TEST_ASSERT_TRUE(mock_hw_cts);
+    TEST_ASSERT_FALSE(mock_hw_rts);
+    TEST_ASSERT_EQUAL_INT(0, mock_rts_level);
+    TEST_ASSERT_TRUE(mock_timer_active);  // 沒有 idle Callback 也要定期檢查水位
+
+    dma_rx_produce(NULL, UART_DMA_RTS_HIGH - 1, false);
+    idle_tick();
+    TEST_ASSERT_FALSE(hal_uart_dma_rx_paused());
+
+    dma_rx_produce(NULL, 1, false);
+    idle_tick();
+    TEST_ASSERT_TRUE(hal_uart_dma_rx_paused());
+    TEST_ASSERT_EQUAL_INT(1, mock_rts_level);
+
+    // 停在 LOW 之上仍維持暫停 (hysteresis)，不會每讀一點就來回切換
+    uint8_t sink[UART_DMA_BUFFER_SIZE];
+    hal_uart_dma_read(sink, UART_DMA_RTS_HIGH - UART_DMA_RTS_LOW - 1);
+    TEST_ASSERT_TRUE(hal_uart_dma_rx_paused());
+    hal_uart_dma_read(sink, 1);
+    TEST_ASSERT_FALSE(hal_uart_dma_rx_paused());
+    TEST_ASSERT_EQUAL_INT(0, mock_rts_level);
+
+    // 暫停期間沒有任何資料被覆蓋
+    TEST_ASSERT_EQUAL_UINT32(0, hal_uart_dma_rx_lost());
+    TEST_ASSERT_EQUAL_INT(3, mock_rts_toggles);  // 初始化 + 暫停 + 恢復
+
+    // 取消 idle Callback 不能停掉 RTS 用的 timer
+    hal_uart_dma_set_idle_callback(NULL, NULL);
+    TEST_ASSERT_TRUE(mock_timer_active);
+}
+
+void test_hw_flow_config_is_passed_to_uart(void)
+{
+    uart_config_t cfg = HAL_UART_CONFIG_DEFAULT;
+    cfg.flow = UART_FLOW_RTS_CTS;
+    TEST_ASSERT_TRUE(hal_uart_dma_init(&cfg));
+    TEST_ASSERT_TRUE(mock_hw_cts);
+    TEST_ASSERT_TRUE(mock_hw_rts);
+    TEST_ASSERT_EQUAL_INT(0, mock_rts_toggles);  // RTS 交給硬體，不走 GPIO
+    TEST_ASSERT_FALSE(mock_timer_active);
+
+    TEST_ASSERT_TRUE(hal_uart_dma_init(NULL));
+    TEST_ASSERT_FALSE(mock_hw_cts);
+    TEST_ASSERT_FALSE(mock_hw_rts);
+}
+
+void test_reinit_releases_previous_channels_and_handlers(void)
+{
+    TEST_ASSERT_TRUE(hal_uart_dma_init(NULL));
+    TEST_ASSERT_EQUAL_INT(2, mock_dma_irq1_handler_count);  // TX 完成 + RX 重新裝填
+
+    // 第二次 init 先歸還上一次的 3 個 channel，DMA_IRQ_1 的 handler 不會重複註冊
+    TEST_ASSERT_TRUE(hal_uart_dma_init(NULL));
+    TEST_ASSERT_EQUAL_INT(3, mock_dma_unclaim_count);
+    TEST_ASSERT_EQUAL_INT(2, mock_dma_irq1_handler_count);
+    TEST_ASSERT_NOT_NULL(mock_uart_irq_handler);
+
+    hal_uart_dma_deinit();
+    TEST_ASSERT_EQUAL_INT(6, mock_dma_unclaim_count);
+    TEST_ASSERT_EQUAL_INT(0, mock_dma_irq1_handler_count);
+    TEST_ASSERT_NULL(mock_uart_irq_handler);
+    TEST_ASSERT_EQUAL_INT(-1, dma_rx_chan);
+}
+
+void test_init_returns_claimed_channels_when_dma_runs_out(void)
+{
+    mock_dma_claim_limit = 2;  // 只剩兩個 channel
+    TEST_ASSERT_FALSE(hal_uart_dma_init(NULL));
+    TEST_ASSERT_EQUAL_INT(2, mock_dma_unclaim_count);
+    TEST_ASSERT_NULL(mock_uart_irq_handler);  // 還沒動到 UART IRQ
+    TEST_ASSERT_EQUAL_INT(0, mock_dma_irq1_handler_count);
+    TEST_ASSERT_EQUAL_INT(-1, dma_tx_chan);
+}
+
+static void foreign_uart_isr(void) {}
+
+void test_init_rejects_port_owned_by_hal_uart(void)
+{
+    // HAL_UART_Init 已在這個 port 註冊 exclusive handler
+    mock_uart_irq_handler = foreign_uart_isr;
+    TEST_ASSERT_FALSE(hal_uart_dma_init(NULL));
+    TEST_ASSERT_EQUAL_INT(0, mock_dma_claim_count);
+    TEST_ASSERT_EQUAL_PTR(foreign_uart_isr, mock_uart_irq_handler);
+    mock_uart_irq_handler = NULL;
+}
+
 int main(void)
 {
     UNITY_BEGIN();
     RUN_TEST(test_init_should_configure_peripherals);
+    RUN_TEST(test_init_should_use_config_port_and_baud);
     RUN_TEST(test_read_logic);
+    RUN_TEST(test_read_wraps_around_ring_end);
+    RUN_TEST(test_read_respects_max_len);
+    RUN_TEST(test_peek_returns_spans_into_dma_ring);
+    RUN_TEST(test_full_ring_is_not_an_overrun);
+    RUN_TEST(test_overrun_is_detected_and_counted);
+    RUN_TEST(test_rx_rearm_keeps_stream_gapless);
+    RUN_TEST(test_rx_rearm_before_irq_does_not_go_backwards);
+    RUN_TEST(test_idle_callback_fires_after_burst);
+    RUN_TEST(test_idle_callback_flushes_long_burst_at_half_ring);
+    RUN_TEST(test_idle_callback_unregister_stops_timer);
+    RUN_TEST(test_span_callback_delivers_typed_spans);
+    RUN_TEST(test_send_returns_immediately_and_starts_dma);
+    RUN_TEST(test_send_while_busy_is_chained_by_irq);
+    RUN_TEST(test_send_wraps_queue_in_two_spans);
+    RUN_TEST(test_send_full_queue_rejects_whole_message);
+    RUN_TEST(test_idle_tick_scales_with_baud);
+    RUN_TEST(test_set_baud_and_tx_idle);
+    RUN_TEST(test_uart_errors_are_counted_separately_from_ring_overrun);
+    RUN_TEST(test_sw_rts_follows_rx_ring_fill);
+    RUN_TEST(test_hw_flow_config_is_passed_to_uart);
+    RUN_TEST(test_reinit_releases_previous_channels_and_handlers);
+    RUN_TEST(test_init_returns_claimed_channels_when_dma_runs_out);
+    RUN_TEST(test_init_rejects_port_owned_by_hal_uart);
     return UNITY_END();
 }
\ No newline at end of file
@@ -97,6 +97,233 @@ void test_RingBuffer_WrapAround_Should_Work(void)
     TEST_ASSERT_EQUAL_HEX8(0x99, data);
 }
 
+// --- 測試案例 5: 批次寫入/讀取跨越回繞點 ---
+void test_RingBuffer_BulkWriteRead_Should_WrapAround(void)
+{
+    // 先把 head/tail 推到 5，讓接下來的 5 bytes 必須分兩段搬運
+    uint8_t scratch[5];
+    TEST_ASSERT_EQUAL_UINT32(5, rb_write(&rb, (const uint8_t*)"01234", 5));
+    TEST_ASSERT_EQUAL_UINT32(5, rb_read(&rb, scratch, 5));
+
+    const uint8_t src[5] = {0x10, 0x11, 0x12, 0x13, 0x14};
+    TEST_ASSERT_EQUAL_UINT32(5, rb_write(&rb, src, 5));
+    TEST_ASSERT_EQUAL_UINT32(2, rb.head);  // (5 + 5) & 7
+    TEST_ASSERT_EQUAL_UINT32(5, rb_count(&rb));
+
+    uint8_t dst[5];
+    TEST_ASSERT_EQUAL_UINT32(5, rb_read(&rb, dst, sizeof(dst)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(src, dst, 5);
+    TEST_ASSERT_TRUE(rb_is_empty(&rb));
+}
+
+// --- 測試案例 6: 批次寫入在空間不足時只寫入可用部分 ---
+void test_RingBuffer_BulkWrite_Should_ClampToFreeSpace(void)
+{
+    uint8_t src[TEST_BUF_SIZE + 4];
+    for (uint32_t i = 0; i < sizeof(src); i++)
+    {
+        src[i] = (uint8_t)i;
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(TEST_BUF_SIZE - 1, rb_write(&rb, src, sizeof(src)));
+    TEST_ASSERT_TRUE(rb_is_full(&rb));
+    TEST_ASSERT_EQUAL_UINT32(0, rb_free(&rb));
+    TEST_ASSERT_EQUAL_UINT32(0, rb_write(&rb, src, 1));
+
+    uint8_t dst[TEST_BUF_SIZE];
+    TEST_ASSERT_EQUAL_UINT32(TEST_BUF_SIZE - 1, rb_read(&rb, dst, sizeof(dst)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(src, dst, TEST_BUF_SIZE - 1);
+    TEST_ASSERT_EQUAL_UINT32(0, rb_read(&rb, dst, sizeof(dst)));
+}
+
+// --- 測試案例 7: Zero-copy peek/consume 需分兩段取得回繞的資料 ---
+void test_RingBuffer_PeekContiguous_Should_ReturnTwoSpans(void)
+{
+    for (int i = 0; i < 6; i++)
+    {
+        rb_push(&rb, 0);
+    }
+    rb_consume(&rb, 6);  // tail = 6
+
+    const uint8_t src[4] = {'A', 'B', 'C', 'D'};
+    rb_write(&rb, src, 4);  // 佔用 index 6,7,0,1
+
+    const uint8_t* span;
+    TEST_ASSERT_EQUAL_UINT32(2, rb_peek_contiguous(&rb, &span));
+    TEST_ASSERT_EQUAL_MEMORY("AB", span, 2);
+    rb_consume(&rb, 2);
+
+    TEST_ASSERT_EQUAL_UINT32(2, rb_peek_contiguous(&rb, &span));
+    TEST_ASSERT_EQUAL_MEMORY("CD", span, 2);
+    rb_consume(&rb, 2);
+
+    TEST_ASSERT_EQUAL_UINT32(0, rb_peek_contiguous(&rb, &span));
+}
+
+// --- 測試案例 8: Zero-copy reserve/commit 需保留一格區分 Full ---
+void test_RingBuffer_ReserveCommit_Should_KeepOneSlotFree(void)
+{
+    uint8_t* span;
+
+    // tail = 0 時，最多只能寫到 index 6 (保留最後一格)
+    TEST_ASSERT_EQUAL_UINT32(TEST_BUF_SIZE - 1, rb_reserve_contiguous(&rb, &span));
+    memcpy(span, "hello", 5);
+    rb_commit(&rb, 5);
+    TEST_ASSERT_EQUAL_UINT32(5, rb_count(&rb));
+
+    uint8_t dst[5];
+    rb_read(&rb, dst, 5);
+    TEST_ASSERT_EQUAL_MEMORY("hello", dst, 5);
+
+    // head = tail = 5：第一段到尾端 3 格，commit 後回繞再取得 4 格
+    TEST_ASSERT_EQUAL_UINT32(3, rb_reserve_contiguous(&rb, &span));
+    rb_commit(&rb, 3);
+    TEST_ASSERT_EQUAL_UINT32(0, rb.head);
+    TEST_ASSERT_EQUAL_UINT32(4, rb_reserve_contiguous(&rb, &span));
+    rb_commit(&rb, 4);
+    TEST_ASSERT_TRUE(rb_is_full(&rb));
+    TEST_ASSERT_EQUAL_UINT32(0, rb_reserve_contiguous(&rb, &span));
+}
+
+// --- 測試案例 9: 統計計數器 (pushed/popped/dropped/high watermark) ---
+void test_RingBuffer_Stats_Should_TrackDropsAndWatermark(void)
+{
+    for (int i = 0; i < TEST_BUF_SIZE + 2; i++)
+    {
+        rb_push(&rb, (uint8_t)i);  // 最後 3 筆會因滿載被拒收
+    }
+    uint8_t data;
+    rb_pop(&rb, &data);
+
+    rb_stats_t st;
+    rb_get_stats(&rb, &st);
+    TEST_ASSERT_EQUAL_UINT32(TEST_BUF_SIZE - 1, st.pushed);
+    TEST_ASSERT_EQUAL_UINT32(3, st.dropped);
+    TEST_ASSERT_EQUAL_UINT32(1, st.popped);
+    TEST_ASSERT_EQUAL_UINT32(TEST_BUF_SIZE - 1, st.high_watermark);
+
+    // Size 8 / 8 bins → 每個佔用量一格；寫入後佔用量依序為 1..7
+    TEST_ASSERT_EQUAL_UINT32(0, st.histogram[0]);
+    for (int bin = 1; bin < TEST_BUF_SIZE; bin++)
+    {
+        TEST_ASSERT_EQUAL_UINT32(1, st.histogram[bin]);
+    }
+
+    rb_reset_stats(&rb);
+    rb_get_stats(&rb, &st);
+    TEST_ASSERT_EQUAL_UINT32(0, st.pushed);
+    TEST_ASSERT_EQUAL_UINT32(0, st.high_watermark);
+}
+
+// --- 測試案例 10: 大 buffer 的直方圖以位移分組 ---
+void test_RingBuffer_Histogram_Should_ScaleWithShift(void)
+{
+    uint8_t big_storage[64];
+    ring_buffer_t big;
+    rb_init(&big, big_storage, sizeof(big_storage));
+    TEST_ASSERT_EQUAL_UINT8(3, big.stats.hist_shift);  // 64 / 8 bins = 8 per bin
+
+    uint8_t src[63] = {0};
+    rb_write(&big, src, 20);  // 佔用量 20 → bin 2
+    rb_write(&big, src, 43);  // 佔用量 63 → bin 7
+
+    rb_stats_t st;
+    rb_get_stats(&big, &st);
+    TEST_ASSERT_EQUAL_UINT32(1, st.histogram[2]);
+    TEST_ASSERT_EQUAL_UINT32(1, st.histogram[RB_HIST_BINS - 1]);
+    TEST_ASSERT_EQUAL_UINT32(63, st.high_watermark);
+}
+
+// --- 測試案例 11: 覆蓋模式保留最新資料 ---
+void test_RingBuffer_OverwriteOldest_Should_KeepNewestBytes(void)
+{
+    rb_set_policy(&rb, RB_POLICY_OVERWRITE_OLDEST);
+
+    for (int i = 0; i < TEST_BUF_SIZE + 2; i++)
+    {
+        TEST_ASSERT_TRUE(rb_push(&rb, (uint8_t)i));  // 覆蓋模式永遠成功
+    }
+    TEST_ASSERT_TRUE(rb_is_full(&rb));
+
+    uint8_t data;
+    rb_pop(&rb, &data);
+    TEST_ASSERT_EQUAL_HEX8(3, data);  // 0,1,2 被覆蓋
+
+    rb_stats_t st;
+    rb_get_stats(&rb, &st);
+    TEST_ASSERT_EQUAL_UINT32(3, st.overwritten);
+    TEST_ASSERT_EQUAL_UINT32(0, st.dropped);
+}
+
+// --- 測試案例 12: 覆蓋模式的批次寫入 (含超過容量的 span) ---
+void test_RingBuffer_OverwriteBulk_Should_KeepLastCapacityBytes(void)
+{
+    rb_set_policy(&rb, RB_POLICY_OVERWRITE_OLDEST);
+
+    rb_write(&rb, (const uint8_t*)"abcde", 5);
+    TEST_ASSERT_EQUAL_UINT32(4, rb_write(&rb, (const uint8_t*)"fghi", 4));
+
+    uint8_t dst[TEST_BUF_SIZE];
+    TEST_ASSERT_EQUAL_UINT32(TEST_BUF_SIZE - 1, rb_read(&rb, dst, sizeof(dst)));
+    TEST_ASSERT_EQUAL_MEMORY("cdefghi", dst, TEST_BUF_SIZE - 1);
+
+    TEST_ASSERT_EQUAL_UINT32(10, rb_write(&rb, (const uint8_t*)"0123456789", 10));
+    TEST_ASSERT_EQUAL_UINT32(TEST_BUF_SIZE - 1, rb_read(&rb, dst, sizeof(dst)));
+    TEST_ASSERT_EQUAL_MEMORY("3456789", dst, TEST_BUF_SIZE - 1);
+
+    // pushed - popped - overwritten 必須等於目前佔用量 (0)
+    rb_stats_t st;
+    rb_get_stats(&rb, &st);
+    TEST_ASSERT_EQUAL_UINT32(0, st.pushed - st.popped - st.overwritten);
+}
+
+// --- 測試案例 13: High/Low Watermark (hysteresis) ---
+static int wm_high_calls;
+static int wm_low_calls;
+
+static void on_watermark(void* ctx, bool above_high)
+{
+    (void)ctx;
+    if (above_high)
+        wm_high_calls++;
+    else
+        wm_low_calls++;
+}
+
+void test_RingBuffer_Watermarks_Should_NotifyWithHysteresis(void)
+{
+    wm_high_calls = 0;
+    wm_low_calls = 0;
+    TEST_ASSERT_FALSE(rb_set_watermarks(&rb, 2, 2, on_watermark, NULL));  // low 必須 < high
+    TEST_ASSERT_FALSE(rb_set_watermarks(&rb, TEST_BUF_SIZE, 1, on_watermark, NULL));
+    TEST_ASSERT_TRUE(rb_set_watermarks(&rb, 5, 2, on_watermark, NULL));
+
+    // 推到 5 → 通知一次；在 high 之上繼續推不重複通知
+    rb_write(&rb, (const uint8_t*)"abcd", 4);
+    TEST_ASSERT_EQUAL_INT(0, wm_high_calls);
+    rb_push(&rb, 'e');
+    rb_push(&rb, 'f');
+    TEST_ASSERT_EQUAL_INT(1, wm_high_calls);
+
+    // 降到 3 (介於 low 與 high 之間) → 不通知；降到 2 → 通知解除
+    uint8_t dst[4];
+    rb_read(&rb, dst, 3);
+    TEST_ASSERT_EQUAL_INT(0, wm_low_calls);
+    rb_pop(&rb, dst);
+    TEST_ASSERT_EQUAL_INT(1, wm_low_calls);
+
+    // 再次升到 high：reserve/commit 路徑也會檢查
+    uint8_t* span;
+    rb_reserve_contiguous(&rb, &span);
+    rb_commit(&rb, 3);
+    TEST_ASSERT_EQUAL_INT(2, wm_high_calls);
+
+    const uint8_t* rspan;
+    uint32_t n = rb_peek_contiguous(&rb, &rspan);
+    rb_consume(&rb, n);
+    TEST_ASSERT_EQUAL_INT(2, wm_low_calls);
+}
+
 int main(void)
 {
     UNITY_BEGIN();
@@ -104,5 +331,14 @@ int main(void)
     RUN_TEST(test_RingBuffer_PushPop_Should_WorkNormally);
     RUN_TEST(test_RingBuffer_Full_Should_RejectNewData);
     RUN_TEST(test_RingBuffer_WrapAround_Should_Work);
+    RUN_TEST(test_RingBuffer_BulkWriteRead_Should_WrapAround);
+    RUN_TEST(test_RingBuffer_BulkWrite_Should_ClampToFreeSpace);
+    RUN_TEST(test_RingBuffer_PeekContiguous_Should_ReturnTwoSpans);
+    RUN_TEST(test_RingBuffer_ReserveCommit_Should_KeepOneSlotFree);
+    RUN_TEST(test_RingBuffer_Stats_Should_TrackDropsAndWatermark);
+    RUN_TEST(test_RingBuffer_Histogram_Should_ScaleWithShift);
+    RUN_TEST(test_RingBuffer_OverwriteOldest_Should_KeepNewestBytes);
+    RUN_TEST(test_RingBuffer_OverwriteBulk_Should_KeepLastCapacityBytes);
+    RUN_TEST(test_RingBuffer_Watermarks_Should_NotifyWithHysteresis);
     return UNITY_END();
 }
\ No newline at end of file
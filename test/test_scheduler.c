@@ -0,0 +1,264 @@
+// 檔案位置: test/test_scheduler.c
+// Cooperative scheduler：timer wheel 的 deadline、週期 / one-shot、event task 與 budget
+// 時間全部由虛擬時鐘提供 (ms 傳給 sched_run，us 給 budget 量測)
+
+#include <string.h>
+
+#include "scheduler.h"
+#include "unity.h"
+
+// ==========================================
+// 1. 虛擬時鐘與紀錄
+// ==========================================
+static sched_t sched;
+static uint32_t now_ms;
+static uint32_t clock_us;  // task 以 work_us 模擬自己花掉的時間
+
+static uint32_t virtual_clock_us(void* ctx)
+{
+    (void)ctx;
+    return clock_us;
+}
+
+typedef struct
+{
+    uint32_t at[64];  // 每次執行時的 now
+    int count;
+    uint32_t work_us;
+    sched_task_t* stop_other;  // 執行時停掉另一個 task
+} probe_t;
+
+static void probe_fn(void* ctx, uint32_t now)
+{
+    probe_t* p = (probe_t*)ctx;
+    if (p->count < 64) p->at[p->count] = now;
+    p->count++;
+    clock_us += p->work_us;
+    if (p->stop_other) sched_stop(&sched, p->stop_other);
+}
+
+// 以 1 ms 為步進推進虛擬時鐘
+static void advance_to(uint32_t target_ms)
+{
+    while (now_ms != target_ms)
+    {
+        now_ms++;
+        sched_run(&sched, now_ms);
+    }
+}
+
+void setUp(void)
+{
+    now_ms = 1000;
+    clock_us = 0;
+    sched_init(&sched, now_ms, virtual_clock_us, NULL);
+}
+
+void tearDown(void) {}
+
+// ==========================================
+// 2. Timer
+// ==========================================
+void test_Periodic_Task_Should_Fire_On_Exact_Deadlines(void)
+{
+    sched_task_t t;
+    probe_t p = {0};
+    sched_task_init(&t, "p20", probe_fn, &p, 0);
+    sched_start(&sched, &t, 20, 20);
+
+    advance_to(1200);
+    TEST_ASSERT_EQUAL_INT(10, p.count);
+    for (int i = 0; i < 10; i++)
+    {
+        TEST_ASSERT_EQUAL_UINT32(1020 + 20 * (uint32_t)i, p.at[i]);  // 不累積漂移
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, t.max_late_ms);
+}
+
+void test_One_Shot_Should_Fire_Once_Even_Beyond_One_Wheel_Turn(void)
+{
+    sched_task_t a, b;
+    probe_t pa = {0}, pb = {0};
+    sched_task_init(&a, "short", probe_fn, &pa, 0);
+    sched_task_init(&b, "long", probe_fn, &pb, 0);
+    sched_start(&sched, &a, 5, 0);
+    sched_start(&sched, &b, 5 + 3 * SCHED_WHEEL_SLOTS, 0);  // 同一個 slot，晚三圈
+
+    advance_to(1500);
+    TEST_ASSERT_EQUAL_INT(1, pa.count);
+    TEST_ASSERT_EQUAL_UINT32(1005, pa.at[0]);
+    TEST_ASSERT_EQUAL_INT(1, pb.count);
+    TEST_ASSERT_EQUAL_UINT32(1005 + 3 * SCHED_WHEEL_SLOTS, pb.at[0]);
+    TEST_ASSERT_FALSE(a.armed);
+    TEST_ASSERT_FALSE(b.armed);
+}
+
+void test_Period_Equal_To_Wheel_Size_Should_Not_Rerun_In_Same_Pass(void)
+{
+    sched_task_t t;
+    probe_t p = {0};
+    sched_task_init(&t, "wheel", probe_fn, &p, 0);
+    sched_start(&sched, &t, SCHED_WHEEL_SLOTS, SCHED_WHEEL_SLOTS);  // 重排回同一個 slot
+
+    advance_to(1000 + 4 * SCHED_WHEEL_SLOTS);
+    TEST_ASSERT_EQUAL_INT(4, p.count);
+}
+
+void test_Stop_Should_Work_Before_Expiry_And_From_Another_Task(void)
+{
+    sched_task_t a, b, c;
+    probe_t pa = {0}, pb = {0}, pc = {0};
+    sched_task_init(&a, "a", probe_fn, &pa, 0);
+    sched_task_init(&b, "b", probe_fn, &pb, 0);
+    sched_task_init(&c, "c", probe_fn, &pc, 0);
+
+    // a 與 b 同一個 tick 到期：先執行的一方把另一方停掉 (不論串列順序都只會有一個執行)
+    pa.stop_other = &b;
+    pb.stop_other = &a;
+    sched_start(&sched, &a, 10, 10);
+    sched_start(&sched, &b, 10, 10);
+    sched_start(&sched, &c, 30, 0);
+    sched_stop(&sched, &c);
+
+    advance_to(1100);
+    TEST_ASSERT_EQUAL_INT(10, pa.count + pb.count);
+    TEST_ASSERT_TRUE(pa.count == 0 || pb.count == 0);
+    TEST_ASSERT_EQUAL_INT(0, pc.count);
+}
+
+void test_Stalled_Loop_Should_Run_Once_And_Realign(void)
+{
+    sched_task_t t;
+    probe_t p = {0};
+    sched_task_init(&t, "p10", probe_fn, &p, 0);
+    sched_start(&sched, &t, 10, 10);
+
+    // 主迴圈被卡了 505 ms (超過一圈)：只補跑一次，不會連續爆發 50 次
+    now_ms += 505;
+    TEST_ASSERT_EQUAL_UINT32(1, sched_run(&sched, now_ms));
+    TEST_ASSERT_EQUAL_UINT32(495, t.max_late_ms);
+    TEST_ASSERT_EQUAL_UINT32(49, t.skipped);
+
+    advance_to(1525);
+    TEST_ASSERT_EQUAL_INT(3, p.count);
+    TEST_ASSERT_EQUAL_UINT32(1515, p.at[1]);  // 從恢復的時間點重新對齊
+    TEST_ASSERT_EQUAL_UINT32(1525, p.at[2]);
+}
+
+void test_Deadlines_Should_Survive_Clock_Wrap(void)
+{
+    now_ms = 0xFFFFFFF0u;
+    sched_init(&sched, now_ms, NULL, NULL);
+
+    sched_task_t t;
+    probe_t p = {0};
+    sched_task_init(&t, "wrap", probe_fn, &p, 0);
+    sched_start(&sched, &t, 10, 10);
+
+    advance_to(0x20);
+    TEST_ASSERT_EQUAL_INT(4, p.count);
+    TEST_ASSERT_EQUAL_UINT32(0xFFFFFFFAu, p.at[0]);
+    TEST_ASSERT_EQUAL_UINT32(0x00000004u, p.at[1]);
+}
+
+// ==========================================
+// 3. Event task 與 budget
+// ==========================================
+typedef struct
+{
+    int items;  // 模擬 ring 中的資料量
+    int handled;
+    uint32_t cost_us;
+} ring_sim_t;
+
+static bool ring_ready(void* ctx)
+{
+    return ((ring_sim_t*)ctx)->items > 0;
+}
+
+// 批次消費：每個 item 花 cost_us，用完 budget 就讓出
+static void ring_drain(void* ctx, uint32_t now)
+{
+    (void)now;
+    ring_sim_t* r = (ring_sim_t*)ctx;
+    while (r->items > 0 && !sched_should_yield(&sched))
+    {
+        r->items--;
+        r->handled++;
+        clock_us += r->cost_us;
+    }
+}
+
+void test_Event_Task_Should_Run_Only_When_Ready_Or_Notified(void)
+{
+    sched_task_t ring_task, notify_task;
+    ring_sim_t r = {0};
+    probe_t p = {0};
+    sched_task_init(&ring_task, "ring", ring_drain, &r, 0);
+    sched_task_init(&notify_task, "notify", probe_fn, &p, 0);
+    sched_add_event(&sched, &ring_task, ring_ready);
+    sched_add_event(&sched, &notify_task, NULL);
+
+    TEST_ASSERT_EQUAL_UINT32(0, sched_run(&sched, now_ms));
+
+    r.items = 5;
+    sched_notify(&notify_task);
+    TEST_ASSERT_EQUAL_UINT32(2, sched_run(&sched, now_ms));
+    TEST_ASSERT_EQUAL_INT(5, r.handled);
+    TEST_ASSERT_EQUAL_INT(1, p.count);
+
+    // notify 只觸發一次
+    TEST_ASSERT_EQUAL_UINT32(0, sched_run(&sched, now_ms));
+    TEST_ASSERT_EQUAL_UINT32(1, ring_task.runs);
+}
+
+void test_Budget_Should_Bound_Batches_So_Timers_Keep_Their_Deadlines(void)
+{
+    sched_task_t ring_task, tick;
+    ring_sim_t r = {.items = 100, .cost_us = 100};
+    probe_t p = {0};
+    sched_task_init(&ring_task, "ring", ring_drain, &r, 500);
+    sched_task_init(&tick, "tick", probe_fn, &p, 0);
+    sched_add_event(&sched, &ring_task, ring_ready);
+    sched_start(&sched, &tick, 1, 1);
+
+    // 每輪只處理 500 us 份量 (5 個)，1 ms 的 timer 每一輪都能準時執行
+    for (int pass = 0; pass < 20; pass++)
+    {
+        now_ms++;
+        sched_run(&sched, now_ms);
+        TEST_ASSERT_EQUAL_INT(5 * (pass + 1), r.handled);
+    }
+    TEST_ASSERT_EQUAL_INT(20, p.count);
+    TEST_ASSERT_EQUAL_UINT32(0, tick.max_late_ms);
+    TEST_ASSERT_EQUAL_UINT32(0, ring_task.overruns);
+    TEST_ASSERT_EQUAL_UINT32(500, ring_task.max_us);
+}
+
+void test_Budget_Overrun_Should_Be_Counted(void)
+{
+    sched_task_t t;
+    probe_t p = {.work_us = 300};
+    sched_task_init(&t, "slow", probe_fn, &p, 200);
+    sched_start(&sched, &t, 1, 1);
+
+    advance_to(1003);
+    TEST_ASSERT_EQUAL_UINT32(3, t.runs);
+    TEST_ASSERT_EQUAL_UINT32(3, t.overruns);
+    TEST_ASSERT_EQUAL_UINT32(300, t.max_us);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_Periodic_Task_Should_Fire_On_Exact_Deadlines);
+    RUN_TEST(test_One_Shot_Should_Fire_Once_Even_Beyond_One_Wheel_Turn);
+    RUN_TEST(test_Period_Equal_To_Wheel_Size_Should_Not_Rerun_In_Same_Pass);
+    RUN_TEST(test_Stop_Should_Work_Before_Expiry_And_From_Another_Task);
+    RUN_TEST(test_Stalled_Loop_Should_Run_Once_And_Realign);
+    RUN_TEST(test_Deadlines_Should_Survive_Clock_Wrap);
+    RUN_TEST(test_Event_Task_Should_Run_Only_When_Ready_Or_Notified);
+    RUN_TEST(test_Budget_Should_Bound_Batches_So_Timers_Keep_Their_Deadlines);
+    RUN_TEST(test_Budget_Overrun_Should_Be_Counted);
+    return UNITY_END();
+}
@@ -1,11 +1,38 @@
 // 檔案位置: test/test_sentinel.c
 
+#include <stdio.h>
+#include <string.h>
+
 #include "sentinel_core.h"  // 我們要測的目標
 #include "unity.h"
 
+// Sentinel_ParseBuffer 的 Callback 紀錄
+typedef struct
+{
+    SystemCmd_t cmds[8];
+    uint32_t args[8];
+    uint8_t channels[8];
+    int count;
+} cmd_log_t;
+
+static void log_cmd(void* ctx, const sentinel_cmd_t* cmd)
+{
+    cmd_log_t* log = (cmd_log_t*)ctx;
+    if (log->count < 8)
+    {
+        log->cmds[log->count] = cmd->id;
+        log->args[log->count] = (cmd->args.argc > 0) ? cmd->args.num[0] : 0;
+        log->channels[log->count] = cmd->channel;
+    }
+    log->count++;
+}
+
+static sentinel_parser_t parser;
+
 void setUp(void)
 {
     // 每個測試執行前會跑這裡
+    Sentinel_ParserInit(&parser, 0);
 }
 
 void tearDown(void)
@@ -34,11 +61,167 @@ void test_System_Should_Alarm_Below_3v0(void)
     TEST_ASSERT_EQUAL(STATUS_LOW_BATTERY, status);
 }
 
+// 測試 4: 一段資料內的所有指令都透過 Callback 送出，\r\n 的空行不算指令
+void test_ParseBuffer_Should_Emit_Every_Command_In_Chunk(void)
+{
+    const char* in = "PING\r\nINV\nBAUD 921600\nJUNK\nNORM\r";
+    cmd_log_t log = {0};
+
+    size_t n = Sentinel_ParseBuffer(&parser, in, strlen(in), log_cmd, &log);
+
+    TEST_ASSERT_EQUAL_size_t(4, n);
+    TEST_ASSERT_EQUAL_INT(4, log.count);
+    TEST_ASSERT_EQUAL(CMD_SYSTEM_PING, log.cmds[0]);
+    TEST_ASSERT_EQUAL(CMD_OLED_INVERT, log.cmds[1]);
+    TEST_ASSERT_EQUAL(CMD_SET_BAUD, log.cmds[2]);
+    TEST_ASSERT_EQUAL_UINT32(921600, log.args[2]);
+    TEST_ASSERT_EQUAL(CMD_OLED_NORMAL, log.cmds[3]);
+}
+
+// 測試 5: 跨 chunk 的指令 (DMA span 在任意位置切斷) 與逐字元版本共用狀態
+void test_ParseBuffer_Should_Carry_Partial_Line_Across_Chunks(void)
+{
+    cmd_log_t log = {0};
+
+    TEST_ASSERT_EQUAL_size_t(0, Sentinel_ParseBuffer(&parser, "PI", 2, log_cmd, &log));
+    TEST_ASSERT_EQUAL_size_t(1, Sentinel_ParseBuffer(&parser, "NG\nBAUD", 7, log_cmd, &log));
+    TEST_ASSERT_EQUAL(CMD_SYSTEM_PING, log.cmds[0]);
+
+    Sentinel_ParseChar(&parser, ' ');
+    Sentinel_ParseChar(&parser, 'O');
+    TEST_ASSERT_EQUAL_size_t(1, Sentinel_ParseBuffer(&parser, "K\n", 2, log_cmd, &log));
+    TEST_ASSERT_EQUAL(CMD_BAUD_CONFIRM, log.cmds[1]);
+    TEST_ASSERT_EQUAL_UINT32(0, log.args[1]);
+}
+
+// 測試 6: 超長的行整行丟棄 (與 Sentinel_ParseChar 相同)，不影響下一行
+void test_ParseBuffer_Should_Drop_Overlong_Line(void)
+{
+    const char* in = "PINGPINGPINGPINGPINGPINGPINGPINGPINGPING\nPING\n";
+    cmd_log_t log = {0};
+
+    TEST_ASSERT_EQUAL_size_t(1, Sentinel_ParseBuffer(&parser, in, strlen(in), log_cmd, &log));
+    TEST_ASSERT_EQUAL(CMD_SYSTEM_PING, log.cmds[0]);
+
+    // 沒有 Callback 也只回傳計數
+    TEST_ASSERT_EQUAL_size_t(2, Sentinel_ParseBuffer(&parser, "INV\nNORM\n", 9, NULL, NULL));
+}
+
+// 測試 7: 指令表中每個不帶參數的指令都能以名稱解析回自己 (hash index 沒有衝突遺漏)
+void test_CmdTable_Every_Name_Should_Round_Trip(void)
+{
+    TEST_ASSERT_NULL(Sentinel_CmdInfo(CMD_NONE));
+    TEST_ASSERT_NULL(Sentinel_CmdInfo(CMD_COUNT));
+
+    for (int cmd = CMD_NONE + 1; cmd < CMD_COUNT; cmd++)
+    {
+        const sentinel_cmd_info_t* info = Sentinel_CmdInfo((SystemCmd_t)cmd);
+        TEST_ASSERT_NOT_NULL(info);
+        TEST_ASSERT_EQUAL_size_t(strlen(info->name), info->name_len);
+        TEST_ASSERT_NOT_NULL(info->help);
+        if (info->schema[0] != '\0') continue;
+
+        for (const char* p = info->name; *p; p++) Sentinel_ParseChar(&parser, *p);
+        SystemCmd_t got = Sentinel_ParseChar(&parser, '\n');
+        TEST_ASSERT_EQUAL_MESSAGE(cmd, got, info->name);
+    }
+}
+
+// 測試 8: 參數依 schema 解析，個數或格式不符的行視為無效
+void test_CmdTable_Should_Validate_Argument_Schema(void)
+{
+    const char* in = "BAUD\nBAUD abc\nBAUD 1 2\nPING 1\nBAUD 99999999999\nBAUD  115200 \n";
+    cmd_log_t log = {0};
+
+    TEST_ASSERT_EQUAL_size_t(1, Sentinel_ParseBuffer(&parser, in, strlen(in), log_cmd, &log));
+    TEST_ASSERT_EQUAL(CMD_SET_BAUD, log.cmds[0]);
+    TEST_ASSERT_EQUAL_UINT32(115200, log.args[0]);
+    TEST_ASSERT_EQUAL_UINT32(115200, Sentinel_LastCmd(&parser)->args.num[0]);
+}
+
+// 測試 9: token 參數指向解析器的 line buffer，並帶在 Sentinel_LastCmd() 中
+void test_CmdTable_Should_Parse_Token_Argument(void)
+{
+    const char* in = "ECHO hello\n";
+    SystemCmd_t cmd = CMD_NONE;
+    for (const char* p = in; *p; p++) cmd = Sentinel_ParseChar(&parser, *p);
+
+    TEST_ASSERT_EQUAL(CMD_ECHO, cmd);
+    const sentinel_args_t* args = &Sentinel_LastCmd(&parser)->args;
+    TEST_ASSERT_EQUAL_UINT8(1, args->argc);
+    TEST_ASSERT_EQUAL_STRING("hello", args->tok[0]);
+
+    for (const char* p = "ECHO\n"; *p; p++) cmd = Sentinel_ParseChar(&parser, *p);
+    TEST_ASSERT_EQUAL(CMD_NONE, cmd);
+}
+
+// 測試 10: 兩個 context 交錯餵入也不會互相污染，結果帶著各自的 channel
+void test_Parser_Contexts_Should_Be_Independent(void)
+{
+    sentinel_parser_t usb;
+    sentinel_parser_t uart;
+    Sentinel_ParserInit(&usb, 1);
+    Sentinel_ParserInit(&uart, 2);
+    cmd_log_t log = {0};
+
+    const char* a = "PING\nBAUD 921600\n";
+    const char* b = "INV\nECHO hi\n";
+    const size_t la = strlen(a);
+    const size_t lb = strlen(b);
+    for (size_t i = 0; i < la || i < lb; i++)
+    {
+        if (i < la) Sentinel_ParseBuffer(&usb, &a[i], 1, log_cmd, &log);
+        if (i < lb) Sentinel_ParseBuffer(&uart, &b[i], 1, log_cmd, &log);
+    }
+
+    TEST_ASSERT_EQUAL_INT(4, log.count);
+    TEST_ASSERT_EQUAL(CMD_OLED_INVERT, log.cmds[0]);
+    TEST_ASSERT_EQUAL_UINT8(2, log.channels[0]);
+    TEST_ASSERT_EQUAL(CMD_SYSTEM_PING, log.cmds[1]);
+    TEST_ASSERT_EQUAL_UINT8(1, log.channels[1]);
+    TEST_ASSERT_EQUAL(CMD_ECHO, log.cmds[2]);
+    TEST_ASSERT_EQUAL_UINT8(2, log.channels[2]);
+    TEST_ASSERT_EQUAL(CMD_SET_BAUD, log.cmds[3]);
+    TEST_ASSERT_EQUAL_UINT32(921600, log.args[3]);
+    TEST_ASSERT_EQUAL_STRING("hi", Sentinel_LastCmd(&uart)->args.tok[0]);
+}
+
+// 測試 11: 帶參數的指令超過 SENTINEL_LINE_MAX 時不能以截斷後的參數執行
+void test_Overlong_Args_Should_Not_Run_Truncated(void)
+{
+    // 截斷在 31 字元會剩下 "BAUD <空白> 11520"，看起來是合法的 baud
+    char baud[64];
+    snprintf(baud, sizeof(baud), "BAUD%22s1152000\nPING\n", "");
+    cmd_log_t log = {0};
+
+    TEST_ASSERT_EQUAL_size_t(1, Sentinel_ParseBuffer(&parser, baud, strlen(baud), log_cmd, &log));
+    TEST_ASSERT_EQUAL(CMD_SYSTEM_PING, log.cmds[0]);
+
+    // 逐字元版本：ECHO 的文字被截斷也整行拒絕，下一行恢復正常
+    SystemCmd_t cmd = CMD_NONE;
+    for (const char* p = "ECHO 0123456789012345678901234567890123456789\n"; *p; p++)
+    {
+        cmd = Sentinel_ParseChar(&parser, *p);
+    }
+    TEST_ASSERT_EQUAL(CMD_NONE, cmd);
+    for (const char* p = "ECHO ok\n"; *p; p++) cmd = Sentinel_ParseChar(&parser, *p);
+    TEST_ASSERT_EQUAL(CMD_ECHO, cmd);
+    TEST_ASSERT_EQUAL_STRING("ok", Sentinel_LastCmd(&parser)->args.tok[0]);
+}
+
 int main(void)
 {
     UNITY_BEGIN();
     RUN_TEST(test_System_Should_Be_Normal_At_3v3);
     RUN_TEST(test_System_Should_Be_Normal_At_3v0);
     RUN_TEST(test_System_Should_Alarm_Below_3v0);
+    RUN_TEST(test_ParseBuffer_Should_Emit_Every_Command_In_Chunk);
+    RUN_TEST(test_ParseBuffer_Should_Carry_Partial_Line_Across_Chunks);
+    RUN_TEST(test_ParseBuffer_Should_Drop_Overlong_Line);
+    RUN_TEST(test_CmdTable_Every_Name_Should_Round_Trip);
+    RUN_TEST(test_CmdTable_Should_Validate_Argument_Schema);
+    RUN_TEST(test_CmdTable_Should_Parse_Token_Argument);
+    RUN_TEST(test_Parser_Contexts_Should_Be_Independent);
+    RUN_TEST(test_Overlong_Args_Should_Not_Run_Truncated);
     return UNITY_END();
 }
\ No newline at end of file
@@ -0,0 +1,261 @@
+// 檔案位置: test/test_sentinel_frame.c
+// COBS 編解碼、CRC16 與 link 的文字 / frame 自動切換
+
+#include <string.h>
+
+#include "cobs.h"
+#include "sentinel_frame.h"
+#include "unity.h"
+
+// ==========================================
+// 1. 測試輔助
+// ==========================================
+typedef struct
+{
+    sentinel_cmd_t cmds[8];
+    char toks[8][16];  // tok 只在 callback 內有效，先複製出來
+    int cmd_count;
+
+    uint8_t frame_type;
+    uint8_t frame_seq;
+    uint8_t frame_payload[SENTINEL_FRAME_PAYLOAD_MAX];
+    uint16_t frame_len;
+    int frame_count;
+} link_log_t;
+
+static void log_cmd(void* ctx, const sentinel_cmd_t* cmd)
+{
+    link_log_t* log = (link_log_t*)ctx;
+    if (log->cmd_count < 8)
+    {
+        log->cmds[log->cmd_count] = *cmd;
+        if (cmd->args.argc > 0 && cmd->id == CMD_ECHO)
+        {
+            strncpy(log->toks[log->cmd_count], cmd->args.tok[0], 15);
+        }
+    }
+    log->cmd_count++;
+}
+
+static void log_frame(void* ctx, const sentinel_frame_t* frame)
+{
+    link_log_t* log = (link_log_t*)ctx;
+    log->frame_type = frame->type;
+    log->frame_seq = frame->seq;
+    log->frame_len = frame->len;
+    memcpy(log->frame_payload, frame->payload, frame->len);
+    log->frame_count++;
+}
+
+static sentinel_link_t link;
+static link_log_t rec;
+
+static size_t feed(const void* data, size_t len)
+{
+    return Sentinel_LinkFeed(&link, (const uint8_t*)data, len, log_cmd, log_frame, &rec);
+}
+
+void setUp(void)
+{
+    Sentinel_LinkInit(&link, 3);
+    memset(&rec, 0, sizeof(rec));
+}
+
+void tearDown(void) {}
+
+// ==========================================
+// 2. COBS / CRC
+// ==========================================
+static void check_cobs_round_trip(const uint8_t* src, size_t len)
+{
+    uint8_t enc[COBS_ENCODED_MAX(600)];
+    uint8_t dec[600];
+    size_t n = cobs_encode(src, len, enc, sizeof(enc));
+    TEST_ASSERT_TRUE(n > 0 && n <= COBS_ENCODED_MAX(len));
+    TEST_ASSERT_NULL(memchr(enc, COBS_DELIM, n));
+    enc[n++] = COBS_DELIM;
+
+    cobs_decoder_t d;
+    cobs_decoder_init(&d, dec, sizeof(dec));
+    size_t used;
+    TEST_ASSERT_EQUAL(COBS_DEC_FRAME, cobs_decode_feed(&d, enc, n, &used));
+    TEST_ASSERT_EQUAL_size_t(n, used);
+    TEST_ASSERT_EQUAL_size_t(len, d.len);
+    if (len > 0) TEST_ASSERT_EQUAL_MEMORY(src, dec, len);
+}
+
+void test_Cobs_Should_Round_Trip_Zero_Runs_And_Long_Blocks(void)
+{
+    static uint8_t buf[600];
+
+    check_cobs_round_trip(buf, 0);
+    check_cobs_round_trip(buf, 1);  // 單一個 0
+    check_cobs_round_trip(buf, 3);
+
+    // 254 / 255 / 508 個非 0 byte：剛好填滿 0xFF block 的邊界
+    memset(buf, 0x5A, sizeof(buf));
+    check_cobs_round_trip(buf, 254);
+    check_cobs_round_trip(buf, 255);
+    check_cobs_round_trip(buf, 508);
+
+    for (size_t i = 0; i < sizeof(buf); i++) buf[i] = (uint8_t)(i % 7 == 0 ? 0 : i);
+    check_cobs_round_trip(buf, sizeof(buf));
+
+    uint8_t small[COBS_ENCODED_MAX(3) - 1];
+    TEST_ASSERT_EQUAL_size_t(0, cobs_encode(buf, 3, small, sizeof(small)));
+}
+
+void test_Crc16_Should_Match_Ccitt_False_Check_Value(void)
+{
+    TEST_ASSERT_EQUAL_HEX16(0x29B1, SentinelFrame_Crc16((const uint8_t*)"123456789", 9));
+}
+
+// ==========================================
+// 3. Link：frame 指令與文字指令
+// ==========================================
+void test_Link_Should_Dispatch_Cmd_Frame_With_Binary_Args(void)
+{
+    const uint8_t baud[] = {CMD_SET_BAUD, 0x00, 0x10, 0x0E, 0x00};  // 921600 LE
+    uint8_t wire[SENTINEL_FRAME_WIRE_MAX];
+    size_t n = SentinelFrame_Encode(FRAME_TYPE_CMD, 42, baud, sizeof(baud), wire, sizeof(wire));
+    TEST_ASSERT_TRUE(n > 0);
+    TEST_ASSERT_EQUAL_HEX8(0x00, wire[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, wire[n - 1]);
+
+    TEST_ASSERT_EQUAL_size_t(1, feed(wire, n));
+    TEST_ASSERT_EQUAL_INT(1, rec.cmd_count);
+    TEST_ASSERT_EQUAL(CMD_SET_BAUD, rec.cmds[0].id);
+    TEST_ASSERT_EQUAL_UINT32(921600, rec.cmds[0].args.num[0]);
+    TEST_ASSERT_TRUE(rec.cmds[0].framed);
+    TEST_ASSERT_EQUAL_UINT8(42, rec.cmds[0].seq);
+    TEST_ASSERT_EQUAL_UINT8(3, rec.cmds[0].channel);
+    TEST_ASSERT_EQUAL_UINT32(1, link.frames_ok);
+}
+
+void test_Link_Should_Switch_Between_Text_And_Frames_In_One_Span(void)
+{
+    const uint8_t echo[] = {CMD_ECHO, 'h', 'i', '\0'};
+    uint8_t span[128];
+    size_t n = 0;
+
+    // 文字行被 frame 從中間切開：frame 前後的文字接成同一行
+    memcpy(&span[n], "PING\nNO", 7);
+    n += 7;
+    n += SentinelFrame_Encode(FRAME_TYPE_CMD, 7, echo, sizeof(echo), &span[n], sizeof(span) - n);
+    memcpy(&span[n], "RM\n", 3);
+    n += 3;
+
+    // 逐 byte 餵入 (任意 DMA span 邊界) 與整段餵入結果相同
+    TEST_ASSERT_EQUAL_size_t(3, feed(span, n));
+    for (size_t i = 0; i < n; i++) feed(&span[i], 1);
+
+    TEST_ASSERT_EQUAL_INT(6, rec.cmd_count);
+    for (int pass = 0; pass < 2; pass++)
+    {
+        const sentinel_cmd_t* c = &rec.cmds[pass * 3];
+        TEST_ASSERT_EQUAL(CMD_SYSTEM_PING, c[0].id);
+        TEST_ASSERT_FALSE(c[0].framed);
+        TEST_ASSERT_EQUAL(CMD_ECHO, c[1].id);
+        TEST_ASSERT_TRUE(c[1].framed);
+        TEST_ASSERT_EQUAL_STRING("hi", rec.toks[pass * 3 + 1]);
+        TEST_ASSERT_EQUAL(CMD_OLED_NORMAL, c[2].id);
+    }
+}
+
+void test_Link_Should_Pass_Other_Frame_Types_To_On_Frame(void)
+{
+    const uint8_t payload[] = {0x00, 0x01, 0x00, 0xFF};
+    uint8_t wire[SENTINEL_FRAME_WIRE_MAX];
+    size_t n = SentinelFrame_Encode(FRAME_TYPE_TEXT, 9, payload, sizeof(payload), wire,
+                                    sizeof(wire));
+
+    TEST_ASSERT_EQUAL_size_t(0, feed(wire, n));
+    TEST_ASSERT_EQUAL_INT(1, rec.frame_count);
+    TEST_ASSERT_EQUAL_UINT8(FRAME_TYPE_TEXT, rec.frame_type);
+    TEST_ASSERT_EQUAL_UINT8(9, rec.frame_seq);
+    TEST_ASSERT_EQUAL_UINT16(sizeof(payload), rec.frame_len);
+    TEST_ASSERT_EQUAL_MEMORY(payload, rec.frame_payload, sizeof(payload));
+}
+
+// ==========================================
+// 4. 錯誤處理：丟棄壞 frame 後回到文字模式
+// ==========================================
+void test_Link_Should_Drop_Bad_Frames_And_Recover(void)
+{
+    const uint8_t ping[] = {CMD_SYSTEM_PING};
+    uint8_t wire[SENTINEL_FRAME_WIRE_MAX];
+    size_t n = SentinelFrame_Encode(FRAME_TYPE_CMD, 1, ping, sizeof(ping), wire, sizeof(wire));
+
+    // CRC 錯誤 (改一個 byte，但不能改成 0x00)
+    wire[2] ^= 0x01;
+    if (wire[2] == 0) wire[2] = 0x80;
+    feed(wire, n);
+    TEST_ASSERT_EQUAL_UINT32(1, link.frames_bad_crc);
+
+    // 過短 (只有 type)、未知指令、參數不符 schema
+    const uint8_t too_short[] = {0x00, 0x02, FRAME_TYPE_CMD, 0x00};
+    feed(too_short, sizeof(too_short));
+    const uint8_t bad_cmd[] = {0xEE};
+    n = SentinelFrame_Encode(FRAME_TYPE_CMD, 2, bad_cmd, sizeof(bad_cmd), wire, sizeof(wire));
+    feed(wire, n);
+    const uint8_t short_arg[] = {CMD_SET_BAUD, 0x01};
+    n = SentinelFrame_Encode(FRAME_TYPE_CMD, 3, short_arg, sizeof(short_arg), wire, sizeof(wire));
+    feed(wire, n);
+    TEST_ASSERT_EQUAL_UINT32(3, link.frames_malformed);
+    TEST_ASSERT_EQUAL_INT(2, rec.frame_count);  // 不符 schema 的 CMD 仍交給上層回錯誤
+    TEST_ASSERT_EQUAL_UINT8(3, rec.frame_seq);
+
+    // 超過 buffer 的 frame (COBS 本身合法)：一超過就丟棄，不必等到結尾的分隔符號
+    uint8_t raw[SENTINEL_FRAME_RAW_MAX + 40];
+    uint8_t big[COBS_ENCODED_MAX(sizeof(raw)) + 1];
+    memset(raw, 0x11, sizeof(raw));
+    size_t enc = cobs_encode(raw, sizeof(raw), &big[1], sizeof(big) - 1);
+    big[0] = COBS_DELIM;
+    feed(big, enc + 1);
+    TEST_ASSERT_EQUAL_UINT32(4, link.frames_malformed);
+
+    // frame 的殘餘當作被丟棄的文字行，換行之後恢復
+    TEST_ASSERT_EQUAL_INT(0, rec.cmd_count);
+    TEST_ASSERT_EQUAL_size_t(1, feed("\nINV\n", 5));
+    TEST_ASSERT_EQUAL(CMD_OLED_INVERT, rec.cmds[0].id);
+}
+
+void test_Link_Should_Recover_From_Stray_Sync_Byte(void)
+{
+    // 線路雜訊的 0x00 讓 link 進入 frame 模式，之後的文字被當成 COBS 資料
+    uint8_t span[SENTINEL_FRAME_RAW_MAX + 64];
+    size_t n = 0;
+    span[n++] = COBS_DELIM;
+    memcpy(&span[n], "PING\n", 5);
+    n += 5;
+    memset(&span[n], 'x', SENTINEL_FRAME_RAW_MAX);  // 不含 0x00：沒有分隔符號會來
+    n += SENTINEL_FRAME_RAW_MAX;
+    memcpy(&span[n], "\nPING\n", 6);
+    n += 6;
+
+    // 解碼一超過 buffer 就回到文字模式：被吞掉的 PING 無法挽回，下一行正常執行
+    TEST_ASSERT_EQUAL_size_t(1, feed(span, n));
+    TEST_ASSERT_EQUAL_UINT32(1, link.frames_malformed);
+    TEST_ASSERT_FALSE(link.in_frame);
+    TEST_ASSERT_EQUAL_INT(1, rec.cmd_count);
+    TEST_ASSERT_EQUAL(CMD_SYSTEM_PING, rec.cmds[0].id);
+
+    // 逐 byte 餵入結果相同
+    setUp();
+    for (size_t i = 0; i < n; i++) feed(&span[i], 1);
+    TEST_ASSERT_EQUAL_INT(1, rec.cmd_count);
+    TEST_ASSERT_EQUAL(CMD_SYSTEM_PING, rec.cmds[0].id);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_Cobs_Should_Round_Trip_Zero_Runs_And_Long_Blocks);
+    RUN_TEST(test_Crc16_Should_Match_Ccitt_False_Check_Value);
+    RUN_TEST(test_Link_Should_Dispatch_Cmd_Frame_With_Binary_Args);
+    RUN_TEST(test_Link_Should_Switch_Between_Text_And_Frames_In_One_Span);
+    RUN_TEST(test_Link_Should_Pass_Other_Frame_Types_To_On_Frame);
+    RUN_TEST(test_Link_Should_Drop_Bad_Frames_And_Recover);
+    RUN_TEST(test_Link_Should_Recover_From_Stray_Sync_Byte);
+    return UNITY_END();
+}
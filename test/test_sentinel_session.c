@@ -0,0 +1,246 @@
+// 檔案位置: test/test_sentinel_session.c
+// Request / Response Session：序號、重送 / 跳號處理、bulk 的 window 與 Go-Back-N 重送
+// Device 送出的 frame 直接餵給 host 端的 sentinel_link_t 解碼，host 的行為在測試裡模擬
+
+#include <string.h>
+
+#include "sentinel_session.h"
+#include "unity.h"
+
+// ==========================================
+// 1. 模擬 link 與 host
+// ==========================================
+typedef struct
+{
+    uint8_t type;
+    uint8_t seq;
+    uint8_t payload[SENTINEL_FRAME_PAYLOAD_MAX];
+    uint16_t len;
+} host_frame_t;
+
+static struct
+{
+    sentinel_link_t link;  // host 端的 frame 解碼
+    host_frame_t frames[64];
+    int count;
+
+    int drop_data_seq;  // 這個 seq 的 DATA 第一次送出時遺失 (-1 = 不丟)
+    bool dropped;
+
+    // Go-Back-N 接收端：只收依序到達的 DATA
+    uint8_t data_expected;
+    uint8_t bulk[4096];
+    uint32_t bulk_len;
+} host;
+
+static session_t ses;
+static uint32_t now_ms;
+
+static void host_on_frame(void* ctx, const sentinel_frame_t* f)
+{
+    (void)ctx;
+    if (f->type == FRAME_TYPE_DATA && f->seq == host.drop_data_seq && !host.dropped)
+    {
+        host.dropped = true;  // 線上遺失
+        return;
+    }
+
+    if (f->type == FRAME_TYPE_DATA && f->seq == host.data_expected)
+    {
+        uint32_t off = (uint32_t)f->payload[0] | ((uint32_t)f->payload[1] << 8) |
+                       ((uint32_t)f->payload[2] << 16) | ((uint32_t)f->payload[3] << 24);
+        uint32_t n = f->len - SESSION_DATA_HEADER;
+        TEST_ASSERT_EQUAL_UINT32(host.bulk_len, off);  // 依序到達，offset 連續
+        memcpy(&host.bulk[off], &f->payload[SESSION_DATA_HEADER], n);
+        host.bulk_len += n;
+        host.data_expected++;
+    }
+
+    if (host.count < 64)
+    {
+        host_frame_t* h = &host.frames[host.count];
+        h->type = f->type;
+        h->seq = f->seq;
+        h->len = f->len;
+        memcpy(h->payload, f->payload, f->len);
+    }
+    host.count++;
+}
+
+static bool dev_send(void* ctx, const uint8_t* wire, size_t len)
+{
+    (void)ctx;
+    Sentinel_LinkFeed(&host.link, wire, len, NULL, host_on_frame, NULL);
+    return true;
+}
+
+static size_t dev_read(void* ctx, uint32_t offset, uint8_t* buf, size_t cap)
+{
+    (void)ctx;
+    for (size_t i = 0; i < cap; i++) buf[i] = (uint8_t)(offset * 7 + i * 7);
+    return cap;
+}
+
+static const session_ops_t dev_ops = {.send = dev_send, .read = dev_read, .ctx = NULL};
+
+void setUp(void)
+{
+    memset(&host, 0, sizeof(host));
+    host.drop_data_seq = -1;
+    Sentinel_LinkInit(&host.link, 0);
+    now_ms = 0;
+    Session_Init(&ses, &dev_ops, 4, 50);
+}
+
+void tearDown(void) {}
+
+static const host_frame_t* last_frame(void)
+{
+    TEST_ASSERT_TRUE(host.count > 0);
+    return &host.frames[host.count - 1];
+}
+
+// ==========================================
+// 2. 請求端
+// ==========================================
+void test_Requests_Should_Pipeline_And_Respond_In_Order(void)
+{
+    for (uint8_t seq = 0; seq < 5; seq++)
+    {
+        TEST_ASSERT_TRUE(Session_OnRequest(&ses, seq));
+    }
+    for (uint8_t seq = 0; seq < 5; seq++)
+    {
+        Session_Respond(&ses, seq, SESSION_OK);
+    }
+
+    TEST_ASSERT_EQUAL_INT(5, host.count);
+    for (uint8_t seq = 0; seq < 5; seq++)
+    {
+        TEST_ASSERT_EQUAL_UINT8(FRAME_TYPE_RESP, host.frames[seq].type);
+        TEST_ASSERT_EQUAL_UINT8(seq, host.frames[seq].seq);
+        TEST_ASSERT_EQUAL_UINT8(SESSION_OK, host.frames[seq].payload[0]);
+        TEST_ASSERT_EQUAL_UINT8(5, host.frames[seq].payload[1]);  // 累積 ack
+    }
+}
+
+void test_Retransmitted_Request_Should_Not_Execute_Twice(void)
+{
+    for (uint8_t seq = 0; seq < 3; seq++) TEST_ASSERT_TRUE(Session_OnRequest(&ses, seq));
+
+    // host 沒收到 seq 1 的 RESP 而重送
+    TEST_ASSERT_FALSE(Session_OnRequest(&ses, 1));
+    TEST_ASSERT_EQUAL_UINT8(FRAME_TYPE_RESP, last_frame()->type);
+    TEST_ASSERT_EQUAL_UINT8(1, last_frame()->seq);
+    TEST_ASSERT_EQUAL_UINT8(SESSION_DUP, last_frame()->payload[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, ses.dup_requests);
+}
+
+void test_Gap_Should_Ask_Host_To_Go_Back(void)
+{
+    TEST_ASSERT_TRUE(Session_OnRequest(&ses, 0));
+    TEST_ASSERT_TRUE(Session_OnRequest(&ses, 1));
+
+    // seq 2 遺失，3 先到：丟棄並告訴 host 從 2 重送
+    TEST_ASSERT_FALSE(Session_OnRequest(&ses, 3));
+    TEST_ASSERT_EQUAL_UINT8(FRAME_TYPE_ACK, last_frame()->type);
+    TEST_ASSERT_EQUAL_UINT8(2, last_frame()->seq);
+    TEST_ASSERT_EQUAL_UINT32(1, ses.gap_requests);
+
+    TEST_ASSERT_TRUE(Session_OnRequest(&ses, 2));
+    TEST_ASSERT_TRUE(Session_OnRequest(&ses, 3));
+}
+
+void test_Request_Seq_Should_Wrap_Around(void)
+{
+    for (uint32_t i = 0; i < 600; i++)
+    {
+        TEST_ASSERT_TRUE(Session_OnRequest(&ses, (uint8_t)i));
+    }
+    TEST_ASSERT_FALSE(Session_OnRequest(&ses, (uint8_t)599));  // wrap 之後仍認得出重送
+    TEST_ASSERT_EQUAL_UINT32(1, ses.dup_requests);
+}
+
+// ==========================================
+// 3. Bulk 傳送端
+// ==========================================
+// 一輪 = device Poll 一次 + host 對這輪收到的 DATA 回一個累積 ACK；回傳完成所需的輪數
+static uint32_t run_bulk(uint32_t total, uint32_t chunk, uint32_t max_rounds)
+{
+    TEST_ASSERT_TRUE(Session_BulkStart(&ses, total, chunk, now_ms));
+
+    uint32_t rounds = 0;
+    while (Session_BulkBusy(&ses) && rounds < max_rounds)
+    {
+        int before = host.count;
+        Session_Poll(&ses, now_ms);
+        TEST_ASSERT_TRUE(host.count - before <= ses.window);  // in-flight 不超過 window
+
+        now_ms += 10;
+        if (host.count != before) Session_OnAck(&ses, host.data_expected, now_ms);
+        rounds++;
+    }
+    TEST_ASSERT_FALSE(Session_BulkBusy(&ses));
+    TEST_ASSERT_EQUAL_UINT32(total, host.bulk_len);
+
+    uint8_t expect[4096];
+    dev_read(NULL, 0, expect, total);
+    TEST_ASSERT_EQUAL_MEMORY(expect, host.bulk, total);
+    return rounds;
+}
+
+void test_Bulk_Window_Should_Cut_Round_Trips(void)
+{
+    // 10 個 chunk：window 4 → 3 輪；stop-and-wait (window 1) → 10 輪
+    TEST_ASSERT_EQUAL_UINT32(3, run_bulk(1000, 100, 100));
+    TEST_ASSERT_EQUAL_UINT32(10, ses.data_sent);
+    TEST_ASSERT_EQUAL_UINT32(0, ses.retransmits);
+
+    setUp();
+    Session_Init(&ses, &dev_ops, 1, 50);
+    TEST_ASSERT_EQUAL_UINT32(10, run_bulk(1000, 100, 100));
+}
+
+void test_Bulk_Should_Go_Back_N_After_Loss(void)
+{
+    host.drop_data_seq = 2;
+    run_bulk(1000, 100, 100);
+
+    TEST_ASSERT_TRUE(host.dropped);
+    TEST_ASSERT_TRUE(ses.retransmits > 0);
+    TEST_ASSERT_EQUAL_UINT32(10 + ses.retransmits, ses.data_sent);
+}
+
+void test_Bulk_Should_Reject_Second_Start_And_Ignore_Stale_Acks(void)
+{
+    TEST_ASSERT_TRUE(Session_BulkStart(&ses, 300, 100, now_ms));
+    TEST_ASSERT_FALSE(Session_BulkStart(&ses, 100, 100, now_ms));
+
+    Session_Poll(&ses, now_ms);
+    Session_OnAck(&ses, 200, now_ms);  // 不在 (base, next] 範圍內
+    Session_OnAck(&ses, 0, now_ms);
+    TEST_ASSERT_TRUE(Session_BulkBusy(&ses));
+
+    Session_OnAck(&ses, 3, now_ms);
+    TEST_ASSERT_FALSE(Session_BulkBusy(&ses));
+
+    // 下一次 bulk 的 seq 延續上一次
+    host.data_expected = 3;
+    host.bulk_len = 0;
+    TEST_ASSERT_TRUE(Session_BulkStart(&ses, 50, 100, now_ms));
+    Session_Poll(&ses, now_ms);
+    TEST_ASSERT_EQUAL_UINT8(3, last_frame()->seq);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_Requests_Should_Pipeline_And_Respond_In_Order);
+    RUN_TEST(test_Retransmitted_Request_Should_Not_Execute_Twice);
+    RUN_TEST(test_Gap_Should_Ask_Host_To_Go_Back);
+    RUN_TEST(test_Request_Seq_Should_Wrap_Around);
+    RUN_TEST(test_Bulk_Window_Should_Cut_Round_Trips);
+    RUN_TEST(test_Bulk_Should_Go_Back_N_After_Loss);
+    RUN_TEST(test_Bulk_Should_Reject_Second_Start_And_Ignore_Stale_Acks);
+    return UNITY_END();
+}
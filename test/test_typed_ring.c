@@ -0,0 +1,103 @@
+// 檔案位置: test/test_typed_ring.c
+
+// typed_ring.h 放在最前面：確認 header 自給自足 (不依賴呼叫端先 include 系統 header)
+#include "typed_ring.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "unity.h"
+
+typedef struct
+{
+    uint32_t timestamp;
+    int16_t x;
+    int16_t y;
+} sample_t;
+
+RING_DEFINE(sample_ring, sample_t, 4)
+RING_DEFINE(tick_ring, uint32_t, 8)
+
+static sample_ring_t samples;
+static tick_ring_t ticks;
+
+void setUp(void)
+{
+    sample_ring_init(&samples);
+    tick_ring_init(&ticks);
+}
+
+void tearDown(void) {}
+
+// --- 測試案例 1: struct 元素整筆存取 ---
+void test_TypedRing_Struct_Should_RoundTrip(void)
+{
+    sample_t in = {.timestamp = 1234, .x = -5, .y = 7};
+    TEST_ASSERT_TRUE(sample_ring_push(&samples, in));
+
+    sample_t out;
+    TEST_ASSERT_TRUE(sample_ring_pop(&samples, &out));
+    TEST_ASSERT_EQUAL_UINT32(1234, out.timestamp);
+    TEST_ASSERT_EQUAL_INT16(-5, out.x);
+    TEST_ASSERT_EQUAL_INT16(7, out.y);
+    TEST_ASSERT_FALSE(sample_ring_pop(&samples, &out));
+}
+
+// --- 測試案例 2: 所有 slot 都能使用 (不浪費一格) ---
+void test_TypedRing_Full_Should_UseEveryElement(void)
+{
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        TEST_ASSERT_TRUE(tick_ring_push(&ticks, i));
+    }
+    TEST_ASSERT_TRUE(tick_ring_is_full(&ticks));
+    TEST_ASSERT_FALSE(tick_ring_push(&ticks, 99));
+    TEST_ASSERT_EQUAL_UINT32(8, tick_ring_count(&ticks));
+}
+
+// --- 測試案例 3: free-running index 跨越 UINT32_MAX 仍正確 ---
+void test_TypedRing_IndexOverflow_Should_Work(void)
+{
+    ticks.head = UINT32_MAX - 1;
+    ticks.tail = UINT32_MAX - 1;
+
+    for (uint32_t i = 0; i < 5; i++)
+    {
+        TEST_ASSERT_TRUE(tick_ring_push(&ticks, 100 + i));
+    }
+    TEST_ASSERT_EQUAL_UINT32(5, tick_ring_count(&ticks));
+
+    uint32_t v;
+    for (uint32_t i = 0; i < 5; i++)
+    {
+        TEST_ASSERT_TRUE(tick_ring_pop(&ticks, &v));
+        TEST_ASSERT_EQUAL_UINT32(100 + i, v);
+    }
+    TEST_ASSERT_TRUE(tick_ring_is_empty(&ticks));
+}
+
+// --- 測試案例 4: Zero-copy peek/drop ---
+void test_TypedRing_PeekDrop_Should_ExposeOldestInPlace(void)
+{
+    TEST_ASSERT_NULL(sample_ring_peek(&samples));
+
+    sample_ring_push(&samples, (sample_t){.timestamp = 1});
+    sample_ring_push(&samples, (sample_t){.timestamp = 2});
+
+    sample_t* s = sample_ring_peek(&samples);
+    TEST_ASSERT_EQUAL_PTR(&samples.items[0], s);
+    TEST_ASSERT_EQUAL_UINT32(1, s->timestamp);
+    sample_ring_drop(&samples);
+
+    TEST_ASSERT_EQUAL_UINT32(2, sample_ring_peek(&samples)->timestamp);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_TypedRing_Struct_Should_RoundTrip);
+    RUN_TEST(test_TypedRing_Full_Should_UseEveryElement);
+    RUN_TEST(test_TypedRing_IndexOverflow_Should_Work);
+    RUN_TEST(test_TypedRing_PeekDrop_Should_ExposeOldestInPlace);
+    return UNITY_END();
+}
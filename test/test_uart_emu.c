@@ -0,0 +1,452 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "emu.h"
+#include "hal_uart.h"
+#include "hal_uart_dma.h"
+#include "pico/stdlib.h"
+#include "unity.h"
+
+// 真正的 hal_uart.c / hal_uart_dma.c (非 TEST_MODE) 連結到 test/emu 的週邊模擬器：
+// 驗證吞吐量、overrun 門檻與中斷延遲，而不是 mock 的呼叫順序
+
+// ==========================================
+// 1. 共用工具
+// ==========================================
+#define DMA_PORT 0  // hal_uart_dma
+#define IRQ_PORT 1  // hal_uart (中斷 / Ping-Pong DMA)
+
+#define BAUD_3M 3000000u
+#define CAP_MAX (128u * 1024u)
+
+// 應用層 Callback 的 CPU 成本 (例如 evq_push_span + 喚醒主迴圈)，在 ISR 內申報給模擬器
+#define APP_CALLBACK_CYCLES 400u
+
+typedef struct
+{
+    uint8_t data[CAP_MAX];
+    size_t len;
+    uint32_t calls;
+    uint32_t last_us;  // 最後一次 Callback 的 time_us_32
+    uint32_t errors;
+} capture_t;
+
+static capture_t cap;
+static uint8_t src[CAP_MAX];
+static uart_handle_t h_uart;
+static uint8_t pingpong_buf[128];
+
+static void fill_pattern(size_t len)
+{
+    for (size_t i = 0; i < len; i++) src[i] = (uint8_t)(i * 7u + (i >> 8));
+}
+
+static void cap_append(const uint8_t* data, size_t len)
+{
+    if (cap.len + len > CAP_MAX) len = CAP_MAX - cap.len;
+    memcpy(cap.data + cap.len, data, len);
+    cap.len += len;
+    cap.calls++;
+    cap.last_us = time_us_32();
+}
+
+static void on_span(void* ctx, const uart_rx_span_t* span)
+{
+    (void)ctx;
+    cap_append(span->data, span->len);
+    emu_charge(APP_CALLBACK_CYCLES);
+}
+
+static void on_uart_event(void* ctx, uart_event_t event, void* data)
+{
+    (void)ctx;
+    if (event == UART_EVENT_RX_COMPLETE)
+    {
+        cap_append((const uint8_t*)data, 1);
+    }
+    else if (event == UART_EVENT_RX_SPAN)
+    {
+        const uart_rx_span_t* span = (const uart_rx_span_t*)data;
+        cap_append(span->data, span->len);
+    }
+    else if (event == UART_EVENT_ERROR)
+    {
+        cap.errors++;
+    }
+    emu_charge(APP_CALLBACK_CYCLES);
+}
+
+static uint64_t us_to_cycles(uint64_t us)
+{
+    return us * EMU_CYCLES_PER_US;
+}
+
+static double kib_per_s(size_t bytes, uint64_t cycles)
+{
+    return (double)bytes / 1024.0 / ((double)cycles / EMU_CLK_SYS_HZ);
+}
+
+static double line_kib_per_s(uint32_t port)
+{
+    return kib_per_s(1, emu_uart_char_cycles(port));
+}
+
+static double cpu_load_pct(uint64_t since)
+{
+    emu_cpu_stats_t cpu;
+    emu_get_cpu_stats(&cpu);
+    return 100.0 * (double)cpu.isr_cycles / (double)(emu_now() - since);
+}
+
+static void dma_init(uint32_t baud)
+{
+    uart_config_t cfg = HAL_UART_CONFIG_DEFAULT;
+    cfg.port = DMA_PORT;
+    cfg.baud = baud;
+    TEST_ASSERT_TRUE(hal_uart_dma_init(&cfg));
+}
+
+static void irq_init(uint32_t baud, uart_rx_mode_t mode, uint8_t* dma_buf, uint16_t dma_size)
+{
+    uart_config_t cfg = HAL_UART_CONFIG_DEFAULT;
+    cfg.port = IRQ_PORT;
+    cfg.tx_pin = 4;
+    cfg.rx_pin = 5;
+    cfg.baud = baud;
+    cfg.rx_mode = mode;
+    cfg.dma_rx_buf = dma_buf;
+    cfg.dma_rx_size = dma_size;
+    TEST_ASSERT_TRUE(HAL_UART_Init(&h_uart, &cfg));
+}
+
+// 以固定間隔輪詢 hal_uart_dma_read，直到收齊或線路送完後再過 1 ms
+static size_t dma_poll_read(size_t total, uint64_t end, uint32_t interval_us)
+{
+    size_t got = 0;
+    while (got < total && emu_now() < end + us_to_cycles(1000))
+    {
+        emu_run_us(interval_us);
+        got += hal_uart_dma_read(cap.data + got, CAP_MAX - got);
+    }
+    return got;
+}
+
+void setUp(void)
+{
+    // 驅動的 timer 狀態是 static：先讓它自己取消，再重設模擬器 (handler 表保留)
+    hal_uart_dma_set_idle_callback(NULL, NULL);
+    emu_reset(NULL);
+    memset(&cap, 0, sizeof(cap));
+}
+
+void tearDown(void) {}
+
+// ==========================================
+// 2. 模擬器本身
+// ==========================================
+void test_emu_uart_timing_should_follow_pl011_divisor(void)
+{
+    uart_inst_t* uart = uart_get_instance(0);
+    uint actual = uart_init(uart, 115200);
+    TEST_ASSERT_UINT32_WITHIN(115200 / 100, 115200, actual);
+    TEST_ASSERT_UINT64_WITHIN(1, 10ull * EMU_CLK_SYS_HZ / actual, emu_uart_char_cycles(0));
+
+    // 沒有人讀取：32 bytes 填滿 FIFO，其餘 8 bytes overrun
+    fill_pattern(40);
+    uint64_t start = emu_now();
+    uint64_t last = emu_uart_feed(0, src, 40);
+    TEST_ASSERT_UINT64_WITHIN(40, start + 40 * emu_uart_char_cycles(0), last);
+    emu_run_until(last);
+
+    emu_uart_stats_t st;
+    emu_uart_get_stats(0, &st);
+    TEST_ASSERT_EQUAL_UINT64(32, st.rx_bytes);
+    TEST_ASSERT_EQUAL_UINT64(8, st.rx_overrun);
+    TEST_ASSERT_EQUAL_UINT64(start + 32 * emu_uart_char_cycles(0), st.rx_last_cycle);
+    TEST_ASSERT_TRUE(uart_get_hw(uart)->ris & UART_UARTIMSC_OEIM_BITS);
+
+    // RX timeout：FIFO 非空且 32 個 bit time 沒有新字元
+    TEST_ASSERT_FALSE(uart_get_hw(uart)->ris & UART_UARTIMSC_RTIM_BITS);
+    emu_run_until(last + emu_uart_char_cycles(0) * 32 / 10 + 1);
+    TEST_ASSERT_TRUE(uart_get_hw(uart)->ris & UART_UARTIMSC_RTIM_BITS);
+
+    TEST_ASSERT_TRUE(uart_is_readable(uart));
+    TEST_ASSERT_EQUAL_HEX32(src[0], uart_get_hw(uart)->dr);
+}
+
+// ==========================================
+// 3. hal_uart_dma：3 Mbaud 吞吐量與輪詢門檻
+// ==========================================
+void test_dma_rx_should_sustain_3mbaud_line_rate(void)
+{
+    dma_init(BAUD_3M);
+
+    // 超過一個 UART_DMA_RX_REARM_BLOCK (64 KiB)，順便驗證 control channel 重新裝填
+    const size_t total = 100000;
+    fill_pattern(total);
+    uint64_t start = emu_now();
+    uint64_t end = emu_uart_feed(DMA_PORT, src, total);
+
+    size_t got = dma_poll_read(total, end, 200);
+
+    emu_uart_stats_t st;
+    emu_uart_get_stats(DMA_PORT, &st);
+    double rate = kib_per_s(total, st.rx_last_cycle - start);
+    printf("dma rx @3M: %.1f KiB/s (line %.1f), fifo max %u, CPU %.2f%%\n", rate,
+           line_kib_per_s(DMA_PORT), (unsigned)st.rx_fifo_max, cpu_load_pct(start));
+
+    TEST_ASSERT_EQUAL_size_t(total, got);
+    TEST_ASSERT_EQUAL_MEMORY(src, cap.data, total);
+    TEST_ASSERT_EQUAL_UINT32(0, hal_uart_dma_rx_lost());
+    TEST_ASSERT_EQUAL_UINT64(0, st.rx_overrun);
+    TEST_ASSERT_TRUE(rate >= 0.99 * line_kib_per_s(DMA_PORT));
+}
+
+void test_dma_rx_poll_interval_should_stay_below_ring_fill_time(void)
+{
+    static const uint32_t intervals_us[] = {200, 400, 800, 1000, 2000};
+    const size_t total = 20000;
+    fill_pattern(total);
+
+    for (size_t i = 0; i < sizeof(intervals_us) / sizeof(intervals_us[0]); i++)
+    {
+        setUp();
+        dma_init(BAUD_3M);
+        uint64_t end = emu_uart_feed(DMA_PORT, src, total);
+        dma_poll_read(total, end, intervals_us[i]);
+
+        // ring 填滿的時間：256 bytes @ 3 Mbaud ≈ 853 us
+        uint64_t fill_us =
+            UART_DMA_BUFFER_SIZE * emu_uart_char_cycles(DMA_PORT) / EMU_CYCLES_PER_US;
+        uint32_t lost = hal_uart_dma_rx_lost();
+        printf("dma rx @3M poll %4u us (ring fill %u us): lost %u\n", (unsigned)intervals_us[i],
+               (unsigned)fill_us, (unsigned)lost);
+
+        if (intervals_us[i] < fill_us)
+        {
+            TEST_ASSERT_EQUAL_UINT32(0, lost);
+        }
+        else
+        {
+            TEST_ASSERT_TRUE(lost > 0);
+        }
+    }
+}
+
+void test_dma_span_callback_should_report_burst_within_two_ticks(void)
+{
+    dma_init(BAUD_3M);
+    hal_uart_dma_set_span_callback(on_span, NULL);
+
+    // 短訊息：idle 判定需要一個完全沒有新資料的 tick
+    fill_pattern(20);
+    uint64_t last = emu_uart_feed(DMA_PORT, src, 20);
+    emu_run_until(last + us_to_cycles(3 * UART_DMA_IDLE_TICK_US));
+
+    uint32_t latency_us = cap.last_us - (uint32_t)(last / EMU_CYCLES_PER_US);
+    printf("dma idle span latency: %u us (tick %u us)\n", (unsigned)latency_us,
+           (unsigned)hal_uart_dma_idle_tick_us());
+    TEST_ASSERT_EQUAL_size_t(20, cap.len);
+    TEST_ASSERT_TRUE(latency_us <= 2 * hal_uart_dma_idle_tick_us());
+
+    // 長 burst 且主程式完全不讀：timer 在 ring 半滿時先交出資料，不會 overrun
+    const size_t total = 50000;
+    fill_pattern(total);
+    cap.len = 0;
+    last = emu_uart_feed(DMA_PORT, src, total);
+    emu_run_until(last + us_to_cycles(3 * UART_DMA_IDLE_TICK_US));
+
+    TEST_ASSERT_EQUAL_size_t(total, cap.len);
+    TEST_ASSERT_EQUAL_MEMORY(src, cap.data, total);
+    TEST_ASSERT_EQUAL_UINT32(0, hal_uart_dma_rx_lost());
+}
+
+void test_dma_span_callback_should_keep_up_at_top_baud(void)
+{
+    dma_init(UART_DMA_BAUD_MAX);
+    hal_uart_dma_set_span_callback(on_span, NULL);
+
+    // 主程式完全不讀，只靠 span Callback：tick 隨 baud 縮短，每個 tick 最多 UART_DMA_TICK_BYTES
+    const size_t total = 100000;
+    fill_pattern(total);
+    uint64_t start = emu_now();
+    uint64_t last = emu_uart_feed(DMA_PORT, src, total);
+    emu_run_until(last + us_to_cycles(3 * UART_DMA_IDLE_TICK_US));
+
+    emu_uart_stats_t st;
+    emu_uart_get_stats(DMA_PORT, &st);
+    printf("dma span @%u: tick %u us, %u callbacks, CPU %.2f%%, lost %u\n",
+           (unsigned)UART_DMA_BAUD_MAX, (unsigned)hal_uart_dma_idle_tick_us(),
+           (unsigned)cap.calls, cpu_load_pct(start), (unsigned)hal_uart_dma_rx_lost());
+
+    TEST_ASSERT_EQUAL_UINT32(0, hal_uart_dma_rx_lost());
+    TEST_ASSERT_EQUAL_UINT64(0, st.rx_overrun);
+    TEST_ASSERT_EQUAL_size_t(total, cap.len);
+    TEST_ASSERT_EQUAL_MEMORY(src, cap.data, total);
+}
+
+void test_dma_tx_should_stream_at_line_rate(void)
+{
+    dma_init(BAUD_3M);
+
+    const size_t total = 8192;
+    fill_pattern(total);
+    uint64_t start = emu_now();
+    size_t sent = 0;
+    while (sent < total)
+    {
+        size_t chunk = (total - sent < 256) ? total - sent : 256;
+        if (hal_uart_dma_send(src + sent, chunk) == HAL_UART_DMA_TX_QUEUED)
+        {
+            sent += chunk;
+        }
+        else
+        {
+            emu_run_us(50);  // 佇列滿：主程式做別的事
+        }
+    }
+    while (!hal_uart_dma_tx_idle()) emu_run_us(10);
+
+    emu_uart_stats_t st;
+    emu_uart_get_stats(DMA_PORT, &st);
+    uint64_t ideal = total * emu_uart_char_cycles(DMA_PORT);
+    printf("dma tx @3M: %.1f KiB/s (line %.1f), CPU %.2f%%\n",
+           kib_per_s(total, st.tx_last_cycle - start), line_kib_per_s(DMA_PORT),
+           cpu_load_pct(start));
+
+    TEST_ASSERT_EQUAL_size_t(total, emu_uart_read_tx(DMA_PORT, cap.data, CAP_MAX));
+    TEST_ASSERT_EQUAL_MEMORY(src, cap.data, total);
+    TEST_ASSERT_TRUE((st.tx_last_cycle - start) * 100 <= ideal * 101);
+}
+
+// ==========================================
+// 4. hal_uart：中斷接收模式的 CPU 成本
+// ==========================================
+typedef struct
+{
+    size_t received;
+    uint32_t overrun;
+    uint32_t irqs;
+    double cpu_pct;
+} irq_run_t;
+
+static irq_run_t run_irq_mode(uint32_t baud, uart_rx_mode_t mode, size_t total)
+{
+    setUp();
+    irq_init(baud, mode, NULL, 0);
+    HAL_UART_RegisterCallback(&h_uart, on_uart_event, NULL);
+
+    fill_pattern(total);
+    uint64_t start = emu_now();
+    uint64_t end = emu_uart_feed(IRQ_PORT, src, total);
+    emu_run_until(end + us_to_cycles(100));
+
+    uart_error_stats_t err;
+    HAL_UART_GetErrorStats(&h_uart, &err, true);
+    irq_run_t r = {.received = cap.len,
+                   .overrun = err.overrun,
+                   .irqs = h_uart.rx_irq_count,
+                   .cpu_pct = cpu_load_pct(start)};
+    printf("hal_uart %s @%u: received %u / %u, overrun %u, irqs %u, CPU %.1f%%\n",
+           (mode == UART_RX_MODE_FIFO) ? "FIFO" : "BYTE", (unsigned)baud, (unsigned)r.received,
+           (unsigned)total, (unsigned)r.overrun, (unsigned)r.irqs, r.cpu_pct);
+    return r;
+}
+
+void test_hal_uart_fifo_mode_should_keep_up_where_byte_mode_overruns(void)
+{
+    const size_t total = 4096;
+
+    // 921600：逐 byte 中斷仍來得及，但 CPU 負載明顯較高
+    irq_run_t byte_slow = run_irq_mode(921600, UART_RX_MODE_BYTE, total);
+    irq_run_t fifo_slow = run_irq_mode(921600, UART_RX_MODE_FIFO, total);
+    TEST_ASSERT_EQUAL_size_t(total, byte_slow.received);
+    TEST_ASSERT_EQUAL_size_t(total, fifo_slow.received);
+    TEST_ASSERT_EQUAL_MEMORY(src, cap.data, total);
+    TEST_ASSERT_TRUE(fifo_slow.cpu_pct * 4 < byte_slow.cpu_pct);
+
+    // 3 Mbaud：字元間隔 500 cycles < 每 byte 的 ISR 成本 → BYTE 模式 overrun，FIFO 模式收齊
+    irq_run_t byte_fast = run_irq_mode(BAUD_3M, UART_RX_MODE_BYTE, total);
+    TEST_ASSERT_TRUE(byte_fast.overrun > 0);
+    TEST_ASSERT_TRUE(byte_fast.received < total);
+
+    irq_run_t fifo_fast = run_irq_mode(BAUD_3M, UART_RX_MODE_FIFO, total);
+    TEST_ASSERT_EQUAL_UINT32(0, fifo_fast.overrun);
+    TEST_ASSERT_EQUAL_size_t(total, fifo_fast.received);
+    TEST_ASSERT_EQUAL_MEMORY(src, cap.data, total);
+    TEST_ASSERT_TRUE(fifo_fast.irqs * 8 < total);
+}
+
+void test_hal_uart_pingpong_dma_should_deliver_full_halves(void)
+{
+    irq_init(BAUD_3M, UART_RX_MODE_BYTE, pingpong_buf, sizeof(pingpong_buf));
+    HAL_UART_RegisterSpanCallback(&h_uart, on_span, NULL);
+
+    const size_t total = 10 * (sizeof(pingpong_buf) / 2);
+    fill_pattern(total);
+    uint64_t start = emu_now();
+    uint64_t end = emu_uart_feed(IRQ_PORT, src, total);
+    emu_run_until(end + us_to_cycles(10));
+
+    emu_cpu_stats_t cpu;
+    emu_get_cpu_stats(&cpu);
+    printf("hal_uart ping-pong @3M: %u spans, %u ISRs, CPU %.2f%%\n", (unsigned)cap.calls,
+           (unsigned)cpu.isr_count, cpu_load_pct(start));
+
+    TEST_ASSERT_EQUAL_UINT32(10, cap.calls);
+    TEST_ASSERT_EQUAL_size_t(total, cap.len);
+    TEST_ASSERT_EQUAL_MEMORY(src, cap.data, total);
+    TEST_ASSERT_EQUAL_UINT64(10, cpu.isr_count);  // 每半個緩衝區一次 DMA 中斷
+}
+
+// ==========================================
+// 5. 線路錯誤
+// ==========================================
+void test_wire_errors_should_reach_both_drivers(void)
+{
+    // hal_uart：注入的 FE 與 baud 不符的字元都被丟棄並計數
+    irq_init(921600, UART_RX_MODE_FIFO, NULL, 0);
+    HAL_UART_RegisterCallback(&h_uart, on_uart_event, NULL);
+
+    fill_pattern(10);
+    emu_uart_feed(IRQ_PORT, src, 5);
+    emu_uart_inject_error(IRQ_PORT, UART_ERR_FRAMING);
+    emu_uart_feed(IRQ_PORT, src + 5, 5);
+    emu_run_us(500);
+
+    emu_uart_set_peer_baud(IRQ_PORT, 460800);
+    emu_run_until(emu_uart_feed(IRQ_PORT, src, 4) + us_to_cycles(500));
+
+    uart_error_stats_t err;
+    HAL_UART_GetErrorStats(&h_uart, &err, false);
+    TEST_ASSERT_EQUAL_UINT32(5, err.framing);
+    TEST_ASSERT_EQUAL_UINT32(5, cap.errors);
+    TEST_ASSERT_EQUAL_size_t(9, cap.len);
+    TEST_ASSERT_EQUAL_MEMORY(src, cap.data, 5);
+    TEST_ASSERT_EQUAL_MEMORY(src + 6, cap.data + 5, 4);
+
+    // hal_uart_dma：資料由 DMA 搬走，錯誤只能由 UART 錯誤中斷計數
+    dma_init(BAUD_3M);
+    emu_uart_inject_error(DMA_PORT, UART_ERR_PARITY);
+    emu_run_until(emu_uart_feed(DMA_PORT, src, 10) + us_to_cycles(10));
+
+    hal_uart_dma_get_error_stats(&err, false);
+    TEST_ASSERT_EQUAL_UINT32(1, err.parity);
+    TEST_ASSERT_EQUAL_UINT32(0, err.framing);
+    TEST_ASSERT_EQUAL_size_t(10, hal_uart_dma_read(cap.data, CAP_MAX));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_emu_uart_timing_should_follow_pl011_divisor);
+    RUN_TEST(test_dma_rx_should_sustain_3mbaud_line_rate);
+    RUN_TEST(test_dma_rx_poll_interval_should_stay_below_ring_fill_time);
+    RUN_TEST(test_dma_span_callback_should_report_burst_within_two_ticks);
+    RUN_TEST(test_dma_span_callback_should_keep_up_at_top_baud);
+    RUN_TEST(test_dma_tx_should_stream_at_line_rate);
+    RUN_TEST(test_hal_uart_fifo_mode_should_keep_up_where_byte_mode_overruns);
+    RUN_TEST(test_hal_uart_pingpong_dma_should_deliver_full_halves);
+    RUN_TEST(test_wire_errors_should_reach_both_drivers);
+    return UNITY_END();
+}